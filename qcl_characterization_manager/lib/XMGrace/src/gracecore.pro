@@ -0,0 +1,17 @@
+# Target ../bin/gracecore (static library)
+# Headless QtGrace core for in-process rendering through gracerender.h.
+# Reuses the qtgrace source list; the application's main() is renamed so the
+# library can be linked into another executable. The drawing core still
+# references the Qt widget layer (allWidgets, MainWindow), so Qt widgets,
+# network and svg remain link dependencies of the library.
+include(src.pro)
+
+TEMPLATE = lib
+CONFIG += staticlib
+TARGET = ../bin/gracecore
+DEFINES += main=qtgrace_main
+RC_FILE =
+ICON =
+
+HEADERS += gracerender.h
+SOURCES += gracerender.cpp
@@ -0,0 +1,115 @@
+/*
+ * gracerender.cpp - headless in-process rendering entry points of the
+ * gracecore static library.
+ *
+ * The initialisation mirrors the non-GUI part of replacement_main() (the
+ * gracebat path): program defaults, parser, T1lib fonts, colormap and the
+ * file drivers, with the dummy driver as terminal device. No widgets are
+ * created and no screen driver is registered, so the file drivers can be
+ * driven from a worker thread.
+ */
+
+#include <clocale>
+#include <cstring>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+
+#include "defines.h"
+#include "globals.h"
+#include "utils.h"
+#include "files.h"
+#include "graphs.h"
+#include "device.h"
+#include "devlist.h"
+#include "draw.h"
+#include "parser.h"
+#include "t1fonts.h"
+#include "noxprotos.h"
+#include "gracerender.h"
+
+static QMutex render_mutex;
+static bool render_initialized = false;
+
+bool grace_render_init(const char *share_dir)
+{
+    QMutexLocker locker(&render_mutex);
+    if (render_initialized) {
+        return true;
+    }
+
+    strncpy(qt_grace_share_dir, share_dir, GR_MAXPATHLEN - 1);
+    qt_grace_share_dir[GR_MAXPATHLEN - 1] = '\0';
+
+    reset_project_version();
+    set_grace_home(qt_grace_share_dir);
+    init_username();
+    init_userhome();
+    set_ptofile(TRUE);
+
+    set_program_defaults();
+    initialize_nonl();
+    init_symtab();
+
+    if (init_t1() != RETURN_SUCCESS) {
+        errmsg("gracerender: unable to initialize T1lib");
+        return false;
+    }
+    initialize_cmap();
+
+    /* no screen: hardcopy drivers only */
+    select_device(register_dummy_drv());
+    register_ps_drv();
+    register_eps_drv();
+    register_pdf_drv();
+    register_svg_drv();
+    register_pnm_drv();
+
+    set_locale_num(FALSE);
+    setlocale(LC_NUMERIC, "C");
+
+    if (new_project(NULL) != RETURN_SUCCESS) {
+        errmsg("gracerender: unable to load the default project");
+        return false;
+    }
+
+    render_initialized = true;
+    return true;
+}
+
+bool grace_render_agr(const char *agr_data, size_t length, const char *out_file, const char *device_name)
+{
+    QMutexLocker locker(&render_mutex);
+    if (!render_initialized) {
+        return false;
+    }
+
+    int dev_nr = get_device_by_name(device_name);
+    if (dev_nr < 0) {
+        return false;
+    }
+
+    /* The project loader and its parser only read files: spill the buffer
+     * to a private temporary file that is removed on return. */
+    QTemporaryFile agr_file(QDir::tempPath() + "/gracerender_XXXXXX.agr");
+    if (!agr_file.open() || agr_file.write(agr_data, (qint64) length) != (qint64) length) {
+        return false;
+    }
+    agr_file.close();
+
+    QByteArray agr_path = QFile::encodeName(agr_file.fileName());
+    if (load_project(agr_path.data()) != RETURN_SUCCESS) {
+        return false;
+    }
+
+    QByteArray target = QFile::encodeName(QString::fromLocal8Bit(out_file));
+    QFile::remove(QString::fromLocal8Bit(out_file));
+
+    Page_geometry pg = get_page_geometry();
+    do_hardcopy_external(target.data(), dev_nr, pg.dpi, pg.width, pg.height);
+
+    return QFile::exists(QString::fromLocal8Bit(out_file));
+}
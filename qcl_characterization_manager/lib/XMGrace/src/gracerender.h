@@ -0,0 +1,26 @@
+/*
+ * gracerender.h - headless in-process rendering entry points of the
+ * gracecore static library (see gracecore.pro).
+ *
+ * Added for the QCL Characterization Manager so that .agr figures can be
+ * hardcopied without spawning qtgrace. The Grace core keeps its whole state
+ * in globals, therefore every call below is serialised by one mutex: the
+ * functions may be called from any thread, but only one renders at a time.
+ */
+
+#ifndef GRACERENDER_H
+#define GRACERENDER_H
+
+#include <cstddef>
+
+/* Initialise the Grace core once (fonts, colormap, hardcopy drivers, default
+ * project). share_dir is the QtGrace installation directory containing
+ * gracerc, fonts/ and templates/. Safe to call repeatedly. */
+bool grace_render_init(const char *share_dir);
+
+/* Load an .agr project from memory and hardcopy it to out_file using the
+ * named Grace device ("PostScript", "EPS", "PDF", "PNG", "SVG", ...), at the
+ * page geometry stored in the project. Returns false on any failure. */
+bool grace_render_agr(const char *agr_data, size_t length, const char *out_file, const char *device_name);
+
+#endif /* GRACERENDER_H */
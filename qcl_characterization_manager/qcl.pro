@@ -0,0 +1,21 @@
+# Builds the GUI together with the command-line tool:
+#   qmake qcl.pro && make
+# and runs the core's unit tests with 'make check'.
+# The GUI can still be built on its own from qcl_characterization_manager.pro.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    cli \
+    app \
+    tests
+
+core.file = src/core/qcl_core.pro
+
+cli.file = src/cli/qcl_cli.pro
+cli.depends = core
+
+app.file = qcl_characterization_manager.pro
+
+tests.file = tests/tests.pro
+tests.depends = core
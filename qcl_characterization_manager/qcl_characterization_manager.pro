@@ -1,6 +1,8 @@
-QT       += core gui printsupport opengl concurrent
+# Qt 6 only: the sources use Qt 6 APIs such as QMouseEvent::position(),
+# QStringView arithmetic and QLabel::pixmap() returning by value
+lessThan(QT_MAJOR_VERSION, 6): error("Qt 6 is required (found Qt $$QT_VERSION)")
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+QT       += core gui printsupport opengl concurrent widgets
 
 CONFIG += c++17
 
@@ -24,15 +26,26 @@ INCLUDEPATH += \
 RESOURCES += \
     src/resources/style/style.qss \
     src/resources/style/style.sass \
+    src/resources/templates/templates.qrc \
     src/resources/images/
 
 DEFINES += QCUSTOMPLOT_USE_OPENGL
 
+# Optional in-process Grace rendering instead of spawning qtgrace.exe:
+# build lib/XMGrace/src/gracecore.pro first, then run qmake with CONFIG+=grace_library
+grace_library {
+    QT += network svg
+    DEFINES += QCL_WITH_GRACE_LIBRARY
+    INCLUDEPATH += lib/XMGrace/src
+    LIBS += -L$$PWD/lib/XMGrace/bin -lgracecore
+}
+
 include(src/ui/components/components.pri)
 include(src/ui/dialogs/dialogs.pri)
 include(src/ui/pages/pages.pri)
 include(src/ui/wizardPages/wizardPages.pri)
 include(src/core/core.pri)
+include(src/resources/style/style.pri)
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
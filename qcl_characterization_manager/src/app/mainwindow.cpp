@@ -14,41 +14,99 @@
 /**
  * \brief Constructs the main window and initializes the stacked widget navigation.
  *
- * This sets up the central widget as a QStackedWidget containing the WelcomePage,
- * WizardStack, and ProcessCustomPage. It also establishes signal-slot connections
- * for navigation between these pages.
+ * This sets up the central widget as a QStackedWidget containing the WelcomePage
+ * and empty placeholders for the WizardStack and ProcessCustomPage, which are
+ * built the first time they are shown so the welcome page appears quickly. It also
+ * establishes signal-slot connections for navigation between these pages.
  *
  * \param parent The parent widget, passed to the QMainWindow base class.
  */
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , stackedWidget(new QStackedWidget())
 {
     ui->setupUi(this);
-    QStackedWidget *stackedWidget = new QStackedWidget();
     setCentralWidget(stackedWidget);
 
-    // define different things
-    WizardStack *wizard = new WizardStack();
+    // the wizard and process pages are placeholders until first shown
     WelcomePage *welcomePage = new WelcomePage();
-	ProcessCustomPage *processPage = new ProcessCustomPage("  Process Customised Grace & LaTex Files");
-
-    // add the different pages/stacks
     stackedWidget->addWidget(welcomePage);
-    stackedWidget->addWidget(wizard);
-    stackedWidget->addWidget(processPage);
+    stackedWidget->addWidget(new QWidget());
+    stackedWidget->addWidget(new QWidget());
 
     // connect welcome page click with entering correct pages
-    connect(welcomePage,
-            &WelcomePage::buttonClickedId,
-            stackedWidget,
-            &QStackedWidget::setCurrentIndex);
+    connect(welcomePage, &WelcomePage::buttonClickedId, this, &MainWindow::showPage);
+
+    // replaying a saved run opens the wizard at its Grace page
+    connect(welcomePage, &WelcomePage::dataMapSelected, this, [this](const QString &filePath) {
+        if (wizardPage()->loadDataMap(filePath))
+            stackedWidget->setCurrentWidget(wizard);
+    });
+
+    // opening a project shows its figures on the Grace page without parsing anything
+    connect(welcomePage, &WelcomePage::projectSelected, this, [this](const QString &filePath) {
+        if (wizardPage()->loadProject(filePath))
+            stackedWidget->setCurrentWidget(wizard);
+    });
+}
 
-    // connect wizard finished with return to welcome page
-    connect(wizard, &Wizard::finished, stackedWidget, &QStackedWidget::setCurrentIndex);
+/**
+ * \brief Shows a page of the stack, building it first if it is still a placeholder.
+ *
+ * \param index Stack position; positions past the last page are ignored.
+ */
+void MainWindow::showPage(int index)
+{
+    if (index == WizardIndex)
+        wizardPage();
+    else if (index == ProcessIndex)
+        processCustomPage();
+    stackedWidget->setCurrentIndex(index);
+}
+
+/**
+ * \brief Returns the wizard, building it on first use.
+ */
+WizardStack *MainWindow::wizardPage()
+{
+    if (!wizard) {
+        wizard = new WizardStack();
+        replacePlaceholder(WizardIndex, wizard);
 
-    // connect analysis page "Back" with return to welcome page
-	connect(processPage, &ProcessCustomPage::finished, stackedWidget, &QStackedWidget::setCurrentIndex);
+        // connect wizard finished with return to welcome page
+        connect(wizard, &Wizard::finished, stackedWidget, &QStackedWidget::setCurrentIndex);
+    }
+    return wizard;
+}
+
+/**
+ * \brief Returns the process page, building it on first use.
+ */
+ProcessCustomPage *MainWindow::processCustomPage()
+{
+    if (!processPage) {
+        processPage = new ProcessCustomPage("  Process Customised Grace & LaTex Files");
+        replacePlaceholder(ProcessIndex, processPage);
+
+        // connect analysis page "Back" with return to welcome page
+        connect(processPage, &ProcessCustomPage::finished, stackedWidget, &QStackedWidget::setCurrentIndex);
+    }
+    return processPage;
+}
+
+/**
+ * \brief Swaps the placeholder at a stack position for the built page.
+ *
+ * \param index Stack position of the page.
+ * \param page  The page; the stack takes ownership.
+ */
+void MainWindow::replacePlaceholder(int index, QWidget *page)
+{
+    QWidget *placeholder = stackedWidget->widget(index);
+    stackedWidget->insertWidget(index, page);
+    stackedWidget->removeWidget(placeholder);
+    delete placeholder;
 }
 
 /**
@@ -11,6 +11,10 @@
 	#define MAINWINDOW_H
 
 	#include <QMainWindow>
+	#include <QStackedWidget>
+
+	class ProcessCustomPage;
+	class WizardStack;
 
 	QT_BEGIN_NAMESPACE
 	namespace Ui 
@@ -22,6 +26,10 @@
 	/**
 	 * @class MainWindow
 	 * @brief Main window class for the application.
+	 *
+	 * Only the welcome page is built at startup. The wizard and the process
+	 * page, with their dropdowns, figures and file fields, are built the first
+	 * time they are shown.
 	 */
 	class MainWindow : public QMainWindow
 	{
@@ -32,6 +40,16 @@
 			~MainWindow();                                   ///< Destructor
 
 		private:
-			Ui::MainWindow *ui; ///< UI object pointer
+			enum PageIndex { WelcomeIndex, WizardIndex, ProcessIndex }; ///< Stack positions, as WelcomePage numbers them
+
+			void showPage(int index);               ///< Build the page if needed and show it
+			WizardStack *wizardPage();              ///< The wizard, built on first use
+			ProcessCustomPage *processCustomPage(); ///< The process page, built on first use
+			void replacePlaceholder(int index, QWidget *page); ///< Put a built page at its stack position
+
+			Ui::MainWindow *ui;                     ///< UI object pointer
+			QStackedWidget *stackedWidget;          ///< Welcome page, wizard and process page
+			WizardStack *wizard = nullptr;          ///< Wizard, null until first shown
+			ProcessCustomPage *processPage = nullptr; ///< Process page, null until first shown
 	};
 #endif // MAINWINDOW_H
\ No newline at end of file
@@ -0,0 +1,344 @@
+/**
+ * \file        main.cpp
+ * \brief       Entry point for qcl_cli, which runs the processing pipeline without a GUI.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include "core/pipeline/DataMapFile.h"
+#include "core/pipeline/ProcessingPipeline.h"
+#include "core/pipeline/WaferScheduler.h"
+
+/**
+ * @brief Settings of one run, from the input file and the command line.
+ */
+struct CliJob
+{
+    QVariantMap data;       ///< Collected data of the device
+    QString outputDir;      ///< Device output directory
+    QString stages;         ///< Comma separated stage names, empty for all
+    QString pdflatexPath;   ///< pdflatex override, empty for the default
+    QString formatCacheDir; ///< Shared precompiled preamble folder
+    QString analyticsDir;   ///< Columnar export folder, empty for none
+    int jobs = 0;           ///< Conversion pool size, 0 for one per core
+};
+
+static bool loadInput(const QString& inputPath, CliJob& job, QString& error);
+static bool loadConfig(const QString& configPath, CliJob& job, QString& error);
+static bool parseStages(const QString& names, ProcessingPipeline::Stages& stages);
+static int runWafer(QCoreApplication& app, const QStringList& deviceDirs, const CliJob& settings, int threads, bool resume);
+
+/**
+ * @brief The main entry point of the command-line tool.
+ *
+ * Usage: qcl_cli [options] <input>, where input is a <Sample>_DataMap.txt,
+ * a device folder containing one, or a JSON configuration:
+ *
+ *     {
+ *         "dataMap":   "Sample_DataMap.txt",  // optional, relative to the config
+ *         "data":      { ... },               // collected data, overrides the DataMap
+ *         "outputDir": "out",                 // default: folder of the DataMap or config
+ *         "stages":    "figures,convert,datasheet",
+ *         "pdflatex":  "/usr/bin/pdflatex",
+ *         "formatCache": "fmt",
+ *         "analytics": "Analytics",           // columnar export, see AnalyticsExporter
+ *         "jobs":      4
+ *     }
+ *
+ * "data" uses the wizard's keys; file maps are objects of path to value.
+ * Command-line options override the configuration. --analytics writes
+ * the traces and extracted parameters as .npy columns with a schema.json,
+ * for notebooks that memory-map them.
+ *
+ * A folder without a DataMap of its own whose subfolders hold one is
+ * processed as a wafer: every device goes through all stages on a
+ * WaferScheduler, and --jobs limits the external processes of all
+ * devices together. Each device records its finished stages in
+ * BatchManifest.json, so running the same command after a crash skips
+ * what is done and retries the rest; --restart ignores the manifests.
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return 0 on success, 1 if processing failed, 2 on invalid input
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("qcl_cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Processes QCL measurements into Grace figures and a datasheet.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "DataMap file, device folder or JSON configuration.");
+
+    QCommandLineOption outputOption({ "o", "output" }, "Output directory.", "dir");
+    QCommandLineOption stagesOption({ "s", "stages" }, "Stages to run: figures,convert,datasheet (default all).", "list");
+    QCommandLineOption pdflatexOption("pdflatex", "pdflatex executable.", "path");
+    QCommandLineOption jobsOption({ "j", "jobs" }, "Concurrent external processes (default one per core).", "count");
+    QCommandLineOption threadsOption("threads", "Threads parsing and plotting a wafer (default one per core).", "count");
+    QCommandLineOption formatCacheOption("format-cache", "Folder to share the precompiled preamble in.", "dir");
+    QCommandLineOption restartOption("restart", "Run every stage of a wafer again instead of resuming.");
+    QCommandLineOption analyticsOption("analytics", "Export traces and extracted parameters as .npy columns.", "dir");
+    parser.addOptions({ outputOption, stagesOption, pdflatexOption, jobsOption, threadsOption, formatCacheOption, restartOption,
+                        analyticsOption });
+    parser.process(a);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.positionalArguments().size() != 1) {
+        err << parser.helpText();
+        return 2;
+    }
+
+    CliJob job;
+    QString error;
+    const QString input = parser.positionalArguments().first();
+
+    if (QFileInfo(input).isDir() && DataMapFile::find(input).isEmpty()) {
+        QStringList deviceDirs = DataMapFile::findDeviceDirectories(input);
+        if (deviceDirs.isEmpty()) {
+            err << "No *_DataMap.txt in " << input << " or its subfolders" << Qt::endl;
+            return 2;
+        }
+        if (parser.isSet(outputOption) || parser.isSet(stagesOption))
+            err << "Wafer runs write into each device folder and run all stages" << Qt::endl;
+        if (parser.isSet(analyticsOption))
+            err << "--analytics exports single devices only; ignored for wafer runs" << Qt::endl;
+
+        job.pdflatexPath = parser.value(pdflatexOption);
+        job.formatCacheDir = parser.value(formatCacheOption);
+        job.jobs = parser.value(jobsOption).toInt();
+        return runWafer(a, deviceDirs, job, parser.value(threadsOption).toInt(), !parser.isSet(restartOption));
+    }
+
+    if (!loadInput(input, job, error)) {
+        err << error << Qt::endl;
+        return 2;
+    }
+
+    if (parser.isSet(outputOption)) job.outputDir = parser.value(outputOption);
+    if (parser.isSet(stagesOption)) job.stages = parser.value(stagesOption);
+    if (parser.isSet(pdflatexOption)) job.pdflatexPath = parser.value(pdflatexOption);
+    if (parser.isSet(formatCacheOption)) job.formatCacheDir = parser.value(formatCacheOption);
+    if (parser.isSet(jobsOption)) job.jobs = parser.value(jobsOption).toInt();
+    if (parser.isSet(analyticsOption)) job.analyticsDir = QDir().absoluteFilePath(parser.value(analyticsOption));
+
+    ProcessingPipeline::Stages stages = ProcessingPipeline::AllStages;
+    if (!job.stages.isEmpty() && !parseStages(job.stages, stages)) {
+        err << "Unknown stage in: " << job.stages << Qt::endl;
+        return 2;
+    }
+
+    if (job.outputDir.isEmpty() || !QDir().mkpath(job.outputDir)) {
+        err << "Cannot use output directory: " << job.outputDir << Qt::endl;
+        return 2;
+    }
+
+    ProcessingPipeline pipeline;
+    pipeline.setStages(stages);
+    pipeline.setMaxConcurrentJobs(job.jobs);
+    pipeline.setFormatCacheDir(job.formatCacheDir);
+    pipeline.setAnalyticsDir(job.analyticsDir);
+    if (!job.pdflatexPath.isEmpty())
+        pipeline.setPdflatexPath(job.pdflatexPath);
+
+    QObject::connect(&pipeline, &ProcessingPipeline::stageStarted, [&out](const QString& description) {
+        out << description << "..." << Qt::endl;
+    });
+    QObject::connect(&pipeline, &ProcessingPipeline::progressChanged, [&out](int completed, int total) {
+        out << "  " << completed << "/" << total << Qt::endl;
+    });
+    QObject::connect(&pipeline, &ProcessingPipeline::stageFinished, [&out](const QString& description, qint64 elapsedMs) {
+        out << description << " took " << elapsedMs << " ms" << Qt::endl;
+    });
+    QObject::connect(&pipeline, &ProcessingPipeline::finished, [&out, &err](bool success, const QString& message) {
+        if (success)
+            out << "Done: " << message << Qt::endl;
+        else
+            err << "Failed: " << message << Qt::endl;
+        QCoreApplication::exit(success ? 0 : 1);
+    });
+
+    pipeline.run(job.data, job.outputDir);
+    return a.exec();
+}
+
+/**
+ * @brief Processes every device of a wafer.
+ *
+ * Prints each finished device with the throughput and ETA, then the report
+ * of WaferScheduler::summary(), which is also saved as WaferReport.txt in
+ * the common parent folder.
+ *
+ * @param app        Application whose event loop drives the run.
+ * @param deviceDirs Device folders.
+ * @param settings   pdflatex, format cache and process limit (jobs).
+ * @param threads    Pool size, 0 for one per core.
+ * @param resume     Skip stages the device manifests record as done.
+ * @return 0 if every device succeeded, otherwise 1
+ */
+static int runWafer(QCoreApplication& app, const QStringList& deviceDirs, const CliJob& settings, int threads, bool resume)
+{
+    QTextStream out(stdout);
+
+    WaferScheduler scheduler(nullptr, threads);
+    if (settings.jobs > 0)
+        scheduler.setMaxProcesses(settings.jobs);
+    if (!settings.pdflatexPath.isEmpty())
+        scheduler.setPdflatexPath(settings.pdflatexPath);
+    scheduler.setFormatCacheDir(settings.formatCacheDir);
+    scheduler.setResume(resume);
+
+    out << "Processing " << deviceDirs.size() << " devices on " << scheduler.threadCount()
+        << " threads, at most " << scheduler.maxProcessCount() << " external processes" << Qt::endl;
+
+    QObject::connect(&scheduler, &WaferScheduler::deviceFinished, [&out, &scheduler](const QString& deviceDir, bool success, int completed, int total) {
+        qint64 etaMs = scheduler.etaMs();
+        out << "[" << completed << "/" << total << "] " << (success ? "OK     " : "FAILED ") << deviceDir
+            << "  (" << QString::number(scheduler.devicesPerMinute(), 'f', 1) << " devices/min, ETA "
+            << (etaMs < 0 ? QString("?") : QString::number(etaMs / 1000) + " s") << ")" << Qt::endl;
+    });
+    QObject::connect(&scheduler, &WaferScheduler::finished, [&app](int /*succeeded*/, int failed) {
+        app.exit(failed == 0 ? 0 : 1);
+    });
+
+    scheduler.run(deviceDirs);
+    int exitCode = app.exec();
+
+    QString report = scheduler.summary();
+    out << Qt::endl << report;
+
+    QFile reportFile(QDir(QFileInfo(deviceDirs.first()).absolutePath()).filePath("WaferReport.txt"));
+    if (reportFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        QTextStream(&reportFile) << report;
+
+    return exitCode;
+}
+
+/**
+ * @brief Reads the collected data from a DataMap, a device folder or a configuration.
+ *
+ * @param inputPath Positional argument.
+ * @param job       Receives the data and the default output directory.
+ * @param error     Receives the reason of a failure.
+ * @return true if the input could be read.
+ */
+static bool loadInput(const QString& inputPath, CliJob& job, QString& error)
+{
+    QFileInfo input(inputPath);
+
+    if (input.isDir()) {
+        QString dataMap = DataMapFile::find(input.absoluteFilePath());
+        if (dataMap.isEmpty()) {
+            error = "No *_DataMap.txt in " + inputPath;
+            return false;
+        }
+        input.setFile(dataMap);
+    }
+
+    if (!input.isFile()) {
+        error = "No such file: " + inputPath;
+        return false;
+    }
+
+    if (input.suffix().compare("json", Qt::CaseInsensitive) == 0)
+        return loadConfig(input.absoluteFilePath(), job, error);
+
+    job.data = DataMapFile::read(input.absoluteFilePath(), &error);
+    job.outputDir = input.absolutePath();
+    return !job.data.isEmpty();
+}
+
+/**
+ * @brief Reads a JSON configuration, see main().
+ */
+static bool loadConfig(const QString& configPath, CliJob& job, QString& error)
+{
+    QFile file(configPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "Cannot read " + configPath;
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        error = configPath + ": " + parseError.errorString();
+        return false;
+    }
+
+    QJsonObject config = document.object();
+    QDir configDir = QFileInfo(configPath).absoluteDir();
+    job.outputDir = configDir.absolutePath();
+
+    if (config.contains("dataMap")) {
+        QString dataMap = configDir.absoluteFilePath(config.value("dataMap").toString());
+        job.data = DataMapFile::read(dataMap, &error);
+        if (job.data.isEmpty())
+            return false;
+        job.outputDir = QFileInfo(dataMap).absolutePath();
+    }
+
+    const QVariantMap data = config.value("data").toObject().toVariantMap();
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+        job.data[it.key()] = it.value();
+
+    if (job.data.isEmpty()) {
+        error = configPath + ": neither \"dataMap\" nor \"data\" given";
+        return false;
+    }
+
+    if (config.contains("outputDir"))
+        job.outputDir = configDir.absoluteFilePath(config.value("outputDir").toString());
+
+    QJsonValue stages = config.value("stages");
+    if (stages.isArray()) {
+        QStringList names;
+        for (const QJsonValue& name : stages.toArray())
+            names << name.toString();
+        job.stages = names.join(',');
+    } else {
+        job.stages = stages.toString();
+    }
+
+    job.pdflatexPath = config.value("pdflatex").toString();
+    if (config.contains("formatCache"))
+        job.formatCacheDir = configDir.absoluteFilePath(config.value("formatCache").toString());
+    if (config.contains("analytics"))
+        job.analyticsDir = configDir.absoluteFilePath(config.value("analytics").toString());
+    job.jobs = config.value("jobs").toInt();
+    return true;
+}
+
+/**
+ * @brief Converts "figures,convert,datasheet" (any subset) to pipeline stages.
+ *
+ * @return false if a name is not known.
+ */
+static bool parseStages(const QString& names, ProcessingPipeline::Stages& stages)
+{
+    stages = {};
+    for (const QString& name : names.split(',', Qt::SkipEmptyParts)) {
+        QString stage = name.trimmed().toLower();
+        if (stage == "figures")
+            stages |= ProcessingPipeline::FigureStage;
+        else if (stage == "convert")
+            stages |= ProcessingPipeline::ConversionStage;
+        else if (stage == "datasheet")
+            stages |= ProcessingPipeline::DataSheetStage;
+        else if (stage == "all")
+            stages |= ProcessingPipeline::AllStages;
+        else
+            return false;
+    }
+    return stages != ProcessingPipeline::Stages();
+}
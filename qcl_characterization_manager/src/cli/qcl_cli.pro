@@ -0,0 +1,26 @@
+# Headless pipeline: qcl_cli <DataMap | device folder | config.json>
+lessThan(QT_MAJOR_VERSION, 6): error("Qt 6 is required (found Qt $$QT_VERSION)")
+
+TEMPLATE = app
+TARGET = qcl_cli
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT = core concurrent
+
+SOURCES += \
+    main.cpp
+
+INCLUDEPATH += \
+    $$PWD/..
+
+RESOURCES += \
+    $$PWD/../resources/templates/templates.qrc
+
+CORE_OUT = $$OUT_PWD/../core
+win32:CONFIG(debug, debug|release): CORE_OUT = $$CORE_OUT/debug
+else:win32: CORE_OUT = $$CORE_OUT/release
+
+LIBS += -L$$CORE_OUT -lqcl_core
+win32-msvc*: PRE_TARGETDEPS += $$CORE_OUT/qcl_core.lib
+else: PRE_TARGETDEPS += $$CORE_OUT/libqcl_core.a
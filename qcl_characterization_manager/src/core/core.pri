@@ -1,14 +1,11 @@
-SOURCES += \
-    $$PWD/livplot.cpp \
-    $$PWD/qcustomplot.cpp \
-    $$PWD/qcustomplotwrapper.cpp \
-    $$PWD/spectraplot.cpp	\
-    $$PWD/graceplot.cpp
-
-HEADERS += \
-    $$PWD/livplot.h \
-    $$PWD/qcustomplot.h \
-    $$PWD/qcustomplotwrapper.h \
-    $$PWD/spectraplot.h	\
-	$$PWD/graceplot.h
+# Everything below except qtplots only needs QtCore; see qcl_core.pro
+include(dataprocessing/dataprocessing.pri)
+include(graceplots/graceplots.pri)
+include(fileconversion/fileconversion.pri)
+include(datasheetgenerator/datasheetgenerator.pri)
+include(pipeline/pipeline.pri)
+include(project/project.pri)
 
+contains(QT, widgets) {
+    include(qtplots/qtplots.pri)
+}
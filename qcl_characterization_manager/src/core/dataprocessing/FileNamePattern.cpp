@@ -0,0 +1,78 @@
+/**
+ * \file        FileNamePattern.cpp
+ * \brief       Compiles file name patterns such as LIV_{T}K_*.dat and reads
+ *              the trace variable value from matching file names.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "FileNamePattern.h"
+#include <QFileInfo>
+
+/**
+ * \brief Compiles a pattern.
+ *
+ * An invalid pattern (no placeholder, more than one, or an unclosed brace)
+ * matches nothing; errorString() says why.
+ *
+ * \param pattern Pattern such as "FTIR_{I}mA.txt".
+ */
+FileNamePattern::FileNamePattern(const QString &pattern)
+{
+    QString expression = "^";
+    int placeholders = 0;
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        QChar c = pattern[i];
+        if (c == '{') {
+            int close = pattern.indexOf('}', i + 1);
+            if (close < 0) {
+                error = "Unclosed '{' in pattern";
+                return;
+            }
+            name = pattern.mid(i + 1, close - i - 1).trimmed();
+            // Not preceded by a digit or point, so a wildcard before it cannot
+            // take the leading digits; a plus sign is matched but not kept
+            expression += "(?<![\\d.])\\+?(-?\\d+(?:\\.\\d+)?)";
+            ++placeholders;
+            i = close;
+        } else if (c == '*') {
+            expression += ".*?";  // lazy: the first run of the pattern wins
+        } else if (c == '?') {
+            expression += ".";
+        } else {
+            expression += QRegularExpression::escape(QString(c));
+        }
+    }
+    expression += "$";
+
+    if (placeholders != 1) {
+        error = placeholders == 0 ? "Pattern has no {value} placeholder"
+                                  : "Pattern has more than one placeholder";
+        return;
+    }
+
+    regex.setPattern(expression);
+    regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    regex.optimize();
+}
+
+/**
+ * \brief Reads the placeholder value from a file name.
+ *
+ * \param fileName File name or path; only the name is matched.
+ * \param value    Receives the number as written in the name, e.g. "80".
+ * \return True if the name matches the pattern.
+ */
+bool FileNamePattern::match(const QString &fileName, QString *value) const
+{
+    if (!isValid())
+        return false;
+
+    QRegularExpressionMatch result = regex.match(QFileInfo(fileName).fileName());
+    if (!result.hasMatch())
+        return false;
+
+    if (value)
+        *value = result.captured(1);
+    return true;
+}
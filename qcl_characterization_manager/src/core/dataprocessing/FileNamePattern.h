@@ -0,0 +1,50 @@
+/**
+ * @file FileNamePattern.h
+ * @brief Declaration of FileNamePattern, trace variable values read from file names.
+ *
+ * Automated sweeps name each file after its temperature or current, e.g.
+ * LIV_80K_pulsed.dat; a pattern such as LIV_{T}K_*.dat reads the value back
+ * so hundreds of files need not be typed in by hand.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef FILENAMEPATTERN_H
+	#define FILENAMEPATTERN_H
+
+	#include <QRegularExpression>
+	#include <QString>
+
+	/**
+	 * @class FileNamePattern
+	 * @brief Wildcard file name pattern with one numeric placeholder.
+	 *
+	 * `{name}` matches a decimal number and is the value read, `*` any run
+	 * of characters and `?` any single character; everything else matches
+	 * literally, ignoring case. The placeholder name is only a label, so
+	 * `{T}`, `{I}` and `{value}` behave the same. The pattern is compiled to
+	 * one anchored regular expression on construction and matched against
+	 * file names without their folder.
+	 *
+	 * The number is always taken whole, and `*` matches as little as it can,
+	 * so `*_{T}K*` reads 80 from `LIV_80K_100K.dat` and `*{T}K.dat` reads
+	 * 180 from `LIV_180K.dat`.
+	 */
+	class FileNamePattern
+	{
+		public:
+			explicit FileNamePattern(const QString &pattern); ///< Compile a pattern
+
+			bool isValid() const { return error.isEmpty(); }        ///< Pattern has exactly one placeholder
+			const QString &errorString() const { return error; }  ///< Why the pattern is invalid
+			const QString &placeholder() const { return name; }    ///< Label of the placeholder, e.g. "T"
+
+			bool match(const QString &fileName, QString *value) const; ///< Read the value from a file name
+
+		private:
+			QString name;             ///< Placeholder label
+			QString error;            ///< Compile error, empty if valid
+			QRegularExpression regex; ///< Compiled pattern
+	};
+#endif // FILENAMEPATTERN_H
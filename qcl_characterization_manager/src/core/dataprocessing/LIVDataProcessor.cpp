@@ -7,8 +7,7 @@
  */
 
 #include "LIVDataProcessor.h"
-#include <QFile>
-#include <QTextStream>
+#include "MeasurementFileCache.h"
 #include <QDebug>
 #include <limits>
 #include <algorithm>
@@ -40,6 +39,58 @@ LIVDataProcessor::LIVDataProcessor(const QString &fileName,
     normalizeData();
 }
 
+/**
+ * \brief Constructs a LIVDataProcessor from traces that were already parsed and normalised.
+ *
+ * Used to reopen a saved project without its measurement files. The traces are
+ * taken as they are, so normalizeData() is not applied again; only the x and y1
+ * ranges are recomputed.
+ *
+ * \param fileName Name of the associated dataset (for reference).
+ * \param traceVariable The variable represented by the trace (e.g., "temperature").
+ * \param values Trace variable value of each trace, in ascending order.
+ * \param x Current of each trace.
+ * \param y1 Voltage of each trace.
+ * \param y2 Normalised optical power of each trace.
+ * \param preNormMaxY2 Highest optical power before normalisation.
+ * \param scaleFactor Factor the optical power was normalised to.
+ */
+LIVDataProcessor::LIVDataProcessor(const QString &fileName,
+                                   const QString &traceVariable,
+                                   const QList<QString> &values,
+                                   const QList<QVector<double>> &x,
+                                   const QList<QVector<double>> &y1,
+                                   const QList<QVector<double>> &y2,
+                                   double preNormMaxY2,
+                                   double scaleFactor)
+    : IDataProcessor(fileName, "mA", traceVariable),
+      xList(x),
+      y1List(y1),
+      y2List(y2),
+      valueList(values),
+      minX(std::numeric_limits<double>::max()),
+      maxX(std::numeric_limits<double>::lowest()),
+      minY1(std::numeric_limits<double>::max()),
+      maxY1(std::numeric_limits<double>::lowest()),
+      preNormMaxY2(preNormMaxY2),
+      scaleFactor(scaleFactor)
+{
+    for (const QVector<double> &trace : xList) {
+        if (trace.isEmpty())
+            continue;
+        auto [minXIt, maxXIt] = std::minmax_element(trace.begin(), trace.end());
+        minX = std::min(minX, *minXIt);
+        maxX = std::max(maxX, *maxXIt);
+    }
+    for (const QVector<double> &trace : y1List) {
+        if (trace.isEmpty())
+            continue;
+        auto [minY1It, maxY1It] = std::minmax_element(trace.begin(), trace.end());
+        minY1 = std::min(minY1, *minY1It);
+        maxY1 = std::max(maxY1, *maxY1It);
+    }
+}
+
 /**
  * \brief Parses and stores data from multiple LIV files.
  *
@@ -102,6 +153,8 @@ void LIVDataProcessor::generateVectors(const QVariantMap &files)
  * Each line of the file is expected to have three whitespace-separated columns:
  * current (x), electrical output (y1), and optical output (y2).
  * Points with x ≤ 0.005 are ignored. Data is sorted by current before being stored.
+ * The file is read through MeasurementFileCache, so a file already parsed by
+ * the wizard is not read again.
  *
  * \param fileName Path to the LIV file.
  * \param x Pointer to the vector that will store current values.
@@ -113,48 +166,10 @@ void LIVDataProcessor::generateVectorsFromFile(const QString &fileName,
                                                QVector<double> *y1,
                                                QVector<double> *y2)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Failed to open file for reading:" << fileName;
-        return;
-    }
-
-    QTextStream in(&file);
-    QStringList lines = in.readAll().split('\n', Qt::SkipEmptyParts);
-    file.close();
-
-    // Temporary container to hold points before sorting
-    QVector<std::tuple<double, double, double>> points;
-    points.reserve(lines.size());
-
-    for (const QString &line : lines) {
-        QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (fields.size() != 3)
-            continue;
-
-        double xVal = fields[0].toDouble();
-        double y1Val = fields[1].toDouble();
-        double y2Val = fields[2].toDouble();
-
-        if (xVal <= 0.005) continue;
-
-        points.emplace_back(xVal, y1Val, y2Val);
-    }
-
-    // Sort by xVal ascending
-    std::sort(points.begin(), points.end(), [](const auto &a, const auto &b) {
-        return std::get<0>(a) < std::get<0>(b);
-    });
-
-    x->reserve(points.size());
-    y1->reserve(points.size());
-    y2->reserve(points.size());
-
-    for (const auto &[xVal, y1Val, y2Val] : points) {
-        x->append(xVal);
-        y1->append(y1Val);
-        y2->append(y2Val);
-    }
+    MeasurementFile file = MeasurementFileCache::read(fileName, MeasurementFile::Kind::LIV);
+    *x = file.x;
+    *y1 = file.y1;
+    *y2 = file.y2;
 }
 
 
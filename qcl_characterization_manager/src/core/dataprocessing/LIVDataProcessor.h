@@ -24,6 +24,14 @@
 									  const QVariantMap &files,
 									  const QString &traceVariable,
 									  double scaleFactor = 100.0); ///< Constructor
+			explicit LIVDataProcessor(const QString &fileName,
+									  const QString &traceVariable,
+									  const QList<QString> &values,
+									  const QList<QVector<double>> &x,
+									  const QList<QVector<double>> &y1,
+									  const QList<QVector<double>> &y2,
+									  double preNormMaxY2,
+									  double scaleFactor); ///< Restore already normalised traces, e.g. from a project
 
 			void normalizeData() override; ///< Normalize the LIV data
 
@@ -0,0 +1,195 @@
+/**
+ * \file        MeasurementFileCache.cpp
+ * \brief       Parses L-I-V and FTIR measurement files and keeps the columns
+ *              so the wizard preview and the processors share one parse.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "MeasurementFileCache.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace
+{
+    /// Bound of the store [KiB]; a long FTIR scan takes about 2 MiB.
+    constexpr int maxCostKiB = 256 * 1024;
+}
+
+QMutex MeasurementFileCache::mutex;
+QCache<QString, MeasurementFileCache::Entry> MeasurementFileCache::entries(maxCostKiB);
+
+/**
+ * \brief Returns the parsed columns of a measurement file.
+ *
+ * Served from the store when the file is unchanged since it was parsed;
+ * otherwise the file is parsed and the result stored. Failed parses are
+ * stored too, so a broken file is not read again until it changes.
+ *
+ * \param fileName Path to the file.
+ * \param kind     Column layout of the file.
+ * \return The columns, or an empty result with error set.
+ */
+MeasurementFile MeasurementFileCache::read(const QString &fileName, MeasurementFile::Kind kind)
+{
+    QFileInfo info(fileName);
+    QString key = QString::number(int(kind)) + QLatin1Char(':') + info.absoluteFilePath();
+    qint64 size = info.size();
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    {
+        QMutexLocker locker(&mutex);
+        if (Entry *entry = entries.object(key); entry && entry->size == size && entry->modified == modified)
+            return entry->file;
+    }
+
+    MeasurementFile file = parse(fileName, kind);
+
+    qsizetype doubles = file.x.size() + file.y1.size() + file.y2.size();
+    int cost = int(qMax<qsizetype>(1, doubles * qsizetype(sizeof(double)) / 1024));
+    QMutexLocker locker(&mutex);
+    entries.insert(key, new Entry{size, modified, file}, cost);
+    return file;
+}
+
+/**
+ * \brief Checks that a file looks like a measurement file of the given kind.
+ *
+ * Reads only the first lines, so many files can be checked quickly before
+ * being imported; the full parse happens later through read(). A file
+ * passes if a data line with the expected column count and a numeric first
+ * column appears among its first 64 non-empty lines, so short text headers
+ * are allowed.
+ *
+ * \param fileName Path to the file.
+ * \param kind     Column layout of the file.
+ * \return Empty if the file looks valid, otherwise the reason.
+ */
+QString MeasurementFileCache::checkHeader(const QString &fileName, MeasurementFile::Kind kind)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return "Cannot open file: " + file.errorString();
+
+    static const QRegularExpression whitespace("\\s+");
+    int columns = kind == MeasurementFile::Kind::LIV ? 3 : 2;
+
+    QTextStream in(&file);
+    int lines = 0;
+    while (!in.atEnd() && lines < 64) {
+        QStringList fields = in.readLine().split(whitespace, Qt::SkipEmptyParts);
+        if (fields.isEmpty())
+            continue;
+        ++lines;
+
+        bool ok = false;
+        fields[0].toDouble(&ok);
+        if (ok && fields.size() == columns)
+            return QString();
+    }
+    return QString("No data line with %1 whitespace-separated columns").arg(columns);
+}
+
+/**
+ * \brief Drops every stored file.
+ */
+void MeasurementFileCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+}
+
+/**
+ * \brief Parses a measurement file.
+ *
+ * L-I-V files have three whitespace-separated columns: current, voltage and
+ * optical power; points are sorted by current. FTIR files have two columns,
+ * wavenumber [cm^-1] and intensity; wavenumbers are converted to THz and
+ * kept in file order. Points with x <= 0.005 are dropped and lines with any
+ * other column count are skipped.
+ *
+ * \param fileName Path to the file.
+ * \param kind     Column layout of the file.
+ * \return The columns, or an empty result with error set.
+ */
+MeasurementFile MeasurementFileCache::parse(const QString &fileName, MeasurementFile::Kind kind)
+{
+    MeasurementFile result;
+    bool isLIV = kind == MeasurementFile::Kind::LIV;
+
+    QFile file(fileName);
+    QIODevice::OpenMode mode = isLIV ? QIODevice::ReadOnly : QIODevice::ReadOnly | QIODevice::Text;
+    if (!file.open(mode)) {
+        qDebug() << "Cannot open file for reading:" << fileName;
+        result.error = "Cannot open file: " + file.errorString();
+        return result;
+    }
+
+    QTextStream in(&file);
+    QStringList lines = in.readAll().split('\n', Qt::SkipEmptyParts);
+    file.close();
+
+    static const QRegularExpression whitespace("\\s+");
+    int columns = isLIV ? 3 : 2;
+
+    // Temporary container to hold points before sorting
+    QVector<std::tuple<double, double, double>> points;
+    points.reserve(lines.size());
+
+    for (const QString &line : lines) {
+        QStringList fields = line.split(whitespace, Qt::SkipEmptyParts);
+        if (fields.size() != columns) {
+            if (!fields.isEmpty())
+                ++result.skippedLines;
+            continue;
+        }
+
+        double xVal = fields[0].toDouble();
+        double y1Val = fields[1].toDouble();
+        double y2Val = isLIV ? fields[2].toDouble() : 0.0;
+
+        // toDouble() accepts "nan" and "inf", which would poison every min/max downstream
+        if (!std::isfinite(xVal) || !std::isfinite(y1Val) || !std::isfinite(y2Val)) {
+            ++result.skippedLines;
+            continue;
+        }
+
+        if (!isLIV)
+            xVal *= 0.0299792458; // convert to THz
+
+        if (xVal <= 0.005) continue;
+
+        points.emplace_back(xVal, y1Val, y2Val);
+    }
+
+    if (points.isEmpty()) {
+        result.error = QString("No data points: expected %1 whitespace-separated columns").arg(columns);
+        return result;
+    }
+
+    if (isLIV) {
+        std::sort(points.begin(), points.end(), [](const auto &a, const auto &b) {
+            return std::get<0>(a) < std::get<0>(b);
+        });
+    }
+
+    result.x.reserve(points.size());
+    result.y1.reserve(points.size());
+    if (isLIV)
+        result.y2.reserve(points.size());
+
+    for (const auto &[xVal, y1Val, y2Val] : points) {
+        result.x.append(xVal);
+        result.y1.append(y1Val);
+        if (isLIV)
+            result.y2.append(y2Val);
+    }
+    return result;
+}
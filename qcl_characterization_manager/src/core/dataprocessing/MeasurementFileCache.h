@@ -0,0 +1,69 @@
+/**
+ * @file MeasurementFileCache.h
+ * @brief Declaration of MeasurementFileCache, parsed measurement files shared across threads.
+ *
+ * The wizard parses every file as soon as it is added and the processors
+ * later read the same result, so each file is parsed once per session.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef MEASUREMENTFILECACHE_H
+	#define MEASUREMENTFILECACHE_H
+
+	#include <QCache>
+	#include <QMutex>
+	#include <QString>
+	#include <QVector>
+
+	/**
+	 * @struct MeasurementFile
+	 * @brief Columns of one parsed measurement file.
+	 */
+	struct MeasurementFile
+	{
+		enum class Kind { LIV, Spectrum }; ///< Three-column L-I-V or two-column FTIR file
+
+		QVector<double> x;   ///< Current [A] or frequency [THz], points with x <= 0.005 dropped
+		QVector<double> y1;  ///< Voltage or raw intensity
+		QVector<double> y2;  ///< Raw optical power; empty for spectra
+		int skippedLines = 0; ///< Non-empty lines without the expected column count or with a NaN/inf value
+		QString error;        ///< Why the file gave no points; empty on success
+
+		bool isValid() const { return error.isEmpty(); } ///< True if at least one point was read
+	};
+
+	/**
+	 * @class MeasurementFileCache
+	 * @brief Thread-safe store of parsed measurement files.
+	 *
+	 * Entries are keyed by kind and absolute path and carry the file size and
+	 * modification time they were parsed from; a file changed on disk is
+	 * parsed again on the next read. The store is bounded by the memory of
+	 * the parsed columns, least recently used entries going first.
+	 *
+	 * read() may be called from any thread. Two threads reading the same
+	 * uncached file both parse it; the result is identical either way.
+	 */
+	class MeasurementFileCache
+	{
+		public:
+			static MeasurementFile read(const QString &fileName, MeasurementFile::Kind kind); ///< Parsed columns, from the store or the file
+			static QString checkHeader(const QString &fileName, MeasurementFile::Kind kind); ///< Quick format check of the first lines
+			static void clear(); ///< Drop every entry
+
+		private:
+			static MeasurementFile parse(const QString &fileName, MeasurementFile::Kind kind); ///< Read and parse the file
+
+			struct Entry
+			{
+				qint64 size;          ///< File size at parse time
+				qint64 modified;      ///< Modification time at parse time [ms since epoch]
+				MeasurementFile file; ///< Parsed columns
+			};
+
+			static QMutex mutex;                  ///< Guards entries
+			static QCache<QString, Entry> entries; ///< Parsed files, cost in KiB
+	};
+#endif // MEASUREMENTFILECACHE_H
@@ -7,8 +7,7 @@
  */
 
 #include "SpectraDataProcessor.h"
-#include <QFile>
-#include <QTextStream>
+#include "MeasurementFileCache.h"
 #include <QDebug>
 #include <algorithm>  
 #include <cmath>      
@@ -66,6 +65,41 @@ SpectraDataProcessor::SpectraDataProcessor(const QString &fileName,
     }
 }
 
+/**
+ * \brief Initializes the SpectraDataProcessor object from spectra that were already processed.
+ * 
+ * Used to reopen a saved project without its measurement files. The spectra are
+ * taken as they are and no peak search is run; side modes are not restored, so
+ * each trace gets an empty side mode list.
+ * 
+ * \param fileName Base filename or identifier used in processing.
+ * \param traceVariable Name of the trace variable (e.g., "current").
+ * \param values Trace variable value of each trace, in ascending order.
+ * \param x Ascending frequencies of each trace.
+ * \param y1 Normalised intensity of each trace.
+ * \param centerModes Centre mode of each trace.
+ * \param fmin Minimum frequency of the figures.
+ * \param fmax Maximum frequency of the figures.
+ */
+SpectraDataProcessor::SpectraDataProcessor(const QString &fileName,
+                                           const QString &traceVariable,
+                                           const QList<QString> &values,
+                                           const QList<QVector<double>> &x,
+                                           const QList<QVector<double>> &y1,
+                                           const QVector<Peak> &centerModes,
+                                           double fmin,
+                                           double fmax)
+    : IDataProcessor(fileName, "mA", traceVariable)
+    , fmin(fmin)
+    , fmax(fmax)
+    , xList(x)
+    , y1List(y1)
+    , valueList(values)
+    , centerModeData(centerModes)
+    , sideModeData(x.size())
+{
+}
+
 /**
  * \brief Generates frequency (x) and amplitude (y1) vectors from the provided files.
  * 
@@ -166,6 +200,8 @@ void SpectraDataProcessor::ensureAscendingX()
  * 
  * Parses a text file where each line contains two columns: frequency and amplitude.
  * Converts frequency units to THz and filters out frequencies below 0.005 THz.
+ * The file is read through MeasurementFileCache, so a file already parsed by
+ * the wizard is not read again.
  * 
  * \param fileName Path to the input data file.
  * \param x Pointer to a QVector<double> that will store frequency values (in THz).
@@ -173,35 +209,9 @@ void SpectraDataProcessor::ensureAscendingX()
  */
 void SpectraDataProcessor::generateVectorsFromFile(const QString &fileName, QVector<double> *x, QVector<double> *y1)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open file for reading:" << fileName;
-        return;
-    }
-
-    QTextStream in(&file);
-    QStringList lines = in.readAll().split('\n', Qt::SkipEmptyParts);
-    file.close();
-
-    x->reserve(lines.size());
-    y1->reserve(lines.size());
-
-    for (const QString &line : lines) {
-        QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (fields.length() != 2) {
-            continue;
-        }
-
-        double xVal = fields[0].toDouble();
-        xVal *= 0.0299792458; // convert to THz
-
-        double y1Val = fields[1].toDouble();
-
-        if (xVal <= 0.005) continue;
-
-        x->append(xVal);
-        y1->append(y1Val);
-    }
+    MeasurementFile file = MeasurementFileCache::read(fileName, MeasurementFile::Kind::Spectrum);
+    *x = file.x;
+    *y1 = file.y1;
 }
 
 /**
@@ -36,6 +36,14 @@
 										  const QString &traceVariable, 
 										  double fmin = 0.0,
 										  double fmax = 0.0); ///< Constructor
+			explicit SpectraDataProcessor(const QString &fileName,
+										  const QString &traceVariable,
+										  const QList<QString> &values,
+										  const QList<QVector<double>> &x,
+										  const QList<QVector<double>> &y1,
+										  const QVector<Peak> &centerModes,
+										  double fmin,
+										  double fmax); ///< Restore already normalised spectra, e.g. from a project
 
 			void normalizeData() override; ///< Normalize spectral data
 
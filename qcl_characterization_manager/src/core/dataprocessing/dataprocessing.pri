@@ -1,12 +1,16 @@
 SOURCES += \
+    $$PWD/FileNamePattern.cpp \
     $$PWD/IDataProcessor.cpp \
     $$PWD/IthDataProcessor.cpp \
     $$PWD/LIVDataProcessor.cpp \
+    $$PWD/MeasurementFileCache.cpp \
     $$PWD/SpectraDataProcessor.cpp	\
 
 HEADERS += \
+    $$PWD/FileNamePattern.h \
     $$PWD/IDataProcessor.h \
     $$PWD/IthDataProcessor.h \
     $$PWD/LIVDataProcessor.h \
+    $$PWD/MeasurementFileCache.h \
     $$PWD/SpectraDataProcessor.h	\
 
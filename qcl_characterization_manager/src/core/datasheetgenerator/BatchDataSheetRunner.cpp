@@ -0,0 +1,341 @@
+/**
+ * \file        BatchDataSheetRunner.cpp
+ * \brief       Builds datasheets for many device directories with bounded parallelism.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QThread>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QDebug>
+#include "BatchDataSheetRunner.h"
+#include "DataSheetGenerator.h"
+#include "NativeDataSheetGenerator.h"
+#include "LatexBuilder.h"
+#include "core/graceplots/FitResults.h"
+#include "core/pipeline/DataMapFile.h"
+
+namespace
+{
+    /// Name of the datasheet written into every device directory.
+    const QString dataSheetName = "LaserDataSheet";
+
+    /**
+     * Fills the values the Grace page would have added to the collected data
+     * from the figure sidecars, since the DataMap is written before it runs.
+     */
+    void addFigureResults(const QString& deviceDir, QVariantMap& params)
+    {
+        for (const QString& prefix : { QString("pulsed"), QString("cw") }) {
+            QString key = prefix + "_ftir_fixed_temp_freq_range";
+            if (!params.value(key).toString().trimmed().isEmpty())
+                continue;
+
+            FitResults spectra;
+            if (spectra.load(FitResults::pathFor(deviceDir + "/GraceFigures/" + prefix + "_ftir_vs_I.agr"))
+                && !spectra.frequencyRangeString().isEmpty())
+                params[key] = spectra.frequencyRangeString();
+        }
+    }
+}
+
+/**
+ * \brief   Constructs an idle batch runner.
+ * \param   parent - Optional parent QObject.
+ *
+ * Defaults to the LaTeX backend, LatexBuilder::defaultPdflatexPath() and half the cores,
+ * since every pdflatex run is a separate process.
+ */
+BatchDataSheetRunner::BatchDataSheetRunner(QObject *parent)
+    : QObject(parent)
+    , backend(LatexBackend)
+    , maxParallelBuilds(qMax(1, QThread::idealThreadCount() / 2))
+    , pdflatexPath(LatexBuilder::defaultPdflatexPath())
+    , batchElapsedMs(0)
+    , next(0)
+    , running(0)
+    , completed(0)
+{
+}
+
+/**
+ * \brief Finds the device directories below a folder.
+ *
+ * \param rootDir A device directory, or a folder holding one directory per device.
+ * \return rootDir itself and each direct subfolder that contain a *_DataMap.txt, sorted by name.
+ */
+QStringList BatchDataSheetRunner::findDeviceDirectories(const QString& rootDir)
+{
+    return DataMapFile::findDeviceDirectories(rootDir);
+}
+
+/**
+ * \brief Reads the collected data of a device from its DataMap file.
+ *
+ * \param deviceDir Device directory.
+ * \param error     Receives the reason of a failure, may be null.
+ * \return The collected data, or an empty map.
+ */
+QVariantMap BatchDataSheetRunner::loadDataMap(const QString& deviceDir, QString *error)
+{
+    QString dataMapPath = DataMapFile::find(deviceDir);
+    if (dataMapPath.isEmpty()) {
+        if (error) *error = "No *_DataMap.txt found";
+        return QVariantMap();
+    }
+    return DataMapFile::read(dataMapPath, error);
+}
+
+/**
+ * \brief Starts generating datasheets.
+ *
+ * \param deviceDirs Device output directories.
+ *
+ * Returns immediately; deviceFinished() is emitted per device and
+ * finished() once all of them are done.
+ */
+void BatchDataSheetRunner::run(const QStringList& deviceDirs)
+{
+    if (isRunning()) {
+        qWarning() << "Batch datasheet run already in progress";
+        return;
+    }
+
+    results.clear();
+    timers.clear();
+    for (const QString& deviceDir : deviceDirs) {
+        DeviceResult result;
+        result.deviceDir = deviceDir;
+        results.append(result);
+        timers.append(QElapsedTimer());
+    }
+
+    next = 0;
+    running = 0;
+    completed = 0;
+    pool.setMaxThreadCount(maxParallelBuilds);
+    batchTimer.start();
+
+    if (results.isEmpty()) {
+        batchElapsedMs = 0;
+        QMetaObject::invokeMethod(this, [this]() { emit finished(0, 0); }, Qt::QueuedConnection);
+        return;
+    }
+
+    startNext();
+}
+
+/**
+ * \brief Starts devices until the parallel limit is reached.
+ *
+ * With the LaTeX backend and no cached preamble format yet, a single device
+ * runs first so the format is dumped once and then shared by all others.
+ */
+void BatchDataSheetRunner::startNext()
+{
+    int limit = maxParallelBuilds;
+    if (backend == LatexBackend && completed == 0 && !formatCacheDir.isEmpty()
+        && !QFile::exists(LatexBuilder::cachedFormatPath(formatCacheDir, pdflatexPath, DataSheetGenerator::preamble())))
+        limit = 1;
+
+    while (running < limit && next < results.size()) {
+        int index = next++;
+        timers[index].start();
+
+        QVariantMap params;
+        if (!prepare(index, params))
+            continue;
+
+        // Counted before starting, since a build that fails to start reports back immediately
+        ++running;
+        bool started = backend == LatexBackend ? startLatex(index, params) : startNative(index, params);
+        if (!started)
+            --running;
+    }
+
+    if (running == 0 && next >= results.size())
+        finishBatch();
+}
+
+/**
+ * \brief Loads a device's data.
+ *
+ * \param index  Device index.
+ * \param params Receives the collected data.
+ * \return false if the device cannot be built; its failure is recorded.
+ */
+bool BatchDataSheetRunner::prepare(int index, QVariantMap& params)
+{
+    const QString& deviceDir = results[index].deviceDir;
+
+    QString error;
+    params = loadDataMap(deviceDir, &error);
+    if (params.isEmpty()) {
+        record(index, false, QString(), error);
+        return false;
+    }
+
+    addFigureResults(deviceDir, params);
+    return true;
+}
+
+/**
+ * \brief Writes a device's .tex file and starts compiling it.
+ *
+ * \return false if the .tex file could not be written; the failure is recorded.
+ */
+bool BatchDataSheetRunner::startLatex(int index, const QVariantMap& params)
+{
+    QString texPath = results[index].deviceDir + "/" + dataSheetName + ".tex";
+
+    QMap<QString, QString> pulsedMetadata;
+    QMap<QString, QString> cwMetadata;
+    DataSheetGenerator::splitMeasurementMetadata(params, pulsedMetadata, cwMetadata);
+
+    QFile::remove(texPath);  // so a failed write is not hidden by an old file
+    DataSheetGenerator generator(texPath, params);
+    generator.setMeasurementMetadata(pulsedMetadata, cwMetadata);
+    generator.generate();
+
+    if (!QFile::exists(texPath)) {
+        record(index, false, QString(), "Failed to write " + texPath);
+        return false;
+    }
+
+    LatexBuilder *builder = new LatexBuilder(pdflatexPath, this);
+    builder->setFormatCacheDir(formatCacheDir);
+    connect(builder, &LatexBuilder::finished, this, [this, index, builder](bool success, const QString& pdfPath, int /*passes*/) {
+        builder->deleteLater();
+        complete(index, success, success ? pdfPath : QString(),
+                 success ? QString() : "pdflatex failed, see " + dataSheetName + ".log");
+    });
+    builder->build(texPath, DataSheetGenerator::preamble());
+    return true;
+}
+
+/**
+ * \brief Renders a device's PDF on the thread pool.
+ *
+ * \return true; failures are reported when the render finishes.
+ */
+bool BatchDataSheetRunner::startNative(int index, const QVariantMap& params)
+{
+    QString pdfPath = results[index].deviceDir + "/" + dataSheetName + ".pdf";
+
+    auto *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, index, watcher, pdfPath]() {
+        QString error = watcher->result();
+        watcher->deleteLater();
+        complete(index, error.isEmpty(), error.isEmpty() ? pdfPath : QString(), error);
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pool, [params, pdfPath]() {
+        QMap<QString, QString> pulsedMetadata;
+        QMap<QString, QString> cwMetadata;
+        DataSheetGenerator::splitMeasurementMetadata(params, pulsedMetadata, cwMetadata);
+
+        NativeDataSheetGenerator generator(pdfPath, params);
+        generator.setMeasurementMetadata(pulsedMetadata, cwMetadata);
+        return generator.generate() ? QString() : generator.errorString();
+    }));
+    return true;
+}
+
+/**
+ * \brief Records the result of a device that was in flight and starts the next one.
+ */
+void BatchDataSheetRunner::complete(int index, bool success, const QString& pdfPath, const QString& error)
+{
+    --running;
+    record(index, success, pdfPath, error);
+    startNext();
+}
+
+/**
+ * \brief Stores a device's result and reports it.
+ */
+void BatchDataSheetRunner::record(int index, bool success, const QString& pdfPath, const QString& error)
+{
+    DeviceResult& result = results[index];
+    result.success = success;
+    result.pdfPath = pdfPath;
+    result.error = error;
+    result.elapsedMs = timers[index].elapsed();
+
+    ++completed;
+    emit deviceFinished(result.deviceDir, success, completed, results.size());
+}
+
+/**
+ * \brief Reports the end of the batch, once.
+ */
+void BatchDataSheetRunner::finishBatch()
+{
+    if (completed != results.size() || !batchTimer.isValid())
+        return;  // already reported from a nested startNext()
+
+    batchElapsedMs = batchTimer.elapsed();
+    batchTimer.invalidate();
+
+    int succeeded = 0;
+    for (const DeviceResult& r : results)
+        succeeded += r.success ? 1 : 0;
+    emit finished(succeeded, results.size() - succeeded);
+}
+
+/**
+ * \brief Formats the batch results.
+ *
+ * \return A header with totals and wall time, then one line per device with
+ *         its status, time and PDF path or failure reason.
+ */
+QString BatchDataSheetRunner::summary() const
+{
+    int succeeded = 0;
+    int nameWidth = 0;
+    for (const DeviceResult& result : results) {
+        succeeded += result.success ? 1 : 0;
+        nameWidth = qMax(nameWidth, int(result.deviceDir.length()));
+    }
+
+    QString report;
+    QTextStream out(&report);
+    out << "=== Batch Data Sheet Report ===\n";
+    out << "Date: " << QDateTime::currentDateTime().toString("dd-MM-yyyy hh:mm:ss") << "\n";
+    out << "Backend: " << (backend == LatexBackend ? "LaTeX" : "Native PDF")
+        << ", parallel builds: " << maxParallelBuilds << "\n";
+    out << "Devices: " << results.size() << ", succeeded: " << succeeded
+        << ", failed: " << results.size() - succeeded
+        << ", wall time: " << QString::number(batchElapsedMs / 1000.0, 'f', 1) << " s\n\n";
+
+    for (const DeviceResult& result : results) {
+        out << result.deviceDir.leftJustified(nameWidth, ' ') << "  "
+            << (result.success ? "OK    " : "FAILED") << "  "
+            << QString::number(result.elapsedMs / 1000.0, 'f', 1).rightJustified(7, ' ') << " s  "
+            << (result.success ? result.pdfPath : result.error) << "\n";
+    }
+    return report;
+}
+
+/**
+ * \brief Saves the summary.
+ *
+ * \param filePath Report file.
+ * \return true on success.
+ */
+bool BatchDataSheetRunner::writeReport(const QString& filePath) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to write batch report:" << filePath;
+        return false;
+    }
+    file.write(summary().toUtf8());
+    return file.commit();
+}
@@ -0,0 +1,112 @@
+/**
+ * @file BatchDataSheetRunner.h
+ * @brief Declaration of BatchDataSheetRunner, which builds datasheets for many devices.
+ *
+ * Generates and compiles one datasheet per device output directory with a
+ * bounded number of builds in flight, and collects a report of the results.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef BATCHDATASHEETRUNNER_H
+	#define BATCHDATASHEETRUNNER_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QStringList>
+	#include <QVector>
+	#include <QVariantMap>
+	#include <QElapsedTimer>
+	#include <QThreadPool>
+
+	/**
+	 * @class BatchDataSheetRunner
+	 * @brief Runs DataSheetGenerator (or NativeDataSheetGenerator) for a list of devices.
+	 *
+	 * Each device directory must hold the <Sample>_DataMap.txt written by the
+	 * wizard and the Figures/GraceFigures folders of an earlier figure run.
+	 * Fit results are taken from the FitResults sidecars next to the Grace
+	 * figures, so no data is re-processed.
+	 *
+	 * - LaTeX backend: the .tex files are written on the calling thread and up
+	 *   to maxParallel() LatexBuilder instances run at once. All builds share
+	 *   one precompiled preamble format through LatexBuilder's format cache;
+	 *   while that format does not exist yet, the first device runs alone so
+	 *   the format is dumped only once.
+	 * - Native backend: PDFs are rendered on a private thread pool limited to
+	 *   maxParallel() threads.
+	 *
+	 * Results are reported per device through deviceFinished() and summarised
+	 * by summary() / writeReport() once finished() is emitted.
+	 */
+	class BatchDataSheetRunner : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			/// Datasheet backend used for every device.
+			enum Backend
+			{
+				LatexBackend,  ///< DataSheetGenerator + LatexBuilder
+				NativeBackend  ///< NativeDataSheetGenerator
+			};
+
+			/**
+			 * @struct DeviceResult
+			 * @brief Outcome of one device.
+			 */
+			struct DeviceResult {
+				QString deviceDir;      ///< Device output directory
+				QString pdfPath;        ///< Datasheet PDF, empty if none was produced
+				bool success = false;   ///< True if the PDF was produced or already up to date
+				QString error;          ///< Reason of a failure
+				qint64 elapsedMs = 0;   ///< Time spent on this device
+			};
+
+			explicit BatchDataSheetRunner(QObject *parent = nullptr); ///< Constructor
+
+			void setBackend(Backend backend) { this->backend = backend; } ///< Select the backend (default LaTeX)
+			void setMaxParallel(int count) { maxParallelBuilds = qMax(1, count); } ///< Limit on concurrent builds
+			int maxParallel() const { return maxParallelBuilds; } ///< Limit on concurrent builds
+			void setPdflatexPath(const QString& path) { pdflatexPath = path; } ///< pdflatex for the LaTeX backend
+			void setFormatCacheDir(const QString& dir) { formatCacheDir = dir; } ///< Shared format cache for the LaTeX backend
+
+			static QStringList findDeviceDirectories(const QString& rootDir); ///< Root and subfolders holding a *_DataMap.txt
+			static QVariantMap loadDataMap(const QString& deviceDir, QString *error = nullptr); ///< Collected data of a device
+
+			void run(const QStringList& deviceDirs); ///< Start the batch
+			bool isRunning() const { return running > 0 || next < results.size(); } ///< True until finished() is emitted
+			const QVector<DeviceResult>& deviceResults() const { return results; } ///< Results, in input order
+
+			QString summary() const; ///< Text report of all devices
+			bool writeReport(const QString& filePath) const; ///< Save summary() to a file
+
+		signals:
+			void deviceFinished(const QString& deviceDir, bool success, int completed, int total); ///< One device is done
+			void finished(int succeeded, int failed); ///< All devices are done
+
+		private:
+			bool prepare(int index, QVariantMap& params); ///< Load the device data, records failures
+			void startNext(); ///< Launch devices up to the parallel limit
+			bool startLatex(int index, const QVariantMap& params); ///< Write the .tex file and start its build
+			bool startNative(int index, const QVariantMap& params); ///< Render the PDF on the pool
+			void complete(int index, bool success, const QString& pdfPath, const QString& error); ///< Finish a device in flight
+			void record(int index, bool success, const QString& pdfPath, const QString& error); ///< Store and report a result
+			void finishBatch(); ///< Emit finished()
+
+			Backend backend;             ///< Backend used for every device
+			int maxParallelBuilds;       ///< Limit on concurrent builds
+			QString pdflatexPath;        ///< pdflatex executable
+			QString formatCacheDir;      ///< Shared LaTeX format folder, empty for none
+			QThreadPool pool;            ///< Threads of the native backend
+
+			QVector<DeviceResult> results;  ///< One entry per device
+			QVector<QElapsedTimer> timers;  ///< Start time of each device
+			QElapsedTimer batchTimer;       ///< Wall time of the batch
+			qint64 batchElapsedMs;          ///< Wall time once finished
+			int next;                       ///< Index of the next device to start
+			int running;                    ///< Devices in flight
+			int completed;                  ///< Devices done
+	};
+#endif // BATCHDATASHEETRUNNER_H
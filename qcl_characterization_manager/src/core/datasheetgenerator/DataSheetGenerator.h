@@ -14,10 +14,16 @@
 	#include <QMap>
 	#include <QVector>
 	#include <QSet>
+	#include <QVariantMap>
+	#include "core/graceplots/FitResults.h"
+	#include "DataSheetTemplate.h"
 
 	/**
 	 * @class DataSheetGenerator
 	 * @brief Generates LaTeX data sheets from measurement data and figures.
+	 *
+	 * The document layout is a DataSheetTemplate loaded from a layout file;
+	 * this class only gathers and escapes the values the layout refers to.
 	 */
 	class DataSheetGenerator
 	{
@@ -27,41 +33,29 @@
 			void setMeasurementMetadata(const QMap<QString, QString>& pulsedLIV,
 										const QMap<QString, QString>& cw); ///< Set measurement metadata
 			void setFigures(const QMap<QString, QVector<QString>>& figuresBySection); ///< Set figures grouped by section
+			void setTemplatePath(const QString& path) { templatePath = path; } ///< Use another layout file
 			void generate(); ///< Generate the data sheet
 
+			static QString preamble(); ///< Fixed LaTeX preamble, precompiled by LatexBuilder
+			static QString defaultTemplatePath(); ///< Local layout override, else the built-in layout
+			static void splitMeasurementMetadata(const QVariantMap& data,
+												 QMap<QString, QString>& pulsed,
+												 QMap<QString, QString>& cw); ///< Sort collected data into pulsed and CW metadata
+
 		private:
 			QString outputPath; ///< Output file path
+			QString templatePath; ///< Layout file, empty for defaultTemplatePath()
 			QMap<QString, QVariant> params; ///< Parameters for generation
 			QSet<QString> availableFigures; ///< Set of available figure names
 
 			QMap<QString, QString> pulsedMetadata; ///< Pulsed measurement metadata
 			QMap<QString, QString> cwMetadata; ///< CW measurement metadata (ignored for now)
 			QMap<QString, QVector<QString>> figuresMap; ///< Figures organized by section
+			QMap<QString, FitResults::ExponentialFit> ithFits; ///< Threshold fits by mode ("pulsed", "cw")
 
-			QString generateHeader() const; ///< Generate LaTeX header
-			QString generateFooter() const; ///< Generate LaTeX footer
-			QString generatePerformanceSummary() const; ///< Generate performance summary section
-
-			QString generatePulsedSection() const; ///< Generate pulsed section
-			QString generatePulsedLIVSubsection() const; ///< Generate pulsed LIV subsection
-			QString generatePulsedSpectraSubsection() const; ///< Generate pulsed spectra subsection
-			QString generatePulsedLIVTable() const; ///< Generate pulsed LIV data table
-			QString generatePulsedSpectraTable() const; ///< Generate pulsed spectra data table
-			QString generateCombinedLIVFigures(bool hasLIV, bool hasIth) const; ///< Generate combined LIV figures
-			QString generateCombinedFTIRFigures(bool hasVsI, bool hasVsT) const; ///< Generate combined FTIR figures
-			QString generateCWSection() const; ///< Generate CW section
-			QString generateCWLIVSubsection() const; ///< Generate CW LIV subsection
-			QString generateCWSpectraSubsection() const; ///< Generate CW spectra subsection
-			QString generateCWLIVTable() const; ///< Generate CW LIV table
-			QString generateCWSpectraTable() const; ///< Generate CW spectra table
-			QString generateCombinedCWLIVFigures(bool hasLIV, bool hasIth) const; ///< Generate combined CW LIV figures
-			QString generateCombinedCWFTIRFigures(bool hasVsI, bool hasVsT) const; ///< Generate combined CW FTIR figures
-
-			QString generateFigureBlock(const QString& fileName, const QString& caption) const; ///< Generate figure block in LaTeX
-			QString generateExperimentalNotes(const QString &notes) const; ///< Generate experimental notes section
-			QString parseIthFormulaFromAgrFile(const QString& filePath) const; ///< Parse Ith formula from .agr file
+			DataSheetTemplate::Context buildContext() const; ///< Values for the datasheet layout
+			QString formatIthFit(const QString& prefix, bool density) const; ///< Saved Ith/Jth fit as a LaTeX formula
 
 			QString escapeLatex(const QString& str) const; ///< Escape LaTeX special characters
-			static QString trimTrailingBackslashes(const QString& str); ///< Trim trailing backslashes from string
 	};
 #endif // DATASHEETGENERATOR_H
\ No newline at end of file
@@ -0,0 +1,284 @@
+/**
+ * \file        DataSheetTemplate.cpp
+ * \brief       Compiles datasheet layout files and renders them per device.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "DataSheetTemplate.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace {
+	const QString openTag = QStringLiteral("<<");
+	const QString closeTag = QStringLiteral(">>");
+
+	/// True if source[from, to) holds only spaces, tabs or carriage returns.
+	bool isBlank(const QString& source, int from, int to)
+	{
+		for (int i = from; i < to; ++i) {
+			const QChar c = source.at(i);
+			if (c != ' ' && c != '\t' && c != '\r')
+				return false;
+		}
+		return true;
+	}
+}
+
+/**
+ * \brief Constructs an empty, invalid template.
+ */
+DataSheetTemplate::DataSheetTemplate()
+	: valid(false) {}
+
+/**
+ * \brief Reads a layout file and compiles it.
+ * \param filePath Layout file, may be a Qt resource path.
+ * \return true on success; otherwise errorString() holds the reason.
+ */
+bool DataSheetTemplate::load(const QString& filePath)
+{
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		valid = false;
+		program.clear();
+		errorMessage = QString("Cannot open datasheet template %1").arg(filePath);
+		return false;
+	}
+
+	if (!compile(QString::fromUtf8(file.readAll()))) {
+		errorMessage = QString("%1: %2").arg(filePath, errorMessage);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Compiles layout text into the instruction list.
+ *
+ * Literal text between tags becomes one Text instruction. A block opening tag
+ * becomes a skip instruction whose jump target is patched when the matching
+ * closing tag is reached, so blocks nest without any runtime stack.
+ *
+ * \param source Layout text.
+ * \return true on success; otherwise errorString() holds the line and reason.
+ */
+bool DataSheetTemplate::compile(const QString& source)
+{
+	program.clear();
+	valid = false;
+	errorMessage.clear();
+
+	QVector<QPair<QString, int>> openBlocks;	// name and index of the skip instruction
+	QString pending;
+
+	auto flush = [&]() {
+		if (!pending.isEmpty()) {
+			program.append({ Instruction::Text, pending, QString(), -1 });
+			pending.clear();
+		}
+	};
+
+	int pos = 0;
+	while (pos < source.size())
+	{
+		int start = source.indexOf(openTag, pos);
+		if (start < 0) {
+			pending += QStringView(source).mid(pos);
+			break;
+		}
+
+		int end = source.indexOf(closeTag, start + openTag.size());
+		if (end < 0)
+			return fail(source, start, "unterminated tag");
+
+		pending += QStringView(source).mid(pos, start - pos);
+		QString tag = source.mid(start + openTag.size(), end - start - openTag.size()).trimmed();
+		pos = end + closeTag.size();
+
+		if (tag.isEmpty())
+			return fail(source, start, "empty tag");
+
+		const QChar kind = tag.at(0);
+		const bool isBlockTag = (kind == '#' || kind == '^' || kind == '/' || kind == '!');
+
+		// Drop lines that hold nothing but a block or comment tag
+		if (isBlockTag) {
+			int lineStart = start > 0 ? source.lastIndexOf('\n', start - 1) + 1 : 0;
+			int lineEnd = source.indexOf('\n', pos);
+			if (lineEnd < 0)
+				lineEnd = source.size();
+
+			if (isBlank(source, lineStart, start) && isBlank(source, pos, lineEnd)) {
+				pending.chop(start - lineStart);
+				pos = qMin(lineEnd + 1, int(source.size()));
+			}
+		}
+
+		if (kind == '!')
+			continue;
+
+		if (kind == '#' || kind == '^') {
+			QString name = tag.mid(1).trimmed();
+			if (name.isEmpty())
+				return fail(source, start, "block without a name");
+
+			flush();
+			openBlocks.append({ name, int(program.size()) });
+			program.append({ kind == '#' ? Instruction::SkipIfEmpty : Instruction::SkipIfSet, name, QString(), -1 });
+		}
+		else if (kind == '/') {
+			QString name = tag.mid(1).trimmed();
+			if (openBlocks.isEmpty())
+				return fail(source, start, QString("<</%1>> closes no block").arg(name));
+			if (openBlocks.last().first != name)
+				return fail(source, start, QString("<</%1>> closes <<%2>>").arg(name, openBlocks.last().first));
+
+			flush();
+			program[openBlocks.last().second].jump = program.size();
+			openBlocks.removeLast();
+		}
+		else {
+			int bar = tag.indexOf('|');
+			QString name = (bar < 0 ? tag : tag.left(bar)).trimmed();
+			QString fallback = bar < 0 ? QString() : tag.mid(bar + 1);
+			if (name.isEmpty())
+				return fail(source, start, "value without a name");
+
+			flush();
+			program.append({ Instruction::Value, name, fallback, -1 });
+		}
+	}
+
+	if (!openBlocks.isEmpty())
+		return fail(source, source.size(), QString("<<%1>> is never closed").arg(openBlocks.last().first));
+
+	flush();
+	program.squeeze();
+	valid = true;
+	return true;
+}
+
+/**
+ * \brief Records a compile error and resets the template.
+ * \param source   Layout text, used to find the line number.
+ * \param position Offset of the offending tag.
+ * \param message  Description of the problem.
+ * \return Always false.
+ */
+bool DataSheetTemplate::fail(const QString& source, int position, const QString& message)
+{
+	int line = 1 + QStringView(source).left(position).count('\n');
+	errorMessage = QString("line %1: %2").arg(line).arg(message);
+	program.clear();
+	valid = false;
+	return false;
+}
+
+/**
+ * \brief Runs the compiled program against a context.
+ * \param context Tag values.
+ * \param sink    Called with every piece of output, in order.
+ */
+template <typename Sink>
+void DataSheetTemplate::execute(const Context& context, Sink sink) const
+{
+	const int count = program.size();
+	int pc = 0;
+	while (pc < count)
+	{
+		const Instruction& instruction = program.at(pc);
+		switch (instruction.op)
+		{
+			case Instruction::Text:
+				sink(instruction.text);
+				++pc;
+				break;
+
+			case Instruction::Value: {
+				auto it = context.constFind(instruction.text);
+				sink((it == context.constEnd() || it->isEmpty()) ? instruction.fallback : *it);
+				++pc;
+				break;
+			}
+
+			case Instruction::SkipIfEmpty:
+			case Instruction::SkipIfSet: {
+				auto it = context.constFind(instruction.text);
+				bool set = it != context.constEnd() && !it->isEmpty();
+				bool skip = (instruction.op == Instruction::SkipIfEmpty) ? !set : set;
+				pc = skip ? instruction.jump : pc + 1;
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * \brief Renders the template for one device.
+ *
+ * The program is run twice: the first pass only sums the output length, so
+ * the second pass appends into a buffer allocated once.
+ *
+ * \param context Tag values.
+ * \return The rendered text, empty if the template is not valid.
+ */
+QString DataSheetTemplate::render(const Context& context) const
+{
+	if (!valid)
+		return QString();
+
+	qsizetype size = 0;
+	execute(context, [&size](const QString& piece) { size += piece.size(); });
+
+	QString output;
+	output.reserve(size);
+	execute(context, [&output](const QString& piece) { output += piece; });
+	return output;
+}
+
+/**
+ * \brief Returns the compiled layout of a file, compiling it only when needed.
+ *
+ * Compiled layouts are kept per path together with the file's size and
+ * modification time, so batch runs compile a layout once while edits to the
+ * file are still picked up by the next datasheet. Safe to call from any thread.
+ *
+ * \param filePath Layout file, may be a Qt resource path.
+ * \param error    Receives the reason if the layout cannot be loaded.
+ * \return The compiled layout, or null on failure.
+ */
+QSharedPointer<const DataSheetTemplate> DataSheetTemplate::fromFile(const QString& filePath, QString *error)
+{
+	struct CacheEntry {
+		QDateTime modified;
+		qint64 size;
+		QSharedPointer<const DataSheetTemplate> layout;
+	};
+	static QMutex mutex;
+	static QHash<QString, CacheEntry> cache;
+
+	QFileInfo info(filePath);
+	QDateTime modified = info.lastModified();
+	qint64 size = info.size();
+
+	QMutexLocker locker(&mutex);
+	auto it = cache.constFind(filePath);
+	if (it != cache.constEnd() && it->modified == modified && it->size == size)
+		return it->layout;
+
+	QSharedPointer<DataSheetTemplate> layout(new DataSheetTemplate);
+	if (!layout->load(filePath)) {
+		qWarning() << layout->errorString();
+		if (error)
+			*error = layout->errorString();
+		cache.remove(filePath);
+		return QSharedPointer<const DataSheetTemplate>();
+	}
+
+	cache.insert(filePath, { modified, size, layout });
+	return layout;
+}
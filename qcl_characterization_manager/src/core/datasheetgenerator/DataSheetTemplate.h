@@ -0,0 +1,81 @@
+/**
+ * @file DataSheetTemplate.h
+ * @brief Declaration of DataSheetTemplate, a compiled text template for datasheets.
+ *
+ * Loads a datasheet layout from a file, compiles it once into an instruction
+ * list and renders it for any number of devices.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef DATASHEETTEMPLATE_H
+	#define DATASHEETTEMPLATE_H
+
+	#include <QString>
+	#include <QVector>
+	#include <QHash>
+	#include <QPair>
+	#include <QSharedPointer>
+
+	/**
+	 * @class DataSheetTemplate
+	 * @brief Minimal logic-less template language compiled to a flat program.
+	 *
+	 * Tags are delimited by << and >> so they do not clash with LaTeX braces:
+	 * - <<name>>          value of name, inserted as is
+	 * - <<name|text>>     value of name, or text if name is empty
+	 * - <<#name>>...<</name>>  block kept if name is non-empty
+	 * - <<^name>>...<</name>>  block kept if name is empty
+	 * - <<! comment >>    dropped
+	 *
+	 * Block and comment tags alone on a line remove the whole line, so the
+	 * layout can be indented freely. Values are not escaped by the template;
+	 * the caller fills the context with text that is already valid output.
+	 *
+	 * Blocks compile to conditional jumps, so render() is a single pass over
+	 * the program with one hash lookup per tag. The output size is computed
+	 * first and the result is built in one preallocated buffer.
+	 */
+	class DataSheetTemplate
+	{
+		public:
+			using Context = QHash<QString, QString>; ///< Tag values by name
+
+			DataSheetTemplate(); ///< Constructor, empty template
+
+			bool load(const QString& filePath); ///< Read and compile a layout file
+			bool compile(const QString& source); ///< Compile layout text
+			bool isValid() const { return valid; } ///< True after a successful compile
+			QString errorString() const { return errorMessage; } ///< Reason of the last failure
+
+			QString render(const Context& context) const; ///< Output for one device
+
+			static QSharedPointer<const DataSheetTemplate> fromFile(const QString& filePath,
+																	QString *error = nullptr); ///< Compiled layout, cached until the file changes
+
+		private:
+			/// One step of the compiled program.
+			struct Instruction {
+				enum Op {
+					Text,         ///< Append text
+					Value,        ///< Append context[text], or fallback if empty
+					SkipIfEmpty,  ///< Jump if context[text] is empty
+					SkipIfSet     ///< Jump if context[text] is non-empty
+				};
+				Op op;
+				QString text;      ///< Literal text or tag name
+				QString fallback;  ///< Text used by Value when the tag is empty
+				int jump;          ///< Target of the skip instructions
+			};
+
+			QVector<Instruction> program; ///< Compiled layout
+			bool valid;                   ///< Compile succeeded
+			QString errorMessage;         ///< Last load or compile error
+
+			bool fail(const QString& source, int position, const QString& message); ///< Record a compile error
+
+			template <typename Sink>
+			void execute(const Context& context, Sink sink) const; ///< Run the program, passing each piece to sink
+	};
+#endif // DATASHEETTEMPLATE_H
@@ -0,0 +1,468 @@
+/**
+ * \file        LatexBuilder.cpp
+ * \brief       Incremental pdflatex builds with a precompiled preamble format.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QTimer>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QDebug>
+#include "LatexBuilder.h"
+
+namespace
+{
+    /// Macro defined by the precompiled format; the datasheet skips its preamble when it is set.
+    const QString preambleMarker = "qclDatasheetPreamble";
+
+    /// True if an .aux file carries anything a later pass reads back (labels, citations, lists).
+    bool auxHasCrossReferences(const QString& auxFilePath)
+    {
+        QFile aux(auxFilePath);
+        if (!aux.open(QIODevice::ReadOnly | QIODevice::Text))
+            return false;
+
+        QByteArray text = aux.readAll();
+        return text.contains("\\newlabel") || text.contains("\\bibcite") || text.contains("\\@writefile");
+    }
+}
+
+/**
+ * \brief   Constructs a builder for the given pdflatex executable.
+ * \param   pdflatexPath - Path to pdflatex.
+ * \param   parent - Optional parent QObject.
+ */
+LatexBuilder::LatexBuilder(const QString& pdflatexPath, QObject *parent)
+    : QObject(parent)
+    , pdflatexPath(pdflatexPath)
+    , process(nullptr)
+    , step(Step::Document)
+    , useFormat(false)
+    , passes(0)
+    , maxPasses(3)
+    , storedPdfModified(-1)
+{
+}
+
+/**
+ * \brief Returns the pdflatex executable to use when none is configured.
+ *
+ * The portable MiKTeX shipped next to the application comes first; without
+ * it (e.g. the command-line tool on Linux) pdflatex is looked up on the PATH.
+ *
+ * \return Path to pdflatex; the bundled path if neither exists, so that
+ *         callers can report where it was expected.
+ */
+QString LatexBuilder::defaultPdflatexPath()
+{
+    QString bundled = QCoreApplication::applicationDirPath() + "/miktex-portable/texmfs/install/miktex/bin/x64/pdflatex.exe";
+    if (QFile::exists(bundled))
+        return bundled;
+
+    QString onPath = QStandardPaths::findExecutable("pdflatex");
+    return onPath.isEmpty() ? bundled : onPath;
+}
+
+/**
+ * \brief Starts building a PDF from a .tex file.
+ *
+ * \param texFilePath The document to compile; the PDF is written next to it.
+ * \param preamble    Fixed preamble to precompile into a format, or empty to
+ *                    always compile cold (e.g. for user-supplied .tex files).
+ *
+ * Returns immediately; \c finished is emitted when the build is done, also
+ * when nothing had to be rebuilt.
+ */
+void LatexBuilder::build(const QString& texFilePath, const QString& preamble)
+{
+    if (process) {
+        qWarning() << "LaTeX build already running for:" << this->texFilePath;
+        return;
+    }
+
+    QFileInfo texFileInfo(texFilePath);
+    this->texFilePath = texFileInfo.absoluteFilePath();
+    workDir = texFileInfo.absolutePath();
+    baseName = texFileInfo.completeBaseName();
+    preambleText = preamble;
+    useFormat = !preamble.isEmpty();
+    passes = 0;
+
+    loadState();
+
+    if (isUpToDate()) {
+        qDebug() << "LaTeX output is up to date:" << this->texFilePath;
+        QTimer::singleShot(0, this, [this]() { finish(true); });
+        return;
+    }
+
+    if (useFormat && !formatCacheDir.isEmpty())
+        useCachedFormat();
+
+    if (useFormat && (storedPreambleKey != preambleKey() || !QFile::exists(workDir + "/" + baseName + "-preamble.fmt")))
+        startFormat();
+    else
+        startPass();
+}
+
+/**
+ * \brief Hashes a file's content.
+ *
+ * \param filePath The file to hash.
+ * \return The hex SHA-1 digest, or an empty array if the file cannot be read.
+ */
+QByteArray LatexBuilder::hashFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result().toHex();
+}
+
+/**
+ * \brief Hashes every figure the document includes.
+ *
+ * \return Map of the path as written in \c \\includegraphics to its hash.
+ *         Missing figures map to an empty hash, so they count as changed
+ *         once they appear.
+ */
+QMap<QString, QByteArray> LatexBuilder::figureHashes() const
+{
+    QMap<QString, QByteArray> figures;
+
+    QFile texFile(texFilePath);
+    if (!texFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return figures;
+
+    static const QRegularExpression includeRegex(R"(\\includegraphics\s*(?:\[[^\]]*\])?\s*\{([^}]+)\})");
+    QRegularExpressionMatchIterator it = includeRegex.globalMatch(QString::fromUtf8(texFile.readAll()));
+    while (it.hasNext()) {
+        QString figure = it.next().captured(1).trimmed();
+        QString figurePath = QDir(workDir).absoluteFilePath(figure);
+        if (QFileInfo(figurePath).suffix().isEmpty())
+            figurePath += ".pdf";
+        figures.insert(figure, hashFile(figurePath));
+    }
+    return figures;
+}
+
+/**
+ * \brief Identifies the format a preamble compiles to.
+ *
+ * \return Hash of the preamble text and of the pdflatex executable's path and
+ *         timestamp, since formats are tied to the engine that dumped them.
+ */
+QByteArray LatexBuilder::preambleKey() const
+{
+    return preambleKey(preambleText, pdflatexPath);
+}
+
+/**
+ * \brief Identifies the format a preamble compiles to with a given pdflatex.
+ *
+ * \param preamble     Preamble text.
+ * \param pdflatexPath pdflatex executable.
+ */
+QByteArray LatexBuilder::preambleKey(const QString& preamble, const QString& pdflatexPath)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(preamble.toUtf8());
+    hash.addData(pdflatexPath.toUtf8());
+    hash.addData(QByteArray::number(QFileInfo(pdflatexPath).lastModified().toMSecsSinceEpoch()));
+    return hash.result().toHex();
+}
+
+/**
+ * \brief Returns where a shared format for a preamble is cached.
+ *
+ * \param cacheDir     Cache folder, see setFormatCacheDir().
+ * \param pdflatexPath pdflatex executable.
+ * \param preamble     Preamble text.
+ * \return <cacheDir>/qcl-preamble-<key>.fmt; the file may not exist yet.
+ */
+QString LatexBuilder::cachedFormatPath(const QString& cacheDir, const QString& pdflatexPath, const QString& preamble)
+{
+    return cacheDir + "/qcl-preamble-" + QString::fromLatin1(preambleKey(preamble, pdflatexPath).left(16)) + ".fmt";
+}
+
+/**
+ * \brief Copies the cached format, if any, next to the document.
+ *
+ * The cache file name contains the preamble key, so a cached format is
+ * always valid for this preamble and engine.
+ */
+void LatexBuilder::useCachedFormat()
+{
+    QString cached = cachedFormatPath(formatCacheDir, pdflatexPath, preambleText);
+    QString local = workDir + "/" + baseName + "-preamble.fmt";
+
+    if (!QFile::exists(cached) || (storedPreambleKey == preambleKey() && QFile::exists(local)))
+        return;
+
+    QFile::remove(local);
+    if (QFile::copy(cached, local))
+        storedPreambleKey = preambleKey();
+}
+
+/**
+ * \brief Publishes the document's freshly dumped format to the cache.
+ *
+ * The copy goes through a temporary file and a rename, so concurrent builds
+ * never load a partially written format.
+ */
+void LatexBuilder::storeCachedFormat() const
+{
+    QString cached = cachedFormatPath(formatCacheDir, pdflatexPath, preambleText);
+    if (QFile::exists(cached) || !QDir().mkpath(formatCacheDir))
+        return;
+
+    QString temporary = cached + "." + baseName + ".tmp";
+    QFile::remove(temporary);
+    if (!QFile::copy(workDir + "/" + baseName + "-preamble.fmt", temporary) || !QFile::rename(temporary, cached)) {
+        QFile::remove(temporary);
+        qWarning() << "Failed to cache LaTeX format:" << cached;
+    }
+}
+
+/**
+ * \brief Checks whether the PDF already reflects the .tex file and its figures.
+ *
+ * The PDF's timestamp is compared too, since the native datasheet backend
+ * writes a PDF of the same name.
+ */
+bool LatexBuilder::isUpToDate() const
+{
+    QFileInfo pdf(workDir + "/" + baseName + ".pdf");
+    return pdf.exists()
+        && pdf.lastModified().toMSecsSinceEpoch() == storedPdfModified
+        && !storedTexHash.isEmpty()
+        && storedTexHash == hashFile(texFilePath)
+        && storedFigures == figureHashes();
+}
+
+/**
+ * \brief Reads the dependency record of the last successful build.
+ *
+ * \return true if a record was read; otherwise the stored hashes are empty
+ *         and everything is rebuilt.
+ */
+bool LatexBuilder::loadState()
+{
+    storedTexHash.clear();
+    storedPreambleKey.clear();
+    storedFigures.clear();
+    storedPdfModified = -1;
+
+    QFile file(workDir + "/" + baseName + ".build.json");
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    storedTexHash = root.value("tex").toString().toLatin1();
+    storedPreambleKey = root.value("preamble").toString().toLatin1();
+    storedPdfModified = qint64(root.value("pdfModified").toDouble(-1));
+
+    const QJsonObject figures = root.value("figures").toObject();
+    for (auto it = figures.begin(); it != figures.end(); ++it)
+        storedFigures.insert(it.key(), it.value().toString().toLatin1());
+
+    return true;
+}
+
+/**
+ * \brief Records the dependencies of a successful build.
+ */
+void LatexBuilder::saveState() const
+{
+    QJsonObject figures;
+    const QMap<QString, QByteArray> currentFigures = figureHashes();
+    for (auto it = currentFigures.constBegin(); it != currentFigures.constEnd(); ++it)
+        figures.insert(it.key(), QString::fromLatin1(it.value()));
+
+    QJsonObject root;
+    root.insert("tex", QString::fromLatin1(hashFile(texFilePath)));
+    root.insert("preamble", QString::fromLatin1(useFormat ? storedPreambleKey : QByteArray()));
+    root.insert("figures", figures);
+    root.insert("pdfModified", double(QFileInfo(workDir + "/" + baseName + ".pdf").lastModified().toMSecsSinceEpoch()));
+
+    QSaveFile file(workDir + "/" + baseName + ".build.json");
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write LaTeX build state for:" << texFilePath;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    file.commit();
+}
+
+/**
+ * \brief Dumps the preamble into <name>-preamble.fmt.
+ *
+ * The LaTeX kernel is loaded from the stock pdflatex format ("&pdflatex"),
+ * then the preamble is read, the marker macro defined and the state dumped.
+ */
+void LatexBuilder::startFormat()
+{
+    QString formatName = baseName + "-preamble";
+
+    QFile source(workDir + "/" + formatName + ".tex");
+    if (!source.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to write preamble source:" << source.fileName();
+        useFormat = false;
+        startPass();
+        return;
+    }
+    QTextStream out(&source);
+    out << preambleText << "\n\\def\\" << preambleMarker << "{}\n\\dump\n";
+    source.close();
+
+    emit stepStarted("Precompiling LaTeX preamble...");
+    start(Step::Format, { "-ini", "-interaction=nonstopmode", "-jobname=" + formatName, "&pdflatex", formatName + ".tex" });
+}
+
+/**
+ * \brief Runs one pdflatex pass over the document.
+ */
+void LatexBuilder::startPass()
+{
+    auxBefore = hashFile(workDir + "/" + baseName + ".aux");
+    ++passes;
+
+    QStringList arguments = { "-interaction=nonstopmode" };
+    if (useFormat)
+        arguments << "-fmt=" + baseName + "-preamble";
+    arguments << QFileInfo(texFilePath).fileName();
+
+    emit stepStarted(QString("Compiling PDF (pass %1)...").arg(passes));
+    start(Step::Document, arguments);
+}
+
+/**
+ * \brief Launches pdflatex in the document's folder.
+ *
+ * \param step      The step being run.
+ * \param arguments Command line arguments.
+ */
+void LatexBuilder::start(Step step, const QStringList& arguments)
+{
+    this->step = step;
+
+    process = new QProcess(this);
+    process->setWorkingDirectory(workDir);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &LatexBuilder::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            qWarning() << "Failed to start pdflatex:" << pdflatexPath;
+            onProcessFinished(-1, QProcess::CrashExit);
+        }
+    });
+
+    process->start(pdflatexPath, arguments);
+}
+
+/**
+ * \brief Handles the end of a pdflatex run and starts the next step, if any.
+ *
+ * \param exitCode   pdflatex exit code.
+ * \param exitStatus Whether it exited normally.
+ *
+ * A failed format dump or a document pass that fails with the format loaded
+ * both fall back to compiling without the format. Another document pass is
+ * run only while cross-references in the .aux file change or the log asks
+ * for a rerun, so a datasheet without references needs a single pass.
+ */
+void LatexBuilder::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!process)
+        return;
+
+    QByteArray output = process->readAll();
+    process->disconnect(this);
+    process->deleteLater();
+    process = nullptr;
+
+    bool ok = exitStatus == QProcess::NormalExit && exitCode == 0;
+
+    if (step == Step::Format) {
+        if (ok && QFile::exists(workDir + "/" + baseName + "-preamble.fmt")) {
+            storedPreambleKey = preambleKey();
+            if (!formatCacheDir.isEmpty())
+                storeCachedFormat();
+        } else {
+            qWarning() << "Precompiling the LaTeX preamble failed, compiling without it";
+            useFormat = false;
+        }
+        startPass();
+        return;
+    }
+
+    ok = ok && QFile::exists(workDir + "/" + baseName + ".pdf");
+
+    if (!ok && useFormat) {
+        qWarning() << "pdflatex failed with the precompiled preamble, retrying without it";
+        QFile::remove(workDir + "/" + baseName + "-preamble.fmt");
+        if (!formatCacheDir.isEmpty())
+            QFile::remove(cachedFormatPath(formatCacheDir, pdflatexPath, preambleText));
+        useFormat = false;
+        passes = 0;
+        startPass();
+        return;
+    }
+
+    if (!ok) {
+        qWarning() << "pdflatex failed for" << texFilePath << "with exit code:" << exitCode;
+        qWarning().noquote() << output.right(2000);
+        finish(false);
+        return;
+    }
+
+    QString auxFilePath = workDir + "/" + baseName + ".aux";
+    bool auxChanged = hashFile(auxFilePath) != auxBefore && auxHasCrossReferences(auxFilePath);
+    if (passes < maxPasses && (auxChanged || rerunRequested())) {
+        startPass();
+        return;
+    }
+
+    finish(true);
+}
+
+/**
+ * \brief Checks the log for LaTeX's own rerun warnings.
+ */
+bool LatexBuilder::rerunRequested() const
+{
+    QFile log(workDir + "/" + baseName + ".log");
+    if (!log.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QByteArray text = log.readAll();
+    return text.contains("Rerun to get") || text.contains("Label(s) may have changed");
+}
+
+/**
+ * \brief Records the build and reports the result.
+ *
+ * \param success Whether the PDF was produced (or already up to date).
+ */
+void LatexBuilder::finish(bool success)
+{
+    if (success && passes > 0)
+        saveState();
+
+    emit finished(success, workDir + "/" + baseName + ".pdf", passes);
+}
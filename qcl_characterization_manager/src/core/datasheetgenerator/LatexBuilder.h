@@ -0,0 +1,100 @@
+/**
+ * @file LatexBuilder.h
+ * @brief Declaration of LatexBuilder, an incremental pdflatex driver.
+ *
+ * Compiles a .tex file with a cached precompiled preamble and runs only the
+ * pdflatex passes that are actually needed.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef LATEXBUILDER_H
+	#define LATEXBUILDER_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QByteArray>
+	#include <QMap>
+	#include <QProcess>
+
+	/**
+	 * @class LatexBuilder
+	 * @brief Builds a PDF from a .tex file with format caching and dependency tracking.
+	 *
+	 * A build goes through up to three steps, each skipped when it is not needed:
+	 * 1. If a preamble is given and its format file is missing or stale, the
+	 *    preamble is dumped into <name>-preamble.fmt with pdflatex -ini.
+	 * 2. If the PDF is missing, or the .tex file or any figure it includes
+	 *    has changed since the last successful build, pdflatex runs once.
+	 * 3. Further passes run only while the .aux file keeps changing or
+	 *    LaTeX asks for a rerun, up to maxPasses().
+	 *
+	 * Hashes of the .tex file, the included figures and the preamble are kept in
+	 * <name>.build.json next to the .tex file. If the format cannot be built or
+	 * loaded, the build falls back to a cold pdflatex run, so the .tex file
+	 * must also compile without the format (DataSheetGenerator guards its
+	 * preamble for this).
+	 *
+	 * With setFormatCacheDir(), a format dumped by one build is copied into a
+	 * shared folder under a name derived from the preamble key, and later
+	 * builds of other documents copy it instead of running pdflatex -ini.
+	 */
+	class LatexBuilder : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			explicit LatexBuilder(const QString& pdflatexPath, QObject *parent = nullptr); ///< Constructor
+
+			void build(const QString& texFilePath, const QString& preamble = QString()); ///< Start an asynchronous build
+			void setMaxPasses(int passes) { maxPasses = qMax(1, passes); } ///< Limit on document passes (default 3)
+			bool isRunning() const { return process != nullptr; } ///< True while pdflatex is running
+			void setFormatCacheDir(const QString& dir) { formatCacheDir = dir; } ///< Share precompiled formats between documents
+			static QString cachedFormatPath(const QString& cacheDir, const QString& pdflatexPath, const QString& preamble); ///< Format file in a cache folder
+			static QString defaultPdflatexPath(); ///< Bundled MiKTeX pdflatex, else pdflatex on the PATH
+
+		signals:
+			void stepStarted(const QString& description); ///< Emitted before every pdflatex run
+			void finished(bool success, const QString& pdfPath, int passes); ///< passes is 0 when the PDF was already up to date
+
+		private:
+			/// What the running pdflatex process is doing.
+			enum class Step { Format, Document };
+
+			static QByteArray hashFile(const QString& filePath); ///< SHA-1 of a file, empty if unreadable
+			QMap<QString, QByteArray> figureHashes() const; ///< Hash of every file named in \includegraphics
+			QByteArray preambleKey() const; ///< Hash of the preamble and the pdflatex executable
+			static QByteArray preambleKey(const QString& preamble, const QString& pdflatexPath); ///< Same, for any preamble
+			void useCachedFormat(); ///< Copy a cached format into the document folder
+			void storeCachedFormat() const; ///< Copy a freshly dumped format into the cache
+			bool isUpToDate() const; ///< PDF exists and no dependency changed
+			bool loadState(); ///< Read <name>.build.json
+			void saveState() const; ///< Write <name>.build.json after a successful build
+
+			void startFormat(); ///< Dump the preamble into a format file
+			void startPass();   ///< Run one document pass
+			void start(Step step, const QStringList& arguments); ///< Launch pdflatex
+			void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus); ///< Decide on the next step
+			bool rerunRequested() const; ///< Check the log for LaTeX rerun warnings
+			void finish(bool success); ///< Report the result
+
+			QString pdflatexPath;   ///< pdflatex executable
+			QString texFilePath;    ///< Document being built
+			QString workDir;        ///< Folder of the .tex file
+			QString baseName;       ///< .tex file name without extension
+			QString preambleText;   ///< Preamble to precompile, empty for none
+			QString formatCacheDir; ///< Folder shared by several builds for formats, empty for none
+			QProcess *process;      ///< Running pdflatex, null when idle
+			Step step;              ///< Step of the running process
+			bool useFormat;         ///< Load the precompiled format in document passes
+			int passes;             ///< Document passes run in this build
+			int maxPasses;          ///< Limit on document passes
+			QByteArray auxBefore;   ///< .aux hash before the current pass
+
+			QByteArray storedTexHash;      ///< .tex hash of the last successful build
+			QByteArray storedPreambleKey;  ///< Preamble key of the cached format
+			QMap<QString, QByteArray> storedFigures; ///< Figure hashes of the last successful build
+			qint64 storedPdfModified;      ///< PDF timestamp (ms) after the last successful build
+	};
+#endif // LATEXBUILDER_H
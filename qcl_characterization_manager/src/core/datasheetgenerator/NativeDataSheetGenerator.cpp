@@ -0,0 +1,474 @@
+/**
+ * \file        NativeDataSheetGenerator.cpp
+ * \brief       Renders the laser datasheet to PDF with QTextDocument and QPdfWriter.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "NativeDataSheetGenerator.h"
+#include "core/graceplots/FitResults.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QDate>
+#include <QUrl>
+#include <QImageReader>
+#include <QPdfWriter>
+#include <QPageLayout>
+#include <QTextDocument>
+#include <QDebug>
+
+namespace
+{
+    /// QTextDocument lays out in 96 dpi units; pages are measured in points.
+    constexpr double layoutDpi = 96.0;
+
+    /// Resolution figures are decoded at for embedding.
+    constexpr double imageDpi = 300.0;
+
+    /// Fraction of the text width used by one or two side-by-side figures.
+    constexpr double singleFigureWidth = 0.7;
+    constexpr double panelFigureWidth = 0.48;
+}
+
+/**
+ * \brief Constructs a NativeDataSheetGenerator instance.
+ * \param pdfPath The path of the PDF to write; figures are read from 'Figures' next to it.
+ * \param params A map of parameters (e.g., author, device name, fit results) used in the datasheet.
+ */
+NativeDataSheetGenerator::NativeDataSheetGenerator(const QString& pdfPath, const QMap<QString, QVariant>& params)
+    : outputPath(pdfPath)
+    , figuresDir(QFileInfo(pdfPath).absolutePath() + "/Figures")
+    , params(params)
+    , figureNumber(0)
+    , textWidth(0.0)
+{
+}
+
+/**
+ * \brief Sets the measurement metadata for pulsed and continuous wave (CW) data.
+ * \param pulsed Metadata key-value pairs for pulsed measurements ("pulsed_" prefix).
+ * \param cw Metadata key-value pairs for CW measurements ("cw_" prefix).
+ */
+void NativeDataSheetGenerator::setMeasurementMetadata(const QMap<QString, QString>& pulsed, const QMap<QString, QString>& cw)
+{
+    pulsedMetadata = pulsed;
+    cwMetadata = cw;
+}
+
+/**
+ * \brief Lays out the datasheet and writes it as an A4 PDF.
+ *
+ * \return true if the PDF was written; errorString() says why not.
+ *
+ * The document is paginated at the writer's paint rectangle (2 cm margins)
+ * and printed page by page; sections are separated by explicit page breaks
+ * like the \c \\clearpage commands of the LaTeX datasheet.
+ */
+bool NativeDataSheetGenerator::generate()
+{
+    QPdfWriter writer(outputPath);
+    writer.setPageLayout(QPageLayout(QPageSize(QPageSize::A4), QPageLayout::Portrait,
+                                     QMarginsF(20, 20, 20, 20), QPageLayout::Millimeter));
+    writer.setResolution(int(imageDpi));
+    writer.setCreator("QCL Characterization Manager");
+    writer.setTitle(QString("Datasheet: device %1 -- %2")
+                        .arg(params.value("Sample Name", "Unnamed Sample").toString(),
+                             params.value("Device Name", "Unnamed Device").toString()));
+
+    QSizeF pageSize = writer.pageLayout().paintRect(QPageLayout::Point).size() * (layoutDpi / 72.0);
+    textWidth = pageSize.width();
+    figureNumber = 0;
+    images.clear();
+    missingImages.clear();
+    error.clear();
+
+    QString graceFiguresDir = QFileInfo(outputPath).absolutePath() + "/GraceFigures";
+    ithFits.clear();
+    for (const QString& prefix : { QString("pulsed"), QString("cw") }) {
+        FitResults results;
+        if (results.load(FitResults::pathFor(graceFiguresDir + "/Ith_vs_T_" + prefix + "_liv.agr")) && results.exponentialFit().valid)
+            ithFits.insert(prefix, results.exponentialFit());
+    }
+
+    QString html = "<html><body style=\"font-family: 'Times New Roman', serif; font-size: 12pt;\">";
+    html += generateTitlePage() + pageBreak();
+    html += generatePerformanceSummary() + pageBreak();
+    html += generateModeSection("pulsed", "Pulsed Characteristics");
+    html += generateModeSection("cw", "CW Characteristics");
+    html += "</body></html>";
+
+    if (!missingImages.isEmpty()) {
+        error = "No print-resolution PNG for: " + missingImages.join(", ")
+                + "\nConvert the figures with the print tier before using the native backend.";
+        qWarning() << "Native datasheet:" << error;
+        return false;
+    }
+
+    QTextDocument document;
+    document.setDocumentMargin(0);
+    document.setPageSize(pageSize);
+    for (auto it = images.constBegin(); it != images.constEnd(); ++it)
+        document.addResource(QTextDocument::ImageResource, QUrl(it.key()), it.value());
+    document.setHtml(html);
+    document.print(&writer);
+
+    if (QFileInfo(outputPath).size() <= 0) {
+        error = "Failed to write " + outputPath;
+        qWarning() << "Failed to write datasheet PDF:" << outputPath;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Generates the title page with device, author and date.
+ */
+QString NativeDataSheetGenerator::generateTitlePage() const
+{
+    QString author = params.value("Author", "Unknown Author").toString();
+    QString date = params.value("Date", QDate::currentDate().toString("dd-MM-yyyy")).toString();
+    QString deviceName = params.value("Device Name", "Unnamed Device").toString();
+    QString sampleName = params.value("Sample Name", "Unnamed Sample").toString();
+    QString title = QString("Datasheet: device %2 -- %1").arg(deviceName, sampleName);
+
+    return QString("<p style=\"margin-top: 150px;\" align=\"center\"><span style=\"font-size: 24pt; font-weight: bold;\">%1</span></p>"
+                   "<p align=\"center\"><i style=\"font-size: 10pt;\">Characterised by: %2</i></p>"
+                   "<p align=\"center\" style=\"font-size: 14pt;\">%3</p>")
+        .arg(title.toHtmlEscaped(), author.toHtmlEscaped(), date.toHtmlEscaped());
+}
+
+/**
+ * \brief Generates the performance summary table.
+ *
+ * Same rows as DataSheetGenerator::generatePerformanceSummary(); rows whose
+ * value is missing are left out.
+ */
+QString NativeDataSheetGenerator::generatePerformanceSummary() const
+{
+    auto param = [&](const QString& key) -> QString {
+        return params.value(key).toString().trimmed().toHtmlEscaped();
+    };
+
+    QVariantMap dimensions = params.value("Dimensions").toMap();
+    QString ridgeDimensions = QString("%1 mm &times; %2 &micro;m &times; %3 &micro;m")
+                                  .arg(dimensions.value("length").toDouble())
+                                  .arg(dimensions.value("width").toDouble())
+                                  .arg(dimensions.value("height").toDouble());
+
+    QString pulsedDuty = metadata("pulsed", "duty_cycle_liv", "5");
+
+    QList<QPair<QString, QString>> rows;
+    rows.append({ "Characterised by:", param("Author").isEmpty() ? "Unknown Author" : param("Author") });
+    rows.append({ "Date of completion:", param("Date").isEmpty() ? QDate::currentDate().toString("dd-MM-yyyy") : param("Date") });
+    rows.append({ "Ridge dimensions:", ridgeDimensions });
+
+    for (const QString& prefix : { QString("pulsed"), QString("cw") }) {
+        QString mode = prefix == "pulsed" ? "pulsed" : "c.w.";
+
+        if (ithFits.contains(prefix))
+            rows.append({ QString("Threshold current density (%1):").arg(mode),
+                          QString::number(ithFits.value(prefix).JC0, 'f', 1) + " A/cm<sup>2</sup> (20 K)" });
+
+        QString power = metadata(prefix, "power_scale_liv");
+        if (power != "N/A") {
+            QString conditions = prefix == "pulsed" ? pulsedDuty + "% d.c., 20 K" : "20 K";
+            rows.append({ QString("Peak output power (%1):").arg(mode), QString("%1 mW (%2)").arg(power, conditions) });
+        }
+
+        QString freqRange = param(prefix + "_ftir_fixed_temp_freq_range");
+        if (!freqRange.isEmpty())
+            rows.append({ QString("Emission frequency range (%1):").arg(mode), freqRange });
+
+        QString tmax = metadata(prefix, "tmax_liv");
+        if (tmax != "N/A") {
+            QString conditions = prefix == "pulsed" ? QString(" (%1% d.c.)").arg(pulsedDuty) : QString();
+            rows.append({ QString("Maximum operating temperature (%1):").arg(mode), tmax + " K" + conditions });
+        }
+    }
+
+    return "<h2>Performance Summary</h2>" + generateTable(rows);
+}
+
+/**
+ * \brief Generates the pulsed or CW section.
+ *
+ * \param prefix "pulsed" or "cw".
+ * \param title  Section heading.
+ * \return The section, or an empty string if it has no figures.
+ */
+QString NativeDataSheetGenerator::generateModeSection(const QString& prefix, const QString& title)
+{
+    QString liv = generateLIVSubsection(prefix);
+    QString spectra = generateSpectraSubsection(prefix);
+
+    if (liv.isEmpty() && spectra.isEmpty())
+        return "";
+
+    return "<h2>" + title.toHtmlEscaped() + "</h2>" + liv + spectra;
+}
+
+/**
+ * \brief Generates the L-I-V subsection: setup table, LIV and Ith figures and notes.
+ *
+ * \param prefix "pulsed" or "cw".
+ */
+QString NativeDataSheetGenerator::generateLIVSubsection(const QString& prefix)
+{
+    QString livName = prefix + "_liv";
+    QString ithName = "Ith_vs_T_" + prefix + "_liv";
+    bool hasLIV = hasFigure(livName);
+    bool hasIth = hasFigure(ithName);
+
+    if (!hasLIV && !hasIth)
+        return "";
+
+    bool pulsed = prefix == "pulsed";
+
+    QList<QPair<QString, QString>> rows = {
+        { "Cryostat:", metadata(prefix, "cryostat_liv") },
+        { "Detector:", metadata(prefix, "detector_liv") },
+        { "Power Supply:", metadata(prefix, "ps_liv") }
+    };
+    if (pulsed) {
+        rows.append({ "Drive Frequency:", metadata(prefix, "drive_freq_liv", "10") + " kHz" });
+        rows.append({ "Duty Cycle:", metadata(prefix, "duty_cycle_liv", "5") });
+        rows.append({ "Gate Frequency:", metadata(prefix, "gate_freq_liv", "167") + " Hz" });
+    }
+    rows.append({ "Power Scale:", metadata(prefix, "power_scale_liv", "100") + " mW" });
+    QString maxTemp = metadata(prefix, "tmax_liv");
+    if (maxTemp != "N/A")
+        rows.append({ "Max Temperature:", maxTemp + " K" });
+
+    QString livCaption = pulsed
+        ? QString("Pulsed L-I-V characteristics driven by %1 kHz, %2% duty cycle pulses gated by a %3 Hz square-wave.")
+              .arg(metadata(prefix, "drive_freq_liv", "10"), metadata(prefix, "duty_cycle_liv", "5"), metadata(prefix, "gate_freq_liv", "167"))
+        : QString("CW L-I-V characteristics.");
+
+    QString ith = ithFormula(prefix, false);
+    QString ithCaption = ith.isEmpty()
+        ? QString("Threshold current vs. temperature.")
+        : QString("Threshold current vs. temperature, fitted to <i>I</i><sub>th</sub>(<i>T</i>) = %1, "
+                  "corresponding to current density <i>J</i><sub>th</sub>(<i>T</i>) = %2.").arg(ith, ithFormula(prefix, true));
+
+    QString modeName = pulsed ? "Pulsed" : "CW";
+    QString result = "<h3>L-I-V Characteristics</h3>" + generateTable(rows);
+
+    if (hasLIV && hasIth)
+        result += generateFigure({ { livName, modeName + " LIV characteristics" }, { ithName, modeName + " threshold current" } },
+                                 livCaption + " (b) " + ithCaption);
+    else if (hasLIV)
+        result += generateFigure({ { livName, QString() } }, livCaption);
+    else
+        result += generateFigure({ { ithName, QString() } }, ithCaption);
+
+    result += generateExperimentalNotes(metadata(prefix, "liv_experimental_notes", QString()));
+    return result + pageBreak();
+}
+
+/**
+ * \brief Generates the spectra subsection: setup table, FTIR figures and notes.
+ *
+ * \param prefix "pulsed" or "cw".
+ */
+QString NativeDataSheetGenerator::generateSpectraSubsection(const QString& prefix)
+{
+    QString vsIName = prefix + "_ftir_vs_I";
+    QString vsTName = prefix + "_ftir_vs_T";
+    bool hasVsI = hasFigure(vsIName);
+    bool hasVsT = hasFigure(vsTName);
+
+    if (!hasVsI && !hasVsT)
+        return "";
+
+    bool pulsed = prefix == "pulsed";
+
+    QList<QPair<QString, QString>> rows = {
+        { "Cryostat:", metadata(prefix, "cryostat_spectra") },
+        { "Detector:", metadata(prefix, "detector_spectra") },
+        { "Spectrometer:", metadata(prefix, "spectrometer_spectra") },
+        { "Power Supply:", metadata(prefix, "ps_spectra") }
+    };
+    if (pulsed) {
+        rows.append({ "Drive Frequency:", metadata(prefix, "drive_freq_spectra", "10") + " kHz" });
+        rows.append({ "Duty Cycle:", metadata(prefix, "duty_cycle_spectra", "5") });
+        rows.append({ "Gate Frequency:", metadata(prefix, "gate_freq_spectra", "167") + " Hz" });
+    }
+
+    QString tfix = metadata(prefix, "tfix_spectra", "20");
+    QString ifix = metadata(prefix, "ifix_spectra", QString());
+
+    QString mainCaption = pulsed
+        ? QString("Pulsed FTIR emission spectra driven by %1 kHz, %2% duty cycle pulses gated by a %3 Hz square-wave.")
+              .arg(metadata(prefix, "drive_freq_spectra", "10"), metadata(prefix, "duty_cycle_spectra", "5"), metadata(prefix, "gate_freq_spectra", "167"))
+        : QString("CW FTIR emission spectra.");
+    QString vsICaption = QString("Spectra at different currents (at T = %1 K).").arg(tfix);
+    QString vsTCaption = ifix.isEmpty()
+        ? QString("Spectra at different temperatures.")
+        : QString("Spectra at different temperatures (at I = %1 mA).").arg(ifix);
+
+    QString result = "<h3>Spectra Characteristics</h3>" + generateTable(rows);
+
+    if (hasVsI && hasVsT)
+        result += generateFigure({ { vsIName, vsICaption }, { vsTName, vsTCaption } }, mainCaption);
+    else if (hasVsI)
+        result += generateFigure({ { vsIName, QString() } }, mainCaption + " " + vsICaption);
+    else
+        result += generateFigure({ { vsTName, QString() } }, mainCaption + " " + vsTCaption);
+
+    QString notesT = metadata(prefix, "spectra_t_experimental_notes", QString());
+    QString notesI = metadata(prefix, "spectra_i_experimental_notes", QString());
+    QString combinedNotes;
+    if (!notesT.isEmpty() && !notesI.isEmpty())
+        combinedNotes = "a) " + notesT + "<br><br>b) " + notesI;
+    else
+        combinedNotes = notesT.isEmpty() ? notesI : notesT;
+
+    result += generateExperimentalNotes(combinedNotes);
+    return result + pageBreak();
+}
+
+/**
+ * \brief Generates a bordered two-column table with bold labels.
+ *
+ * \param rows Label/value pairs; values are already HTML.
+ */
+QString NativeDataSheetGenerator::generateTable(const QList<QPair<QString, QString>>& rows) const
+{
+    QString table = "<table width=\"100%\" border=\"1\" cellspacing=\"0\" cellpadding=\"4\" style=\"border-collapse: collapse;\">";
+    for (const auto& row : rows)
+        table += QString("<tr><td width=\"45%\"><b>%1</b></td><td>%2</td></tr>").arg(row.first.toHtmlEscaped(), row.second);
+    return table + "</table><p></p>";
+}
+
+/**
+ * \brief Generates a figure block with one image, or two side by side.
+ *
+ * \param panels  Figure base names with their sub-captions (ignored for a single image).
+ * \param caption Main caption; escaped HTML.
+ *
+ * Images are decoded at 300 dpi for their printed size and registered as
+ * document resources under "figure://<name>".
+ */
+QString NativeDataSheetGenerator::generateFigure(const QList<FigurePanel>& panels, const QString& caption)
+{
+    double width = textWidth * (panels.size() > 1 ? panelFigureWidth : singleFigureWidth);
+
+    QString cells;
+    char label = 'a';
+    for (const FigurePanel& panel : panels) {
+        QString imagePath = figureImagePath(panel.first);
+        if (!QFileInfo::exists(imagePath)) {
+            missingImages.append(panel.first);
+            continue;
+        }
+
+        QImageReader reader(imagePath);
+        QSize sourceSize = reader.size();
+        if (!sourceSize.isValid() || sourceSize.isEmpty())
+            continue;
+
+        double height = width * sourceSize.height() / sourceSize.width();
+        double scale = imageDpi / layoutDpi;
+        reader.setScaledSize(QSize(qRound(width * scale), qRound(height * scale)));
+
+        QString resource = "figure://" + panel.first;
+        images.insert(resource, reader.read());
+
+        cells += QString("<td align=\"center\"><img src=\"%1\" width=\"%2\" height=\"%3\">")
+                     .arg(resource).arg(qRound(width)).arg(qRound(height));
+        if (panels.size() > 1)
+            cells += QString("<br><small>(%1) %2</small>").arg(QChar(label++)).arg(panel.second.toHtmlEscaped());
+        cells += "</td>";
+    }
+
+    if (cells.isEmpty())
+        return "";
+
+    return QString("<table width=\"100%\" cellspacing=\"0\" cellpadding=\"2\" align=\"center\"><tr>%1</tr></table>"
+                   "<p align=\"center\"><small><b>Figure %2:</b> %3</small></p>")
+        .arg(cells).arg(++figureNumber).arg(caption);
+}
+
+/**
+ * \brief Generates the experimental notes block, or nothing if the notes are empty.
+ *
+ * \param notes Escaped HTML notes.
+ */
+QString NativeDataSheetGenerator::generateExperimentalNotes(const QString& notes) const
+{
+    if (notes.trimmed().isEmpty())
+        return "";
+
+    return "<h4>Experimental Notes</h4><p>" + notes + "</p>";
+}
+
+/**
+ * \brief Returns the print-tier PNG of a figure.
+ *
+ * \param baseName Figure name without extension, e.g. "pulsed_liv".
+ * \return Figures/<baseName>.png, whether or not it exists. The preview and
+ *         thumbnail tiers are never used: decoded at 300 dpi they would
+ *         print blurred.
+ */
+QString NativeDataSheetGenerator::figureImagePath(const QString& baseName) const
+{
+    return figuresDir + "/" + baseName + ".png";
+}
+
+/**
+ * \brief Checks whether a figure was produced, in any output.
+ *
+ * \param baseName Figure name without extension.
+ * \return true if its PDF or print-tier PNG exists; a figure that exists
+ *         without its PNG is reported by generate().
+ */
+bool NativeDataSheetGenerator::hasFigure(const QString& baseName) const
+{
+    return QFileInfo::exists(figuresDir + "/" + baseName + ".pdf") || QFileInfo::exists(figureImagePath(baseName));
+}
+
+/**
+ * \brief Formats the threshold fit saved next to the Ith Grace figure.
+ *
+ * \param prefix  "pulsed" or "cw".
+ * \param density true for Jth(T) in A/cm^2, false for Ith(T).
+ * \return e.g. "12.3 + 4.5 exp(T / 56.7) mA", or an empty string if no fit was saved.
+ *
+ * Ith uses the same unit (A or mA) as the plot.
+ */
+QString NativeDataSheetGenerator::ithFormula(const QString& prefix, bool density) const
+{
+    auto it = ithFits.constFind(prefix);
+    if (it == ithFits.constEnd())
+        return QString();
+
+    double scale = (!density && it->milliamps) ? 1000.0 : 1.0;
+    double A = density ? it->JA : it->A * scale;
+    double C0 = density ? it->JC0 : it->C0 * scale;
+    QString unit = density ? "A/cm<sup>2</sup>" : (it->milliamps ? "mA" : "A");
+
+    return QString("%1 + %2 exp(<i>T</i> / %3) %4")
+        .arg(C0, 0, 'f', 1).arg(A, 0, 'f', 1).arg(it->T0, 0, 'f', 1).arg(unit);
+}
+
+/**
+ * \brief Looks up a measurement metadata value.
+ *
+ * \param prefix "pulsed" or "cw".
+ * \param key    Key without prefix, e.g. "cryostat_liv".
+ * \param def    Value used when the key is missing or empty.
+ * \return The HTML-escaped value.
+ */
+QString NativeDataSheetGenerator::metadata(const QString& prefix, const QString& key, const QString& def) const
+{
+    const QMap<QString, QString>& source = prefix == "pulsed" ? pulsedMetadata : cwMetadata;
+    QString value = source.value(prefix + "_" + key).trimmed();
+    return value.isEmpty() ? def : value.toHtmlEscaped();
+}
+
+/**
+ * \brief Returns an empty block that starts a new page.
+ */
+QString NativeDataSheetGenerator::pageBreak()
+{
+    return "<p style=\"page-break-after: always;\"></p>";
+}
@@ -0,0 +1,82 @@
+/**
+ * @file NativeDataSheetGenerator.h
+ * @brief Declaration of NativeDataSheetGenerator, a TeX-free datasheet backend.
+ *
+ * Lays out the same datasheet as DataSheetGenerator with QTextDocument and
+ * writes it straight to PDF with QPdfWriter, without pdflatex.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#ifndef NATIVEDATASHEETGENERATOR_H
+	#define NATIVEDATASHEETGENERATOR_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QMap>
+	#include <QVariant>
+	#include <QList>
+	#include <QPair>
+	#include <QImage>
+	#include "core/graceplots/FitResults.h"
+
+	class QTextDocument;
+
+	/**
+	 * @class NativeDataSheetGenerator
+	 * @brief Renders the datasheet to PDF in-process.
+	 *
+	 * Sections mirror the LaTeX datasheet: title page, performance summary,
+	 * pulsed and CW L-I-V and spectra subsections with their setup tables,
+	 * figure blocks and experimental notes. Figures are embedded from the
+	 * print-tier PNGs FileConverter or QtPlotExporter wrote next to the
+	 * figure PDFs, so the figures must have been converted with
+	 * FileConverter::PrintTier; a figure with only a PDF or a low-DPI tier
+	 * fails generate() rather than printing upsampled. Threshold fit formulas
+	 * come from the FitResults sidecars next to the Grace figures.
+	 *
+	 * Typical run time is well under a second. The LaTeX backend remains the
+	 * choice for publication-quality output with vector figures.
+	 */
+	class NativeDataSheetGenerator
+	{
+		public:
+			NativeDataSheetGenerator(const QString& pdfPath, const QMap<QString, QVariant>& params); ///< Constructor
+
+			void setMeasurementMetadata(const QMap<QString, QString>& pulsed,
+										const QMap<QString, QString>& cw); ///< Set measurement metadata
+			bool generate(); ///< Write the PDF, returns false on failure
+			QString errorString() const { return error; } ///< Why generate() failed
+
+		private:
+			/// A figure to embed: image path and its sub-caption.
+			using FigurePanel = QPair<QString, QString>;
+
+			QString outputPath;  ///< Output PDF path
+			QString figuresDir;  ///< 'Figures' directory next to the PDF
+			QMap<QString, QVariant> params; ///< Collected data
+			QMap<QString, QString> pulsedMetadata; ///< Pulsed measurement metadata
+			QMap<QString, QString> cwMetadata;     ///< CW measurement metadata
+			QMap<QString, QImage> images; ///< Images added to the document, by resource name
+			int figureNumber;             ///< Running figure counter
+			double textWidth;             ///< Layout width of the page body
+			QMap<QString, FitResults::ExponentialFit> ithFits; ///< Threshold fits by mode ("pulsed", "cw")
+			QStringList missingImages;    ///< Figures without a print-tier PNG
+			QString error;                ///< Reason of the last failure
+
+			QString generateTitlePage() const; ///< Title, author and date
+			QString generatePerformanceSummary() const; ///< Summary table
+			QString generateModeSection(const QString& prefix, const QString& title); ///< Pulsed or CW section
+			QString generateLIVSubsection(const QString& prefix); ///< L-I-V table, figures and notes
+			QString generateSpectraSubsection(const QString& prefix); ///< Spectra table, figures and notes
+			QString generateTable(const QList<QPair<QString, QString>>& rows) const; ///< Two-column bordered table
+			QString generateFigure(const QList<FigurePanel>& panels, const QString& caption); ///< One or two images with caption
+			QString generateExperimentalNotes(const QString& notes) const; ///< Notes block
+
+			QString figureImagePath(const QString& baseName) const; ///< Print-tier PNG of a figure
+			bool hasFigure(const QString& baseName) const; ///< Figure PDF or PNG exists
+			QString ithFormula(const QString& prefix, bool density) const; ///< Fitted Ith(T) or Jth(T) expression
+			QString metadata(const QString& prefix, const QString& key, const QString& def = "N/A") const; ///< Escaped metadata value
+			static QString pageBreak(); ///< HTML forcing a new page
+	};
+#endif // NATIVEDATASHEETGENERATOR_H
@@ -0,0 +1,20 @@
+SOURCES += \
+    $$PWD/DataSheetGenerator.cpp \
+    $$PWD/DataSheetTemplate.cpp \
+    $$PWD/LatexBuilder.cpp
+
+HEADERS += \
+    $$PWD/DataSheetGenerator.h \
+    $$PWD/DataSheetTemplate.h \
+    $$PWD/LatexBuilder.h
+
+# The native backend paints with QPdfWriter, so it is left out of QtCore-only builds
+contains(QT, gui) {
+    SOURCES += \
+        $$PWD/NativeDataSheetGenerator.cpp \
+        $$PWD/BatchDataSheetRunner.cpp
+
+    HEADERS += \
+        $$PWD/NativeDataSheetGenerator.h \
+        $$PWD/BatchDataSheetRunner.h
+}
@@ -0,0 +1,271 @@
+/**
+ * \file        ConversionManifest.cpp
+ * \brief       JSON manifest of converted figures used to skip up-to-date conversions.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QDebug>
+#include "ConversionManifest.h"
+
+namespace
+{
+    /// Bumped when the JSON layout changes; older manifests are ignored.
+    constexpr int manifestVersion = 1;
+
+    /// Modification time used to detect outputs replaced behind our back.
+    qint64 modificationTime(const QString& filePath)
+    {
+        QFileInfo info(filePath);
+        return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    }
+}
+
+/**
+ * \brief   Constructs a manifest bound to a JSON file.
+ * \param   manifestFilePath - Path of the manifest, usually from pathFor().
+ */
+ConversionManifest::ConversionManifest(const QString& manifestFilePath)
+    : filePath(manifestFilePath)
+{
+}
+
+/**
+ * \brief Returns the manifest location for a data directory.
+ *
+ * \param baseDirPath The folder containing 'GraceFigures' and 'Figures'.
+ * \return <baseDirPath>/FiguresManifest.json
+ */
+QString ConversionManifest::pathFor(const QString& baseDirPath)
+{
+    return QDir(baseDirPath).absoluteFilePath("FiguresManifest.json");
+}
+
+/**
+ * \brief Hashes a file's content.
+ *
+ * \param filePath The file to hash.
+ * \return The hex SHA-1 digest, or an empty array if the file cannot be read.
+ *
+ * The content is hashed rather than the timestamp because the Grace page
+ * rewrites every .agr file on each run; unchanged data gives identical files.
+ */
+QByteArray ConversionManifest::hashFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QByteArray();
+    return hash.result().toHex();
+}
+
+/**
+ * \brief Reads the manifest from disk.
+ *
+ * \return true if a valid manifest was read. A missing, corrupt or
+ *         incompatible file leaves the manifest empty, so every figure is
+ *         converted again.
+ */
+bool ConversionManifest::load()
+{
+    entries.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    QJsonObject root = document.object();
+    if (root.value("version").toInt() != manifestVersion) {
+        qWarning() << "Ignoring incompatible conversion manifest:" << filePath;
+        return false;
+    }
+
+    const QJsonObject figures = root.value("figures").toObject();
+    for (auto it = figures.begin(); it != figures.end(); ++it) {
+        QJsonObject object = it.value().toObject();
+
+        Entry entry;
+        entry.hash = object.value("sha1").toString().toLatin1();
+        entry.settings = object.value("settings").toString();
+        entry.converted = object.value("converted").toString();
+
+        const QJsonArray outputs = object.value("outputs").toArray();
+        for (const QJsonValue& output : outputs) {
+            QJsonObject outputObject = output.toObject();
+            entry.outputs.insert(outputObject.value("path").toString(),
+                                 qint64(outputObject.value("modified").toDouble()));
+        }
+
+        entries.insert(it.key(), entry);
+    }
+
+    return true;
+}
+
+/**
+ * \brief Writes the manifest to disk.
+ *
+ * \return true on success.
+ *
+ * QSaveFile writes to a temporary file and renames it over the old manifest,
+ * so an interrupted write never leaves a truncated manifest behind.
+ */
+bool ConversionManifest::save() const
+{
+    QJsonObject figures;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        QJsonArray outputs;
+        for (auto output = it->outputs.constBegin(); output != it->outputs.constEnd(); ++output) {
+            QJsonObject outputObject;
+            outputObject.insert("path", output.key());
+            outputObject.insert("modified", double(output.value()));
+            outputs.append(outputObject);
+        }
+
+        QJsonObject object;
+        object.insert("sha1", QString::fromLatin1(it->hash));
+        object.insert("settings", it->settings);
+        object.insert("converted", it->converted);
+        object.insert("outputs", outputs);
+        figures.insert(it.key(), object);
+    }
+
+    QJsonObject root;
+    root.insert("version", manifestVersion);
+    root.insert("figures", figures);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write conversion manifest:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+/**
+ * \brief Checks whether a figure can be skipped.
+ *
+ * \param sourcePath The .agr file.
+ * \param hash       Its current content hash.
+ * \param settings   Description of the requested outputs and resolutions.
+ * \param outputs    The output files the conversion would write.
+ * \return true if the entry matches and every output is still as written.
+ */
+bool ConversionManifest::isUpToDate(const QString& sourcePath, const QByteArray& hash, const QString& settings, const QStringList& outputs) const
+{
+    auto it = entries.constFind(relativePath(sourcePath));
+    if (it == entries.constEnd() || hash.isEmpty() || it->hash != hash || it->settings != settings)
+        return false;
+
+    for (const QString& output : outputs) {
+        auto recorded = it->outputs.constFind(relativePath(output));
+        if (recorded == it->outputs.constEnd() || modificationTime(output) != recorded.value())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Records a successful conversion.
+ *
+ * \param sourcePath The converted .agr file.
+ * \param hash       Its content hash at conversion time.
+ * \param settings   Description of the outputs and resolutions used.
+ * \param outputs    The files that were written.
+ *
+ * Outputs recorded by a previous conversion of the same source that are not
+ * part of this one (e.g. after a tier was switched off) are deleted.
+ */
+void ConversionManifest::record(const QString& sourcePath, const QByteArray& hash, const QString& settings, const QStringList& outputs)
+{
+    QString key = relativePath(sourcePath);
+
+    Entry entry;
+    entry.hash = hash;
+    entry.settings = settings;
+    entry.converted = QDateTime::currentDateTime().toString(Qt::ISODate);
+    for (const QString& output : outputs)
+        entry.outputs.insert(relativePath(output), modificationTime(output));
+
+    auto previous = entries.constFind(key);
+    if (previous != entries.constEnd()) {
+        for (auto it = previous->outputs.constBegin(); it != previous->outputs.constEnd(); ++it) {
+            if (!entry.outputs.contains(it.key()))
+                QFile::remove(absolutePath(it.key()));
+        }
+    }
+
+    entries.insert(key, entry);
+}
+
+/**
+ * \brief Forgets a figure, e.g. after a failed conversion.
+ *
+ * \param sourcePath The .agr file.
+ */
+void ConversionManifest::remove(const QString& sourcePath)
+{
+    entries.remove(relativePath(sourcePath));
+}
+
+/**
+ * \brief Deletes the outputs of figures whose source has disappeared.
+ *
+ * \param existingSources The .agr files present in this run.
+ * \return The output files that were deleted.
+ *
+ * Entries are dropped only when their source is neither in
+ * \p existingSources nor on disk, so converting a subset of a directory
+ * never discards the rest.
+ */
+QStringList ConversionManifest::removeOrphans(const QStringList& existingSources)
+{
+    QStringList keep;
+    for (const QString& source : existingSources)
+        keep.append(relativePath(source));
+
+    QStringList removed;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (keep.contains(it.key()) || QFile::exists(absolutePath(it.key()))) {
+            ++it;
+            continue;
+        }
+
+        for (auto output = it->outputs.constBegin(); output != it->outputs.constEnd(); ++output) {
+            QString outputPath = absolutePath(output.key());
+            if (QFile::remove(outputPath))
+                removed.append(outputPath);
+        }
+        it = entries.erase(it);
+    }
+    return removed;
+}
+
+/**
+ * \brief Expresses a path relative to the folder holding the manifest.
+ */
+QString ConversionManifest::relativePath(const QString& path) const
+{
+    return QFileInfo(filePath).absoluteDir().relativeFilePath(QFileInfo(path).absoluteFilePath());
+}
+
+/**
+ * \brief Resolves a manifest-relative path.
+ */
+QString ConversionManifest::absolutePath(const QString& relative) const
+{
+    return QDir::cleanPath(QFileInfo(filePath).absoluteDir().absoluteFilePath(relative));
+}
@@ -0,0 +1,67 @@
+/**
+ * @file ConversionManifest.h
+ * @brief Declaration of ConversionManifest, the record of which figures are up to date.
+ *
+ * The manifest lives next to the 'Figures' folder and maps every converted
+ * .agr file to the hash it was converted from and the outputs it produced.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef CONVERSIONMANIFEST_H
+	#define CONVERSIONMANIFEST_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QByteArray>
+	#include <QMap>
+
+	/**
+	 * @class ConversionManifest
+	 * @brief Persistent map of source hash -> output files for incremental conversion.
+	 *
+	 * Stored as JSON in <dir>/FiguresManifest.json, where <dir> is the folder
+	 * holding both 'GraceFigures' and 'Figures'. Paths are kept relative to
+	 * that folder so a data directory can be moved or copied without
+	 * invalidating its figures.
+	 *
+	 * A figure is up to date when its .agr content hash and conversion
+	 * settings match the entry and every recorded output still exists with
+	 * the modification time it had when it was written. Any other change,
+	 * including an output replaced by hand or by another backend, makes the
+	 * figure convert again.
+	 */
+	class ConversionManifest
+	{
+		public:
+			explicit ConversionManifest(const QString& manifestFilePath = QString()); ///< Constructor, does not read the file
+
+			static QString pathFor(const QString& baseDirPath); ///< Manifest location for a data directory
+			static QByteArray hashFile(const QString& filePath); ///< SHA-1 of a file's content, empty on error
+
+			bool load();  ///< Read the manifest; a missing or unreadable file gives an empty manifest
+			bool save() const; ///< Atomically write the manifest
+
+			bool isUpToDate(const QString& sourcePath, const QByteArray& hash, const QString& settings, const QStringList& outputs) const; ///< True if the recorded outputs can be reused
+			void record(const QString& sourcePath, const QByteArray& hash, const QString& settings, const QStringList& outputs); ///< Store a successful conversion, removing outputs it no longer produces
+			void remove(const QString& sourcePath); ///< Forget a figure (outputs are kept)
+			QStringList removeOrphans(const QStringList& existingSources); ///< Delete outputs of sources that no longer exist
+
+		private:
+			/// One converted source file.
+			struct Entry
+			{
+				QByteArray hash;          ///< SHA-1 of the .agr content (hex)
+				QString settings;         ///< Output profiles and resolutions used
+				QString converted;        ///< ISO timestamp of the conversion
+				QMap<QString, qint64> outputs; ///< Output path -> modification time (ms since epoch)
+			};
+
+			QString relativePath(const QString& filePath) const; ///< Path relative to the manifest folder
+			QString absolutePath(const QString& relative) const; ///< Path resolved against the manifest folder
+
+			QString filePath;              ///< Manifest JSON file
+			QMap<QString, Entry> entries;  ///< Relative source path -> entry
+	};
+#endif // CONVERSIONMANIFEST_H
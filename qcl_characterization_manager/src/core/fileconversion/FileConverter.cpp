@@ -4,70 +4,372 @@
  * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
  */
 
-#include <QtConcurrent>
 #include <QFile>
 #include <QDir>
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <QDebug>
 #include <QProcess>
-#include <QImage>
-#include <QTransform>
+#include <QThread>
+#include <QTimer>
+#include <QStandardPaths>
 #include "FileConverter.h"
+#include "GhostscriptWorker.h"
+
+#ifdef QCL_WITH_GRACE_LIBRARY
+    #include <QFutureWatcher>
+    #include <QtConcurrent>
+    #include "gracerender.h"
+#endif
+
+namespace
+{
+    /// Maximum time a single external process stage may run before it is killed.
+    constexpr int stageTimeoutMs = 60000;
+
+    /// Supersampling factor used by Ghostscript's downscaler for low-DPI tiers.
+    constexpr int downScaleFactor = 3;
+
+    /// Quotes a file path as a PostScript string literal.
+    QString postScriptString(const QString& text)
+    {
+        QString escaped = text;
+        escaped.replace("\\", "\\\\").replace("(", "\\(").replace(")", "\\)");
+        return "(" + escaped + ")";
+    }
+
+    /// Ghostscript path prefix granting access to everything inside a directory.
+    QString directoryPrefix(const QString& dirPath)
+    {
+        return QDir::cleanPath(QDir(dirPath).absolutePath()) + "/";
+    }
+}
 
 /**
  * \brief   Constructs a FileConverter object.
  * \param   parent - Optional parent QObject.
+ *
+ * The pool size defaults to QThread::idealThreadCount(), i.e. one conversion
+ * job per core. By default the PDF and the 600 dpi print PNG are produced;
+ * the thumbnail and preview tiers default to 24 and 96 dpi.
  */
 FileConverter::FileConverter(QObject *parent)
     : QObject(parent)
-{}
+    , nextRenderId(0)
+    , maxJobs(qMax(1, QThread::idealThreadCount()))
+    , totalJobs(0)
+    , completedJobs(0)
+    , cancelRequested(false)
+    , outputProfiles(PdfOutput | PrintTier)
+    , incremental(true)
+{
+    for (OutputProfile tier : { ThumbnailTier, PreviewTier, PrintTier })
+        tierDpi[tier] = defaultTierResolution(tier);
+}
+
+/**
+ * \brief   Destroys the converter, killing any process that is still running.
+ *
+ * Processes and workers are disconnected first so that their signals do not
+ * call back into a half-destroyed object.
+ */
+FileConverter::~FileConverter()
+{
+    for (GhostscriptWorker *worker : workers)
+        worker->disconnect(this);
+
+    pendingJobs.clear();
+    renderingJobs.clear();
+    const QList<QProcess*> processes = runningJobs.keys();
+    runningJobs.clear();
+    for (QProcess *process : processes) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        delete process;
+    }
+}
+
+/**
+ * \brief Returns the path of the bundled qtgrace executable.
+ *
+ * Without the bundled copy (e.g. the command-line tool on Linux) qtgrace,
+ * or else Grace's batch binary gracebat, is looked up on the PATH.
+ */
+QString FileConverter::graceExecutable()
+{
+    QString bundled = QCoreApplication::applicationDirPath() + "/XMGrace/bin/qtgrace.exe";
+    if (QFile::exists(bundled))
+        return bundled;
+
+    for (const QString& name : { QString("qtgrace"), QString("gracebat") }) {
+        QString onPath = QStandardPaths::findExecutable(name);
+        if (!onPath.isEmpty())
+            return onPath;
+    }
+    return bundled;
+}
+
+/**
+ * \brief Returns the path of the bundled Ghostscript executable.
+ *
+ * Without the bundled copy, gs is looked up on the PATH.
+ */
+QString FileConverter::ghostscriptExecutable()
+{
+    QString bundled = QCoreApplication::applicationDirPath() + "/Ghostscript/App/bin/gswin64c.exe";
+    if (QFile::exists(bundled))
+        return bundled;
+
+    QString onPath = QStandardPaths::findExecutable("gs");
+    return onPath.isEmpty() ? bundled : onPath;
+}
+
+/**
+ * \brief Builds the command line arguments for the current stage of a job.
+ *
+ * \param job The conversion job.
+ * \return The argument list for qtgrace (PostScript stage) or Ghostscript (render stage).
+ *
+ * The render stage is a single Ghostscript invocation for all requested outputs.
+ * The PDF, if requested, is written by the initial pdfwrite device; every raster
+ * tier then switches the device with setpagedevice and renders straight from the
+ * PostScript, instead of re-interpreting the generated PDF in a second process.
+ * Low-DPI tiers are rendered supersampled and reduced with Ghostscript's
+ * DownScaleFactor so that small images stay legible.
+ *
+ * Ghostscript 9.50 and later run in SAFER mode, where setpagedevice may only
+ * open files that were permitted on the command line; see permitArguments().
+ */
+QStringList FileConverter::stageArguments(const ConversionJob& job)
+{
+    if (job.stage == Stage::PostScript) {
+        return {
+            "-nosafe",
+            "-hdevice", "PostScript",
+            "-noask",
+            "-hardcopy",
+            "-printfile", job.psFilePath,
+            job.agrFilePath
+        };
+    }
+
+    QStringList arguments = { "-dNOPAUSE", "-dBATCH" };
+    arguments << permitArguments(job);
+
+    int first = 0;
+    if (!job.outputs.isEmpty() && job.outputs.first().profile == PdfOutput) {
+        arguments << "-sDEVICE=pdfwrite" << "-sOutputFile=" + job.outputs.first().tempPath << job.psFilePath;
+        first = 1;
+    } else {
+        arguments << "-sDEVICE=nullpage";
+    }
+
+    for (int i = first; i < job.outputs.size(); ++i)
+        arguments << "-c" << pageDevice(job.outputs.at(i)) + " setpagedevice" << "-f" << job.psFilePath;
+
+    return arguments;
+}
+
+/**
+ * \brief Builds the SAFER-mode file permissions of a job's render stage.
+ *
+ * \param job The conversion job.
+ * \return --permit-file-read for the folder of the .ps input and
+ *         --permit-file-write for every folder an output is written to
+ *         (next to the .ps, and under 'Figures').
+ *
+ * Without them Ghostscript refuses the /OutputFile of every raster tier with
+ * invalidaccess, and only the file given by -sOutputFile is written.
+ */
+QStringList FileConverter::permitArguments(const ConversionJob& job)
+{
+    QStringList arguments = { "--permit-file-read=" + directoryPrefix(QFileInfo(job.psFilePath).absolutePath()) };
+
+    QStringList writeDirs;
+    for (const ConversionOutput& output : job.outputs) {
+        for (const QString& path : { output.tempPath, output.targetPath }) {
+            QString dir = directoryPrefix(QFileInfo(path).absolutePath());
+            if (!writeDirs.contains(dir))
+                writeDirs.append(dir);
+        }
+    }
+    for (const QString& dir : writeDirs)
+        arguments << "--permit-file-write=" + dir;
+
+    return arguments;
+}
+
+/**
+ * \brief Builds the setpagedevice dictionary that selects the device for one output.
+ *
+ * \param output The PDF or raster output.
+ * \return A PostScript dictionary literal (without the setpagedevice operator).
+ */
+QString FileConverter::pageDevice(const ConversionOutput& output)
+{
+    if (output.profile == PdfOutput)
+        return QString("<< /OutputDevice /pdfwrite /OutputFile %1 >>").arg(postScriptString(output.tempPath));
+
+    int factor = output.dpi < 300 ? downScaleFactor : 1;
+    int renderDpi = output.dpi * factor;
+
+    QString dictionary = QString("<< /OutputDevice /png16m /OutputFile %1 /HWResolution [%2 %2]")
+                             .arg(postScriptString(output.tempPath))
+                             .arg(renderDpi);
+    if (factor > 1)
+        dictionary += QString(" /DownScaleFactor %1").arg(factor);
+    return dictionary + " >>";
+}
+
+/**
+ * \brief Builds the PostScript program that renders all outputs of a job on a GhostscriptWorker.
+ *
+ * \param job The job, with its PostScript stage completed.
+ * \return One setpagedevice/run pair per output. The worker closes the last
+ *         output file when it switches back to nullpage after the job.
+ */
+QString FileConverter::renderProgram(const ConversionJob& job)
+{
+    QString program;
+    for (const ConversionOutput& output : job.outputs)
+        program += pageDevice(output) + " setpagedevice " + postScriptString(job.psFilePath) + " run\n";
+    return program;
+}
+
+/**
+ * \brief Plans the outputs of one conversion according to the selected profiles.
+ *
+ * \param agrFilePath The source .agr file (may be empty for PostScript-only input).
+ * \param psFilePath  The intermediate PostScript file.
+ * \return A job with one output per requested profile, PDF first.
+ *
+ * Outputs are rendered next to the .ps file and moved under 'Figures' (one
+ * level above the .ps directory) when the job succeeds.
+ */
+FileConverter::ConversionJob FileConverter::makeJob(const QString& agrFilePath, const QString& psFilePath) const
+{
+    ConversionJob job;
+    job.agrFilePath = agrFilePath;
+    job.psFilePath = psFilePath;
+
+    QFileInfo psFileInfo(psFilePath);
+    QDir parentDir = psFileInfo.absoluteDir();
+    parentDir.cdUp();
+    QString figuresDirPath = parentDir.filePath("Figures");
+    QString tempBase = psFileInfo.absolutePath() + "/" + psFileInfo.baseName();
+
+    if (outputProfiles.testFlag(PdfOutput))
+        job.outputs.append({ PdfOutput, 0, tempBase + ".pdf", figuresDirPath + "/" + psFileInfo.baseName() + ".pdf" });
+
+    const QList<QPair<OutputProfile, QString>> tiers = {
+        { ThumbnailTier, "_thumbnail.png" },
+        { PreviewTier, "_preview.png" },
+        { PrintTier, ".png" }
+    };
+    for (const auto& tier : tiers) {
+        if (!outputProfiles.testFlag(tier.first))
+            continue;
+        job.outputs.append({ tier.first, tierResolution(tier.first), tempBase + tier.second,
+                             tierDirectory(figuresDirPath, tier.first) + "/" + psFileInfo.baseName() + ".png" });
+    }
+
+    return job;
+}
+
+/**
+ * \brief Returns the directory a raster tier is written to.
+ *
+ * \param figuresDirPath The 'Figures' directory.
+ * \param tier           The raster tier.
+ * \return 'Figures' itself for the print tier (and the PDF), or its
+ *         'preview' / 'thumbnails' subdirectory.
+ */
+QString FileConverter::tierDirectory(const QString& figuresDirPath, OutputProfile tier)
+{
+    switch (tier) {
+    case ThumbnailTier:
+        return figuresDirPath + "/thumbnails";
+    case PreviewTier:
+        return figuresDirPath + "/preview";
+    default:
+        return figuresDirPath;
+    }
+}
+
+/**
+ * \brief Returns the built-in resolution of a raster tier.
+ *
+ * \param tier The raster tier.
+ * \return 24 dpi for thumbnails, 96 dpi for previews, 600 dpi for print and
+ *         0 for PdfOutput.
+ */
+int FileConverter::defaultTierResolution(OutputProfile tier)
+{
+    switch (tier) {
+    case ThumbnailTier:
+        return 24;
+    case PreviewTier:
+        return 96;
+    case PrintTier:
+        return 600;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * \brief Overrides the resolution of a raster tier.
+ *
+ * \param tier The raster tier (ignored for PdfOutput).
+ * \param dpi  Resolution in dots per inch; values below 1 are ignored.
+ */
+void FileConverter::setTierResolution(OutputProfile tier, int dpi)
+{
+    if (tier == PdfOutput || dpi < 1)
+        return;
+    tierDpi[tier] = dpi;
+}
 
 /**
  * \brief Converts a Grace .agr file to a PostScript (.ps) file.
- * 
+ *
  * \param agrFilePath The file path to the input Grace .agr file.
- * 
+ *
  * \return The file path to the generated PostScript (.ps) file on success,
  *         or an empty string if the conversion fails.
- * 
+ *
  * This function uses the external executable qtgrace.exe located in the
  * application's XMGrace/bin directory to perform the conversion.
  * It runs qtgrace.exe with the appropriate arguments to generate a PostScript
  * file from the provided .agr file. The process is allowed to run up to 60 seconds.
- * 
+ *
  * If the qtgrace executable is not found, the process times out, or the
  * conversion fails (non-zero exit code), an empty string is returned.
- * 
- * Warning and debug information is logged to assist troubleshooting.
+ *
+ * This is the blocking single-file variant; batch conversion goes through
+ * processAgrFilesToPsAndPdf().
  */
 QString FileConverter::generatePostScript(const QString& agrFilePath)
 {
-    QString graceExePath = QCoreApplication::applicationDirPath() + "/XMGrace/bin/qtgrace.exe";
+    QString graceExePath = graceExecutable();
 
     if (!QFile::exists(graceExePath)) {
         qWarning() << "qtgrace.exe not found at:" << graceExePath;
         return "";
     }
 
-    QString psFilePath = QFileInfo(agrFilePath).absolutePath() + "/" + QFileInfo(agrFilePath).baseName() + ".ps";
-
-    QStringList arguments = {
-        "-nosafe",
-        "-hdevice", "PostScript",
-        "-noask",
-        "-hardcopy",
-        "-printfile", psFilePath,
-        agrFilePath
-    };
+    ConversionJob job;
+    job.agrFilePath = agrFilePath;
+    job.psFilePath = QFileInfo(agrFilePath).absolutePath() + "/" + QFileInfo(agrFilePath).baseName() + ".ps";
 
     QProcess process;
     process.setProgram(graceExePath);
-    process.setArguments(arguments);
+    process.setArguments(stageArguments(job));
     process.setProcessChannelMode(QProcess::MergedChannels);
 
     process.start();
-    if (!process.waitForFinished(60000)) {  // Wait max 60 seconds
+    if (!process.waitForFinished(stageTimeoutMs)) {
         qWarning() << "qtgrace.exe process timed out or failed to finish";
         return "";
     }
@@ -79,52 +381,47 @@ QString FileConverter::generatePostScript(const QString& agrFilePath)
         return "";
     }
 
-    qDebug() << "PostScript file generated successfully:" << psFilePath;
-    return psFilePath;
+    qDebug() << "PostScript file generated successfully:" << job.psFilePath;
+    return job.psFilePath;
 }
 
 /**
  * \brief Converts a PostScript (.ps) file to PDF and PNG formats using Ghostscript.
- * 
+ *
  * \param psFilePath The file path of the input PostScript (.ps) file.
- * 
+ *
  * This function performs the following steps:
  *  - Checks for the existence of the Ghostscript executable (gswin64c.exe).
- *  - Converts the given .ps file to a PDF file using Ghostscript.
- *  - Converts the generated PDF file to a high-quality PNG (600 DPI).
- *  - Creates (if needed) and moves the generated PDF and PNG files into a 'Figures' directory,
- *    located one level above the directory containing the input .ps file.
- *  - Deletes the original .ps file after successful conversion and relocation.
- * 
+ *  - Runs one Ghostscript invocation that writes the PDF and every requested
+ *    raster tier (see setOutputProfiles()).
+ *  - Moves the outputs into the 'Figures' directory (see moveOutputsToFigures())
+ *    and deletes the original .ps file.
+ *
  * If any step fails (missing executable, process errors, directory creation failures, or file operations),
  * appropriate warnings are logged and the function returns without throwing exceptions.
+ * This is the blocking single-file variant; batch conversion goes through
+ * processAgrFilesToPsAndPdf().
  */
 void FileConverter::convertPsToPdf(const QString& psFilePath)
 {
-    QString gsExePath = QCoreApplication::applicationDirPath() + "/Ghostscript/App/bin/gswin64c.exe";
+    QString gsExePath = ghostscriptExecutable();
 
     if (!QFile::exists(gsExePath)) {
         qWarning() << "Ghostscript executable not found at:" << gsExePath;
         return;
     }
 
-    QString pdfFilePath = psFilePath;
-    pdfFilePath.replace(".ps", ".pdf");
-
-    QStringList pdfArgs = {
-        "-sDEVICE=pdfwrite",
-        "-o", pdfFilePath,
-        psFilePath
-    };
+    ConversionJob job = makeJob(QString(), psFilePath);
+    job.stage = Stage::Render;
 
     QProcess gsProcess;
     gsProcess.setProgram(gsExePath);
-    gsProcess.setArguments(pdfArgs);
+    gsProcess.setArguments(stageArguments(job));
     gsProcess.setProcessChannelMode(QProcess::MergedChannels);
 
     gsProcess.start();
-    if (!gsProcess.waitForFinished(60000)) {
-        qWarning() << "Ghostscript PDF generation timed out or failed";
+    if (!gsProcess.waitForFinished(stageTimeoutMs)) {
+        qWarning() << "Ghostscript timed out or failed on:" << psFilePath;
         return;
     }
     if (gsProcess.exitCode() != 0) {
@@ -133,120 +430,477 @@ void FileConverter::convertPsToPdf(const QString& psFilePath)
         return;
     }
 
-    // Generate PNG from PDF with high DPI (600)
-    QString pngFilePath = pdfFilePath;
-    pngFilePath.replace(".pdf", ".png");
+    moveOutputsToFigures(job);
+}
 
-    QStringList pngArgs = {
-        "-sDEVICE=png16m",
-        "-r600",                // 600 DPI for high quality
-        "-o", pngFilePath,
-        pdfFilePath
-    };
+/**
+ * \brief Moves the rendered outputs of a job into 'Figures' and deletes the .ps file.
+ *
+ * \param job The finished job.
+ * \return true if every output was moved.
+ *
+ * Target directories (Figures and its tier subdirectories) are created if
+ * needed. Existing outputs are overwritten.
+ */
+bool FileConverter::moveOutputsToFigures(const ConversionJob& job)
+{
+    bool moved = true;
 
-    QProcess gsPngProcess;
-    gsPngProcess.setProgram(gsExePath);
-    gsPngProcess.setArguments(pngArgs);
-    gsPngProcess.setProcessChannelMode(QProcess::MergedChannels);
+    for (const ConversionOutput& output : job.outputs) {
+        QString targetDirPath = QFileInfo(output.targetPath).absolutePath();
 
-    gsPngProcess.start();
-    if (!gsPngProcess.waitForFinished(60000)) {
-        qWarning() << "Ghostscript PNG generation timed out or failed";
-        return;
-    }
-    if (gsPngProcess.exitCode() != 0) {
-        qWarning() << "Ghostscript PNG generation failed with exit code:" << gsPngProcess.exitCode();
-        qWarning() << gsPngProcess.readAllStandardOutput();
-        return;
-    }
+        // Correctly create the target directory by passing full path, NOT "."
+        if (!QDir(targetDirPath).exists() && !QDir().mkpath(targetDirPath)) {
+            qWarning() << "Failed to create Figures directory:" << targetDirPath;
+            moved = false;
+            continue;
+        }
 
-    QFileInfo psFileInfo(psFilePath);
-    QDir psDir = psFileInfo.absoluteDir();
-    if (!psDir.cdUp()) {
-        qWarning() << "Failed to go one directory up from:" << psDir.absolutePath();
-        return;
+        // Overwrite output if it exists
+        if (QFile::exists(output.targetPath)) {
+            QFile::remove(output.targetPath);
+        }
+        if (!QFile::rename(output.tempPath, output.targetPath)) {
+            qWarning() << "Failed to move output to:" << output.targetPath;
+            moved = false;
+        }
     }
 
-    QString figuresDirPath = psDir.filePath("Figures");
-    QDir figuresDir(figuresDirPath);
+    if (!QFile::remove(job.psFilePath))
+        qWarning() << "Failed to delete .ps file:" << job.psFilePath;
 
-    // Correctly create the Figures directory by passing full path, NOT "."
-    if (!figuresDir.exists()) {
-        if (!QDir().mkpath(figuresDirPath)) {
-            qWarning() << "Failed to create Figures directory:" << figuresDirPath;
-            return;
-        }
-    }
+    return moved;
+}
 
-    QString newPdfPath = figuresDirPath + "/" + psFileInfo.baseName() + ".pdf";
-    QString newPngPath = figuresDirPath + "/" + psFileInfo.baseName() + ".png";
+/**
+ * \brief Deletes the intermediate .ps file and any partially written outputs of a job.
+ *
+ * \param job The failed or cancelled job.
+ */
+void FileConverter::removeIntermediates(const ConversionJob& job)
+{
+    QFile::remove(job.psFilePath);
+    for (const ConversionOutput& output : job.outputs)
+        QFile::remove(output.tempPath);
+}
 
-    // Overwrite PDF if it exists
-    if (QFile::exists(newPdfPath)) {
-        QFile::remove(newPdfPath);
-    }
-    if (!QFile::rename(pdfFilePath, newPdfPath)) {
-        qWarning() << "Failed to move PDF to:" << newPdfPath;
-    }
+/**
+ * \brief Returns the final locations of a job's outputs.
+ *
+ * \param job The job.
+ * \return One path under 'Figures' per requested output.
+ */
+QStringList FileConverter::targetPaths(const ConversionJob& job)
+{
+    QStringList paths;
+    for (const ConversionOutput& output : job.outputs)
+        paths.append(output.targetPath);
+    return paths;
+}
 
-    // Overwrite PNG if it exists
-    if (QFile::exists(newPngPath)) {
-        QFile::remove(newPngPath);
-    }
-    if (!QFile::rename(pngFilePath, newPngPath)) {
-        qWarning() << "Failed to move PNG to:" << newPngPath;
-    }
+/**
+ * \brief Describes the outputs of a job for the manifest.
+ *
+ * \param job The job.
+ * \return e.g. "1:0;4:96" (profile:dpi per output). A figure converted with
+ *         different profiles or resolutions is not considered up to date.
+ */
+QString FileConverter::outputSettings(const ConversionJob& job)
+{
+    QStringList settings;
+    for (const ConversionOutput& output : job.outputs)
+        settings.append(QString("%1:%2").arg(int(output.profile)).arg(output.dpi));
+    return settings.join(';');
+}
 
-    if (!QFile::remove(psFilePath))
-        qWarning() << "Failed to delete .ps file:" << psFilePath;
+/**
+ * \brief Sets the maximum number of conversion jobs that run at the same time.
+ *
+ * \param count The pool size; values below 1 are clamped to 1.
+ *
+ * Raising the limit while a conversion is running starts queued jobs immediately.
+ */
+void FileConverter::setMaxConcurrentJobs(int count)
+{
+    maxJobs = qMax(1, count);
+    startPendingJobs();
 }
 
 /**
  * \brief Processes all Grace .agr files in the specified directory by converting them
  *        to PostScript (.ps), then to PDF and PNG formats asynchronously.
- * 
+ *
  * \param directory The directory path containing the .agr files to process.
- * 
- * This function scans the provided directory for all files with a .agr extension,
- * then performs the following for each file in a background thread:
- *  - Converts the .agr file to a PostScript (.ps) file.
- *  - Converts the generated .ps file to PDF and PNG formats.
- * 
- * Once all files have been processed, a \c conversionFinished signal is emitted on the main thread.
- * 
- * Note: Uses QtConcurrent for asynchronous execution and QPointer to safely reference \c this.
+ *
+ * Every .agr file becomes one job in a bounded process pool. Up to
+ * maxConcurrentJobs() jobs run at once; each job chains its qtgrace and
+ * Ghostscript stages through QProcess::finished, so no thread ever blocks on
+ * an external process. Only the outputs selected with setOutputProfiles()
+ * are produced.
+ *
+ * In incremental mode the manifest next to 'Figures' is consulted first:
+ * figures that are up to date count as converted straight away, and outputs
+ * of .agr files that have been deleted are removed.
+ *
+ * \c progressChanged and \c figureConverted are emitted after every figure.
+ * Without qtgrace or Ghostscript, every figure that is not up to date is
+ * reported as failed.
+ * \c conversionFinished is emitted once the whole pool has drained, including
+ * after cancel() or when there was nothing to convert.
  */
 void FileConverter::processAgrFilesToPsAndPdf(const QString& directory)
 {
     QDir agrDir(directory);
     QStringList agrFiles = agrDir.entryList(QStringList() << "*.agr", QDir::Files);
 
-    // Use QPointer for safe references
-    QPointer<FileConverter> self(this);
+#ifdef QCL_WITH_GRACE_LIBRARY
+    bool graceAvailable = true;  // linked in-process
+#else
+    bool graceAvailable = QFile::exists(graceExecutable());
+#endif
 
-    // Run conversion in a background thread
-    QtConcurrent::run([directory, agrFiles, self]() {
-        QDir localDir(directory);
-        for (const QString& agrFile : agrFiles) {
-            QString agrFilePath = localDir.absoluteFilePath(agrFile);
+    bool toolsAvailable = graceAvailable && QFile::exists(ghostscriptExecutable());
+    if (!toolsAvailable)
+        qWarning() << "Conversion tools not found:" << graceExecutable() << ghostscriptExecutable();
 
-            if (!self)
-                break;
+    if (!isRunning()) {
+        totalJobs = 0;
+        completedJobs = 0;
+        cancelRequested = false;
+    }
 
-            // Convert .agr to .ps
-            QString psFilePath = self->generatePostScript(agrFilePath);
+    // The manifest sits next to 'Figures', i.e. in the parent of the .agr directory
+    ConversionManifest *manifest = nullptr;
+    QString manifestPath;
+    if (incremental) {
+        QDir baseDir(agrDir.absolutePath());
+        baseDir.cdUp();
+        manifestPath = ConversionManifest::pathFor(baseDir.absolutePath());
+        if (!manifests.contains(manifestPath)) {
+            ConversionManifest loaded(manifestPath);
+            loaded.load();
+            manifests.insert(manifestPath, loaded);
+        }
+        manifest = &manifests[manifestPath];
+
+        QStringList sources;
+        for (const QString& agrFile : agrFiles)
+            sources.append(agrDir.absoluteFilePath(agrFile));
+        QStringList orphans = manifest->removeOrphans(sources);
+        if (!orphans.isEmpty())
+            qDebug() << "Removed figures of deleted .agr files:" << orphans;
+    }
 
-            // Convert .ps to .pdf and .png
-            if (!psFilePath.isEmpty()) {
-                self->convertPsToPdf(psFilePath);
+    for (const QString& agrFile : agrFiles) {
+        QString agrFilePath = agrDir.absoluteFilePath(agrFile);
+        QString psFilePath = QFileInfo(agrFilePath).absolutePath() + "/" + QFileInfo(agrFilePath).baseName() + ".ps";
+        ConversionJob job = makeJob(agrFilePath, psFilePath);
+
+        if (manifest) {
+            job.manifestPath = manifestPath;
+            job.sourceHash = ConversionManifest::hashFile(agrFilePath);
+            if (manifest->isUpToDate(agrFilePath, job.sourceHash, outputSettings(job), targetPaths(job))) {
+                ++totalJobs;
+                ++completedJobs;
+                emit figureConverted(agrFilePath, true);
+                continue;
             }
         }
 
-        // Emit conversionFinished signal safely on main thread
-        if (self) {
-            QMetaObject::invokeMethod(self, "conversionFinished", Qt::QueuedConnection);
+        if (!toolsAvailable) {
+            // Reported as failed, so callers never mistake a skipped figure for a converted one
+            ++totalJobs;
+            ++completedJobs;
+            emit figureConverted(agrFilePath, false);
+            continue;
         }
 
-        qDebug() << "Finished processing all .agr files to .pdf.";
+        pendingJobs.enqueue(job);
+        ++totalJobs;
+    }
+
+    emit progressChanged(completedJobs, totalJobs);
+
+    if (!isRunning()) {
+        // Nothing to convert: still report completion, but from the event loop like a real run
+        for (const ConversionManifest& touched : manifests)
+            touched.save();
+        manifests.clear();
+        QMetaObject::invokeMethod(this, "conversionFinished", Qt::QueuedConnection);
+        return;
+    }
+
+    startPendingJobs();
+}
+
+/**
+ * \brief Cancels the current conversion.
+ *
+ * Queued jobs are dropped, running qtgrace processes are killed and the
+ * Ghostscript workers are stopped (they restart on the next conversion).
+ * Partially written outputs are removed as each job reports back;
+ * \c conversionFinished follows once the last job has done so.
+ */
+void FileConverter::cancel()
+{
+    if (!isRunning())
+        return;
+
+    cancelRequested = true;
+
+    while (!pendingJobs.isEmpty())
+        finishJob(pendingJobs.dequeue(), false);
+
+    const QList<QProcess*> processes = runningJobs.keys();
+    for (QProcess *process : processes)
+        process->kill();
+
+    // Fails every job still queued on a worker through onRenderFinished()
+    for (GhostscriptWorker *worker : workers)
+        worker->stop();
+}
+
+/**
+ * \brief Starts queued jobs until the pool is full or the queue is empty.
+ */
+void FileConverter::startPendingJobs()
+{
+    while (!cancelRequested && activeJobs() < maxJobs && !pendingJobs.isEmpty()) {
+#ifdef QCL_WITH_GRACE_LIBRARY
+        startInProcessPostScript(pendingJobs.dequeue());
+#else
+        startStage(pendingJobs.dequeue());
+#endif
+    }
+}
+
+/**
+ * \brief Launches the external process for the PostScript stage of a job.
+ *
+ * \param job The job to run.
+ *
+ * The process reports back through onStageFinished(), either from
+ * QProcess::finished or, if it could not be started at all, from
+ * QProcess::errorOccurred. A single-shot timer kills stages that exceed the
+ * per-stage timeout.
+ */
+void FileConverter::startStage(const ConversionJob& job)
+{
+    QProcess *process = new QProcess(this);
+    process->setProgram(graceExecutable());
+    process->setArguments(stageArguments(job));
+    process->setProcessChannelMode(QProcess::MergedChannels);
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
+        onStageFinished(process, exitCode, exitStatus);
+    });
+
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            onStageFinished(process, -1, QProcess::CrashExit);
+    });
+
+    QTimer::singleShot(stageTimeoutMs, process, [process]() {
+        if (process->state() != QProcess::NotRunning) {
+            qWarning() << "Conversion stage timed out:" << process->program() << process->arguments();
+            process->kill();
+        }
     });
-}
\ No newline at end of file
+
+    runningJobs.insert(process, job);
+    process->start();
+}
+
+/**
+ * \brief Handles the end of a job's stage.
+ *
+ * \param process    The process that finished.
+ * \param exitCode   Its exit code.
+ * \param exitStatus Whether it exited normally.
+ *
+ * On success the job keeps its pool slot and moves on to the render stage.
+ * On failure the job's intermediate files are removed and it is reported as
+ * failed.
+ */
+void FileConverter::onStageFinished(QProcess *process, int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto it = runningJobs.find(process);
+    if (it == runningJobs.end())
+        return;
+
+    ConversionJob job = it.value();
+    runningJobs.erase(it);
+    process->deleteLater();
+
+    if (cancelRequested || exitStatus != QProcess::NormalExit || exitCode != 0) {
+        if (!cancelRequested) {
+            qWarning() << "Conversion failed for" << job.agrFilePath << "with exit code:" << exitCode;
+            qWarning() << process->readAllStandardOutput();
+        }
+        removeIntermediates(job);
+        finishJob(job, false);
+        return;
+    }
+
+    job.stage = Stage::Render;
+    startRender(job);
+}
+
+#ifdef QCL_WITH_GRACE_LIBRARY
+/**
+ * \brief Runs the PostScript stage of a job in the statically linked Grace core.
+ *
+ * \param job The job to run.
+ *
+ * The .agr file is read into memory and hardcopied by grace_render_agr() on a
+ * QtConcurrent worker thread. The Grace core serialises its own calls, so
+ * concurrent jobs queue inside the library while their Ghostscript stages
+ * still overlap. A running in-process render cannot be interrupted; after
+ * cancel() its result is simply discarded.
+ */
+void FileConverter::startInProcessPostScript(const ConversionJob& job)
+{
+    int jobId = nextRenderId++;
+    inProcessJobs.insert(jobId, job);
+
+    QByteArray shareDir = QFile::encodeName(QCoreApplication::applicationDirPath() + "/XMGrace");
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, jobId]() {
+        bool success = watcher->result();
+        watcher->deleteLater();
+        onInProcessPostScriptFinished(jobId, success);
+    });
+
+    watcher->setFuture(QtConcurrent::run([job, shareDir]() {
+        QFile agrFile(job.agrFilePath);
+        if (!grace_render_init(shareDir.constData()) || !agrFile.open(QIODevice::ReadOnly))
+            return false;
+
+        QByteArray agrData = agrFile.readAll();
+        QByteArray psFilePath = QFile::encodeName(job.psFilePath);
+        return grace_render_agr(agrData.constData(), agrData.size(), psFilePath.constData(), "PostScript");
+    }));
+}
+
+/**
+ * \brief Handles the end of an in-process PostScript stage.
+ *
+ * \param jobId   Identifier assigned in startInProcessPostScript().
+ * \param success Whether the PostScript file was written.
+ */
+void FileConverter::onInProcessPostScriptFinished(int jobId, bool success)
+{
+    auto it = inProcessJobs.find(jobId);
+    if (it == inProcessJobs.end())
+        return;
+
+    ConversionJob job = it.value();
+    inProcessJobs.erase(it);
+
+    if (cancelRequested || !success) {
+        if (!cancelRequested)
+            qWarning() << "In-process Grace rendering failed for" << job.agrFilePath;
+        removeIntermediates(job);
+        finishJob(job, false);
+        return;
+    }
+
+    job.stage = Stage::Render;
+    startRender(job);
+}
+#endif
+
+/**
+ * \brief Hands the render stage of a job to a Ghostscript worker.
+ *
+ * \param job The job whose PostScript file is ready.
+ *
+ * Workers are created lazily, one per pool slot at most; the job goes to an
+ * idle worker if there is one, otherwise a new worker is started while the
+ * pool allows it, otherwise the least loaded worker queues it.
+ */
+void FileConverter::startRender(const ConversionJob& job)
+{
+    GhostscriptWorker *target = nullptr;
+    for (GhostscriptWorker *worker : workers) {
+        if (!target || worker->load() < target->load())
+            target = worker;
+    }
+
+    if ((!target || !target->isIdle()) && workers.size() < maxJobs) {
+        target = new GhostscriptWorker(ghostscriptExecutable(), this);
+        connect(target, &GhostscriptWorker::jobFinished, this, &FileConverter::onRenderFinished);
+        workers.append(target);
+    }
+
+    int renderId = nextRenderId++;
+    renderingJobs.insert(renderId, job);
+    target->submit(renderId, renderProgram(job), permitArguments(job));
+}
+
+/**
+ * \brief Handles the end of a job's render stage.
+ *
+ * \param renderId Identifier given to the worker.
+ * \param success  Whether Ghostscript rendered every output.
+ *
+ * On success the outputs are moved into 'Figures'; otherwise the job's
+ * intermediate files are removed and it is reported as failed.
+ */
+void FileConverter::onRenderFinished(int renderId, bool success)
+{
+    auto it = renderingJobs.find(renderId);
+    if (it == renderingJobs.end())
+        return;
+
+    ConversionJob job = it.value();
+    renderingJobs.erase(it);
+
+    if (cancelRequested || !success) {
+        if (!cancelRequested)
+            qWarning() << "Rendering failed for" << job.agrFilePath;
+        removeIntermediates(job);
+        finishJob(job, false);
+        return;
+    }
+
+    finishJob(job, moveOutputsToFigures(job));
+}
+
+/**
+ * \brief Records a finished job, refills the pool and reports progress.
+ *
+ * \param job     The job that finished.
+ * \param success Whether its outputs were produced.
+ *
+ * Successful jobs are recorded in their manifest and failed ones removed
+ * from it; manifests are written once the pool has drained. Emits
+ * \c conversionFinished when no job is left queued or running.
+ */
+void FileConverter::finishJob(const ConversionJob& job, bool success)
+{
+    auto manifest = manifests.find(job.manifestPath);
+    if (manifest != manifests.end()) {
+        if (success)
+            manifest->record(job.agrFilePath, job.sourceHash, outputSettings(job), targetPaths(job));
+        else
+            manifest->remove(job.agrFilePath);
+    }
+
+    ++completedJobs;
+    emit figureConverted(job.agrFilePath, success);
+    emit progressChanged(completedJobs, totalJobs);
+
+    startPendingJobs();
+
+    if (activeJobs() == 0 && pendingJobs.isEmpty()) {
+        qDebug() << "Finished processing all .agr files to .pdf.";
+        for (const ConversionManifest& touched : manifests)
+            touched.save();
+        manifests.clear();
+        cancelRequested = false;
+        emit conversionFinished();
+    }
+}
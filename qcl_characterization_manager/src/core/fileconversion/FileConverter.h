@@ -1,9 +1,12 @@
 /**
  * @file FileConverter.h
  * @brief Declaration of FileConverter for converting Grace .agr files to PS and PDF.
- * 
+ *
  * Converts Grace (.agr) files to PostScript (.ps) and PDF formats.
- * 
+ * Batch conversion runs as a bounded pool of asynchronous QProcess jobs.
+ * Raster output is produced in configurable DPI tiers (thumbnail, preview, print).
+ * Figures whose source and settings are unchanged are skipped (see ConversionManifest).
+ *
  * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
  */
 
@@ -16,24 +19,154 @@
 	#endif
 
 	#include <QString>
+	#include <QStringList>
 	#include <QObject>
+	#include <QQueue>
+	#include <QHash>
+	#include <QMap>
+	#include <QList>
+	#include <QProcess>
+	#include "ConversionManifest.h"
+
+	class GhostscriptWorker;
 
 	/**
 	 * @class FileConverter
 	 * @brief Converts Grace (.agr) files to PostScript and PDF formats.
+	 *
+	 * Each .agr file is one conversion job made of two stages: qtgrace ->
+	 * PostScript, then a render pass that writes the PDF and every requested
+	 * raster tier. Render passes run on persistent GhostscriptWorker
+	 * interpreters (one per pool slot, started on first use), so Ghostscript's
+	 * start-up cost is paid once per worker rather than once per figure. Jobs
+	 * run concurrently, at most one per core by default, driven by signals on
+	 * the owning thread's event loop.
+	 *
+	 * When built with QCL_WITH_GRACE_LIBRARY (qmake CONFIG+=grace_library) the
+	 * PostScript stage runs in the statically linked Grace core on a worker
+	 * thread instead of spawning qtgrace.
+	 *
+	 * Conversion is incremental by default: a FiguresManifest.json next to
+	 * 'Figures' records the content hash each figure was converted from, and
+	 * figures whose hash, settings and outputs are unchanged are reported as
+	 * converted without running any process. Outputs of .agr files that no
+	 * longer exist are deleted.
+	 *
+	 * Output locations, relative to the parent of the .agr directory:
+	 * - PdfOutput     -> Figures/<name>.pdf
+	 * - PrintTier     -> Figures/<name>.png
+	 * - PreviewTier   -> Figures/preview/<name>.png
+	 * - ThumbnailTier -> Figures/thumbnails/<name>.png
 	 */
 	class FileConverter : public QObject
 	{
 			Q_OBJECT
 
 		public:
+			/// Outputs a conversion can produce; combine as OutputProfiles.
+			enum OutputProfile
+			{
+				PdfOutput     = 0x1, ///< Vector PDF (used by the datasheet)
+				ThumbnailTier = 0x2, ///< Small PNG for menus and lists
+				PreviewTier   = 0x4, ///< Screen-resolution PNG for the carousel
+				PrintTier     = 0x8  ///< High-resolution PNG (600 dpi by default)
+			};
+			Q_DECLARE_FLAGS(OutputProfiles, OutputProfile)
+
 			explicit FileConverter(QObject *parent = nullptr); ///< Constructor
+			~FileConverter() override; ///< Kills any conversion still running
 
 			void processAgrFilesToPsAndPdf(const QString& directory); ///< Convert all .agr files in directory to PS and PDF
 			void convertPsToPdf(const QString& psFilePath); ///< Convert a single PS file to PDF
 			QString generatePostScript(const QString& agrFilePath); ///< Generate PostScript content from an .agr file
 
+			void setMaxConcurrentJobs(int count); ///< Set the pool size (defaults to the number of cores)
+			int maxConcurrentJobs() const { return maxJobs; } ///< Current pool size
+			bool isRunning() const { return activeJobs() > 0 || !pendingJobs.isEmpty(); } ///< True while jobs are queued or running
+
+			void setOutputProfiles(OutputProfiles profiles) { outputProfiles = profiles; } ///< Select which outputs are produced
+			OutputProfiles profiles() const { return outputProfiles; } ///< Outputs produced by the next conversion
+			void setTierResolution(OutputProfile tier, int dpi); ///< Override the DPI of a raster tier
+			int tierResolution(OutputProfile tier) const { return tierDpi.value(tier, 0); } ///< DPI of a raster tier
+
+			static QString graceExecutable();       ///< Path to the bundled qtgrace executable
+			static QString ghostscriptExecutable(); ///< Path to the bundled Ghostscript executable
+			static QString tierDirectory(const QString& figuresDirPath, OutputProfile tier); ///< Folder a raster tier is written to
+			static int defaultTierResolution(OutputProfile tier); ///< Built-in DPI of a raster tier
+
+			void setIncremental(bool enabled) { incremental = enabled; } ///< Skip figures recorded as up to date (default true)
+			bool isIncremental() const { return incremental; } ///< Whether up-to-date figures are skipped
+
+		public slots:
+			void cancel(); ///< Drop queued jobs and kill running processes
+
 		signals:
 			void conversionFinished(); ///< Signal emitted when conversion is finished
+			void progressChanged(int completed, int total); ///< Emitted after every finished figure
+			void figureConverted(const QString& agrFilePath, bool success); ///< Emitted when one figure has finished (or failed)
+
+		private:
+			/// Process stage a conversion job is currently in.
+			enum class Stage { PostScript, Render };
+
+			/// One file written by the render stage.
+			struct ConversionOutput
+			{
+				OutputProfile profile; ///< PdfOutput or a raster tier
+				int dpi;               ///< Raster resolution (unused for PDF)
+				QString tempPath;      ///< Written next to the .ps
+				QString targetPath;    ///< Final location under Figures
+			};
+
+			/// One .agr file travelling through the conversion stages.
+			struct ConversionJob
+			{
+				QString agrFilePath;   ///< Source Grace file
+				QString psFilePath;    ///< Intermediate PostScript file
+				QList<ConversionOutput> outputs; ///< Requested outputs
+				Stage stage = Stage::PostScript; ///< Stage being run
+				QString manifestPath;  ///< Manifest to update, empty when not incremental
+				QByteArray sourceHash; ///< Hash of the .agr content when the job was planned
+			};
+
+			static QStringList stageArguments(const ConversionJob& job); ///< Command line of the job's current stage
+			static QStringList permitArguments(const ConversionJob& job); ///< SAFER-mode read/write permissions of the render stage
+			static QString pageDevice(const ConversionOutput& output); ///< setpagedevice dictionary selecting a raster tier
+			static QString renderProgram(const ConversionJob& job); ///< PostScript program for a GhostscriptWorker
+			static bool moveOutputsToFigures(const ConversionJob& job); ///< Relocate outputs into Figures and delete the .ps
+			static void removeIntermediates(const ConversionJob& job); ///< Delete the .ps and any partial outputs
+			static QStringList targetPaths(const ConversionJob& job); ///< Final locations of a job's outputs
+			static QString outputSettings(const ConversionJob& job); ///< Profiles and resolutions, as recorded in the manifest
+
+			ConversionJob makeJob(const QString& agrFilePath, const QString& psFilePath) const; ///< Plan the outputs for one file
+
+			void startPendingJobs(); ///< Fill free pool slots from the queue
+			void startStage(const ConversionJob& job); ///< Launch the process for the job's current stage
+			void onStageFinished(QProcess *process, int exitCode, QProcess::ExitStatus exitStatus); ///< Advance or finish a job
+			void startRender(const ConversionJob& job); ///< Queue the render stage on the least loaded worker
+			void onRenderFinished(int renderId, bool success); ///< Finish a job after its render stage
+			int activeJobs() const { return runningJobs.size() + inProcessJobs.size() + renderingJobs.size(); } ///< Jobs holding a pool slot
+	#ifdef QCL_WITH_GRACE_LIBRARY
+			void startInProcessPostScript(const ConversionJob& job); ///< Run the PostScript stage in the linked Grace core
+			void onInProcessPostScriptFinished(int jobId, bool success); ///< Advance a job rendered in-process
+	#endif
+			void finishJob(const ConversionJob& job, bool success); ///< Account for a finished job and emit progress
+
+			QQueue<ConversionJob> pendingJobs;          ///< Jobs waiting for a free slot
+			QHash<QProcess*, ConversionJob> runningJobs; ///< Jobs with a live qtgrace process
+			QHash<int, ConversionJob> inProcessJobs;     ///< Jobs in the in-process Grace stage (QCL_WITH_GRACE_LIBRARY)
+			QHash<int, ConversionJob> renderingJobs;     ///< Jobs queued on a Ghostscript worker
+			QList<GhostscriptWorker*> workers;           ///< Persistent Ghostscript interpreters
+			int nextRenderId;   ///< Identifier for the next worker job
+			int maxJobs;        ///< Pool size
+			int totalJobs;      ///< Jobs submitted in the current run
+			int completedJobs;  ///< Jobs finished in the current run
+			bool cancelRequested; ///< Set by cancel() until the pool drains
+			OutputProfiles outputProfiles; ///< Outputs to produce
+			QMap<OutputProfile, int> tierDpi; ///< Resolution per raster tier
+			bool incremental;   ///< Skip up-to-date figures
+			QMap<QString, ConversionManifest> manifests; ///< Manifests touched by the current run, by path
 	};
-#endif // FILECONVERTER_H
\ No newline at end of file
+
+	Q_DECLARE_OPERATORS_FOR_FLAGS(FileConverter::OutputProfiles)
+#endif // FILECONVERTER_H
@@ -0,0 +1,265 @@
+/**
+ * \file        GhostscriptWorker.cpp
+ * \brief       Persistent Ghostscript interpreter that executes render jobs received over stdin.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDebug>
+#include <QTimer>
+#include "GhostscriptWorker.h"
+
+namespace
+{
+    /// Maximum time a single job may run before the interpreter is killed.
+    constexpr int jobTimeoutMs = 60000;
+
+    /// Marker lines printed by the interpreter after every job.
+    const QByteArray doneMarker = "QCL_JOB_DONE ";
+    const QByteArray failedMarker = "QCL_JOB_FAILED ";
+}
+
+/**
+ * \brief   Constructs a worker for the given Ghostscript executable.
+ * \param   executable - Path to the Ghostscript console executable.
+ * \param   parent - Optional parent QObject.
+ *
+ * The interpreter is only started when the first job is submitted.
+ */
+GhostscriptWorker::GhostscriptWorker(const QString& executable, QObject *parent)
+    : QObject(parent)
+    , executable(executable)
+    , process(nullptr)
+    , watchdog(new QTimer(this))
+    , currentJobId(-1)
+{
+    watchdog->setSingleShot(true);
+    watchdog->setInterval(jobTimeoutMs);
+    connect(watchdog, &QTimer::timeout, this, [this]() {
+        qWarning() << "Ghostscript job" << currentJobId << "timed out, restarting interpreter";
+        if (process)
+            process->kill();
+    });
+}
+
+/**
+ * \brief   Destroys the worker.
+ *
+ * The interpreter is killed without emitting \c jobFinished for queued or
+ * running jobs; owners that need those notifications call stop() first.
+ */
+GhostscriptWorker::~GhostscriptWorker()
+{
+    if (process) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        delete process;
+    }
+}
+
+/**
+ * \brief Queues a PostScript program for execution.
+ *
+ * \param jobId   Caller-chosen identifier reported back in \c jobFinished.
+ * \param program PostScript code to run, e.g. setpagedevice calls followed by
+ *                \c (file.ps) \c run. Output files are closed after the job.
+ * \param permissions --permit-file-read/--permit-file-write arguments for the
+ *                    files the program opens.
+ */
+void GhostscriptWorker::submit(int jobId, const QString& program, const QStringList& permissions)
+{
+    queue.enqueue({ jobId, program, permissions });
+    dispatchNext();
+}
+
+/**
+ * \brief Kills the interpreter and reports every queued and running job as failed.
+ */
+void GhostscriptWorker::stop()
+{
+    watchdog->stop();
+
+    if (process) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        process->deleteLater();
+        process = nullptr;
+    }
+
+    QList<int> failedJobs;
+    if (currentJobId >= 0)
+        failedJobs.append(currentJobId);
+    while (!queue.isEmpty())
+        failedJobs.append(queue.dequeue().id);
+
+    currentJobId = -1;
+    outputBuffer.clear();
+
+    for (int jobId : failedJobs)
+        emit jobFinished(jobId, false);
+}
+
+/**
+ * \brief Starts the interpreter if it is not already running.
+ *
+ * \param permissions --permit-file-* arguments the next job needs.
+ * \return true if a process is running or starting. A process that has
+ *         exited is always cleared by onProcessFinished() first.
+ *
+ * Ghostscript runs quietly on the nullpage device and reads its program from
+ * stdin ("-"). It stays in SAFER mode, so jobs may only open files under the
+ * permitted folders. A running interpreter started with other permissions
+ * is replaced; this only happens between jobs.
+ */
+bool GhostscriptWorker::ensureStarted(const QStringList& permissions)
+{
+    if (process && permissions == startedPermissions)
+        return true;
+
+    if (process) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        process->deleteLater();
+        process = nullptr;
+    }
+
+    startedPermissions = permissions;
+    process = new QProcess(this);
+    process->setProgram(executable);
+    process->setArguments(QStringList{ "-q", "-dNOPAUSE", "-dSAFER" } << permissions
+                          << QStringList{ "-sDEVICE=nullpage", "-" });
+    process->setProcessChannelMode(QProcess::MergedChannels);
+
+    connect(process, &QProcess::readyReadStandardOutput, this, &GhostscriptWorker::readOutput);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &GhostscriptWorker::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            qWarning() << "Failed to start Ghostscript:" << executable;
+            onProcessFinished(-1, QProcess::CrashExit);
+        }
+    });
+
+    outputBuffer.clear();
+    process->start();
+    return true;
+}
+
+/**
+ * \brief Sends the next queued job to the interpreter if none is running.
+ *
+ * The job is wrapped so that a PostScript error does not end the interpreter:
+ * errors are caught with \c stopped, the stacks are cleared, the output
+ * device is switched back to nullpage (which closes and flushes the job's
+ * files) and a done/failed marker is printed on stdout.
+ */
+void GhostscriptWorker::dispatchNext()
+{
+    if (currentJobId >= 0 || queue.isEmpty())
+        return;
+
+    Job job = queue.dequeue();
+    currentJobId = job.id;
+
+    ensureStarted(job.permissions);
+
+    QString wrapped = QString(
+        "{ %2\n} stopped\n"
+        "{ $error /newerror false put clear cleardictstack (\\n%3%1\\n) }\n"
+        "{ clear (\\n%4%1\\n) } ifelse\n"
+        "<< /OutputDevice /nullpage >> setpagedevice\n"
+        "print flush\n")
+        .arg(job.id)
+        .arg(job.program, QString::fromLatin1(failedMarker), QString::fromLatin1(doneMarker));
+
+    process->write(wrapped.toLocal8Bit());
+    watchdog->start();
+}
+
+/**
+ * \brief Reports the running job and dispatches the next one.
+ *
+ * \param success Whether the job completed without a PostScript error.
+ */
+void GhostscriptWorker::finishCurrent(bool success)
+{
+    if (currentJobId < 0)
+        return;
+
+    watchdog->stop();
+    int jobId = currentJobId;
+    currentJobId = -1;
+
+    emit jobFinished(jobId, success);
+    dispatchNext();
+}
+
+/**
+ * \brief Reads interpreter output and scans it for job markers.
+ */
+void GhostscriptWorker::readOutput()
+{
+    if (!process)
+        return;
+
+    outputBuffer += process->readAllStandardOutput();
+    processOutputLines();
+}
+
+/**
+ * \brief Scans buffered interpreter output for job markers.
+ *
+ * Complete lines are checked for the done/failed markers of the running job;
+ * anything else is Ghostscript diagnostics and is logged.
+ */
+void GhostscriptWorker::processOutputLines()
+{
+    int newline;
+    while ((newline = outputBuffer.indexOf('\n')) >= 0) {
+        QByteArray line = outputBuffer.left(newline).trimmed();
+        outputBuffer.remove(0, newline + 1);
+
+        if (line.startsWith(doneMarker) && line.mid(doneMarker.size()).toInt() == currentJobId) {
+            finishCurrent(true);
+        } else if (line.startsWith(failedMarker) && line.mid(failedMarker.size()).toInt() == currentJobId) {
+            qWarning() << "Ghostscript job" << currentJobId << "failed";
+            finishCurrent(false);
+        } else if (!line.isEmpty()) {
+            qDebug() << "Ghostscript:" << line;
+        }
+    }
+}
+
+/**
+ * \brief Handles the interpreter exiting, normally or not.
+ *
+ * \param exitCode   Process exit code.
+ * \param exitStatus Whether the process crashed or was killed.
+ *
+ * Output still buffered in the dead process is scanned first, since the
+ * running job may have completed just before the exit. A job that did not
+ * complete is reported as failed; queued jobs stay queued and are sent to a
+ * freshly started interpreter.
+ */
+void GhostscriptWorker::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *finishedProcess = process;
+    process = nullptr;
+
+    if (finishedProcess) {
+        outputBuffer += finishedProcess->readAllStandardOutput();
+        finishedProcess->disconnect(this);
+        finishedProcess->deleteLater();
+    }
+
+    int jobId = currentJobId;
+    processOutputLines();
+    outputBuffer.clear();
+
+    if (currentJobId >= 0 && currentJobId == jobId) {
+        qWarning() << "Ghostscript worker exited during job" << currentJobId << "with exit code:" << exitCode << exitStatus;
+        finishCurrent(false);
+    }
+}
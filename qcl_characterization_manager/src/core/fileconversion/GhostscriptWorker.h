@@ -0,0 +1,84 @@
+/**
+ * @file GhostscriptWorker.h
+ * @brief Declaration of GhostscriptWorker, a long-lived Ghostscript process fed over stdin.
+ *
+ * Starting Ghostscript and initialising its fonts dominates the cost of
+ * rendering a small Grace figure. A worker starts the interpreter once and
+ * runs any number of render jobs through it, one at a time.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef GHOSTSCRIPTWORKER_H
+	#define GHOSTSCRIPTWORKER_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QByteArray>
+	#include <QStringList>
+	#include <QQueue>
+	#include <QProcess>
+
+	class QTimer;
+
+	/**
+	 * @class GhostscriptWorker
+	 * @brief Runs PostScript render programs through one persistent Ghostscript interpreter.
+	 *
+	 * Ghostscript is started with -dNOPAUSE reading its program from stdin. Each
+	 * submitted job is a PostScript fragment (typically a few setpagedevice/run
+	 * pairs) that the worker wraps in a stopped context and terminates with a
+	 * marker line on stdout, so job boundaries and failures can be detected
+	 * without restarting the interpreter. If the process dies or a job exceeds
+	 * the timeout, the current job fails and the interpreter is restarted for
+	 * the next one.
+	 *
+	 * The interpreter keeps Ghostscript's SAFER file restrictions. Each job
+	 * names the folders it reads and writes as --permit-file-* arguments; they
+	 * can only be given at start-up, so the interpreter is restarted when a
+	 * job needs different ones, i.e. at most once per output folder.
+	 */
+	class GhostscriptWorker : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			explicit GhostscriptWorker(const QString& executable, QObject *parent = nullptr); ///< Constructor, does not start the process
+			~GhostscriptWorker() override; ///< Stops the interpreter without reporting queued jobs
+
+			void submit(int jobId, const QString& program, const QStringList& permissions); ///< Queue a PostScript program for execution
+			int load() const { return queue.size() + (currentJobId >= 0 ? 1 : 0); } ///< Jobs queued or running
+			bool isIdle() const { return load() == 0; } ///< True when nothing is queued or running
+
+		public slots:
+			void stop(); ///< Kill the interpreter and fail every queued job
+
+		signals:
+			void jobFinished(int jobId, bool success); ///< Emitted once per submitted job
+
+		private:
+			/// One submitted render program.
+			struct Job
+			{
+				int id;                  ///< Caller-chosen identifier
+				QString program;         ///< PostScript to run
+				QStringList permissions; ///< --permit-file-* arguments the program needs
+			};
+
+			bool ensureStarted(const QStringList& permissions); ///< Start the interpreter if it is not running
+			void dispatchNext();  ///< Send the next queued job to the interpreter
+			void finishCurrent(bool success); ///< Report the running job and move on
+			void readOutput();    ///< Read stdout from the interpreter
+			void processOutputLines(); ///< Scan buffered output for job markers
+			void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus); ///< Handle interpreter exit
+
+			QString executable;   ///< Ghostscript executable path
+			QProcess *process;    ///< Interpreter process (null until first job)
+			QTimer *watchdog;     ///< Per-job timeout
+			QQueue<Job> queue;    ///< Waiting jobs
+			QStringList startedPermissions; ///< --permit-file-* arguments of the running interpreter
+			int currentJobId;     ///< Job being executed, -1 if none
+			QByteArray outputBuffer; ///< Unterminated stdout line
+	};
+#endif // GHOSTSCRIPTWORKER_H
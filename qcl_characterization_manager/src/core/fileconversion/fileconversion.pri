@@ -0,0 +1,9 @@
+SOURCES += \
+    $$PWD/ConversionManifest.cpp \
+    $$PWD/FileConverter.cpp \
+    $$PWD/GhostscriptWorker.cpp
+
+HEADERS += \
+    $$PWD/ConversionManifest.h \
+    $$PWD/FileConverter.h \
+    $$PWD/GhostscriptWorker.h
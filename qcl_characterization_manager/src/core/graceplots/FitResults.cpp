@@ -0,0 +1,205 @@
+/**
+ * \file    FitResults.cpp
+ * \brief   FitResults class - reads and writes the .fit.json sidecar of a Grace figure
+ * \author  Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+#include "FitResults.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+namespace
+{
+    /// Bumped when the JSON layout changes; older sidecars are ignored.
+    constexpr int fitResultsVersion = 1;
+
+    QJsonObject peakToJson(const Peak& peak)
+    {
+        QJsonObject object;
+        object.insert("frequency", peak.frequency);
+        object.insert("amplitude", peak.amplitude);
+        object.insert("fwhm", peak.fwhm);
+        object.insert("q", peak.qFactor);
+        return object;
+    }
+
+    Peak peakFromJson(const QJsonObject& object)
+    {
+        Peak peak;
+        peak.frequency = object.value("frequency").toDouble();
+        peak.amplitude = object.value("amplitude").toDouble();
+        peak.fwhm = object.value("fwhm").toDouble();
+        peak.qFactor = object.value("q").toDouble();
+        return peak;
+    }
+}
+
+/**
+ * \brief Returns the sidecar location for a Grace file.
+ *
+ * \param agrFilePath Path of the .agr file.
+ * \return The same path with ".agr" replaced by ".fit.json".
+ */
+QString FitResults::pathFor(const QString& agrFilePath)
+{
+    QFileInfo info(agrFilePath);
+    return info.path() + "/" + info.completeBaseName() + ".fit.json";
+}
+
+/**
+ * \brief Reads a sidecar.
+ *
+ * \param filePath Path of the .fit.json file.
+ * \return true if a valid sidecar was read; otherwise the results are empty.
+ */
+bool FitResults::load(const QString& filePath)
+{
+    expFit = ExponentialFit();
+    peaks.clear();
+    freqMin = freqMax = 0.0;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != fitResultsVersion) {
+        qWarning() << "Ignoring incompatible fit results:" << filePath;
+        return false;
+    }
+
+    if (root.contains("exponentialFit")) {
+        QJsonObject fit = root.value("exponentialFit").toObject();
+        expFit.valid = true;
+        expFit.A = fit.value("A").toDouble();
+        expFit.C0 = fit.value("C0").toDouble();
+        expFit.T0 = fit.value("T0").toDouble();
+        expFit.JA = fit.value("JA").toDouble();
+        expFit.JC0 = fit.value("JC0").toDouble();
+        expFit.milliamps = fit.value("milliamps").toBool();
+    }
+
+    const QJsonArray traces = root.value("peaks").toArray();
+    for (const QJsonValue& value : traces) {
+        QJsonObject trace = value.toObject();
+
+        TracePeaks entry;
+        entry.label = trace.value("label").toString();
+        entry.center = peakFromJson(trace.value("center").toObject());
+        const QJsonArray sides = trace.value("sideModes").toArray();
+        for (const QJsonValue& side : sides)
+            entry.sideModes.append(peakFromJson(side.toObject()));
+        peaks.append(entry);
+    }
+
+    QJsonObject range = root.value("frequencyRange").toObject();
+    freqMin = range.value("min").toDouble();
+    freqMax = range.value("max").toDouble();
+
+    return true;
+}
+
+/**
+ * \brief Writes the sidecar.
+ *
+ * \param filePath Path of the .fit.json file, usually from pathFor().
+ * \return true on success.
+ */
+bool FitResults::save(const QString& filePath) const
+{
+    QJsonObject root;
+    root.insert("version", fitResultsVersion);
+
+    if (expFit.valid) {
+        QJsonObject fit;
+        fit.insert("A", expFit.A);
+        fit.insert("C0", expFit.C0);
+        fit.insert("T0", expFit.T0);
+        fit.insert("JA", expFit.JA);
+        fit.insert("JC0", expFit.JC0);
+        fit.insert("milliamps", expFit.milliamps);
+        fit.insert("units", "Ith: A, Jth: A/cm^2, T0: K");
+        root.insert("exponentialFit", fit);
+    }
+
+    if (!peaks.isEmpty()) {
+        QJsonArray traces;
+        for (const TracePeaks& entry : peaks) {
+            QJsonArray sides;
+            for (const Peak& side : entry.sideModes)
+                sides.append(peakToJson(side));
+
+            QJsonObject trace;
+            trace.insert("label", entry.label);
+            trace.insert("center", peakToJson(entry.center));
+            trace.insert("sideModes", sides);
+            traces.append(trace);
+        }
+        root.insert("peaks", traces);
+
+        QJsonObject range;
+        range.insert("min", freqMin);
+        range.insert("max", freqMax);
+        range.insert("units", "THz");
+        root.insert("frequencyRange", range);
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write fit results:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+/**
+ * \brief Stores an exponential threshold fit.
+ *
+ * \param A       Prefactor [A].
+ * \param B       Rate [1/K], as returned by IthDataProcessor::getExponentialFitParams().
+ * \param C0      Offset [A].
+ * \param areaCm2 Ridge area used for the current density, <= 0 to leave Jth at zero.
+ * \param milliamps Whether the plot shows Ith in mA; the values stay in A.
+ */
+void FitResults::setExponentialFit(double A, double B, double C0, double areaCm2, bool milliamps)
+{
+    expFit.valid = B != 0.0;
+    expFit.A = A;
+    expFit.C0 = C0;
+    expFit.T0 = B != 0.0 ? 1.0 / B : 0.0;
+    expFit.JA = areaCm2 > 0.0 ? A / areaCm2 : 0.0;
+    expFit.JC0 = areaCm2 > 0.0 ? C0 / areaCm2 : 0.0;
+    expFit.milliamps = milliamps;
+}
+
+/**
+ * \brief Formats the emission range like SpectraDataProcessor::getGlobalFrequencyRangeString().
+ *
+ * \return "f THz" or "fmin THz - fmax THz", or an empty string if no peaks were saved.
+ */
+QString FitResults::frequencyRangeString() const
+{
+    if (peaks.isEmpty())
+        return QString();
+
+    if (qFuzzyCompare(freqMin, freqMax))
+        return QStringLiteral("%1 THz").arg(freqMin, 0, 'f', 3);
+    return QStringLiteral("%1 THz - %2 THz").arg(freqMin, 0, 'f', 3).arg(freqMax, 0, 'f', 3);
+}
+
+/**
+ * \brief Appends the peaks of one spectrum.
+ *
+ * \param label     Trace value, e.g. the drive current.
+ * \param center    Center mode.
+ * \param sideModes Side modes.
+ */
+void FitResults::addTracePeaks(const QString& label, const Peak& center, const QVector<Peak>& sideModes)
+{
+    peaks.append({ label, center, sideModes });
+}
@@ -0,0 +1,71 @@
+/**
+ * \file    FitResults.h
+ * \brief   FitResults class - fit parameters and peak tables saved next to a Grace figure
+ * \author  Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+#pragma once
+#ifndef FITRESULTS_H
+	#define FITRESULTS_H
+
+	#include <QString>
+	#include <QVector>
+	#include "core/dataprocessing/SpectraDataProcessor.h"
+
+	/**
+	 * \class FitResults
+	 * \brief Structured results of a plotted figure, stored as <figure>.fit.json.
+	 *
+	 * The plot classes fill and save it when they write the .agr file, so the
+	 * datasheet generators read the numbers directly instead of parsing them
+	 * back out of the Grace legend markup. Currents are stored in A and
+	 * current densities in A/cm^2, whatever unit the plot axis uses.
+	 */
+	class FitResults
+	{
+		public:
+			/**
+			 * \struct ExponentialFit
+			 * \brief Threshold fit X(T) = C0 + A exp(T / T0), for Ith [A] and Jth [A/cm^2].
+			 */
+			struct ExponentialFit {
+				bool valid = false; ///< False when no fit was made
+				double A = 0.0;     ///< Ith prefactor [A]
+				double C0 = 0.0;    ///< Ith offset [A]
+				double T0 = 0.0;    ///< Characteristic temperature [K]
+				double JA = 0.0;    ///< Jth prefactor [A/cm^2]
+				double JC0 = 0.0;   ///< Jth offset [A/cm^2]
+				bool milliamps = false; ///< The plot shows Ith in mA
+			};
+
+			/**
+			 * \struct TracePeaks
+			 * \brief Peaks of one spectrum; frequencies and FWHM in THz.
+			 */
+			struct TracePeaks {
+				QString label;           ///< Trace value, e.g. the current in mA
+				Peak center;             ///< Center mode
+				QVector<Peak> sideModes; ///< Side modes
+			};
+
+			static QString pathFor(const QString& agrFilePath); ///< <figure>.fit.json for <figure>.agr
+
+			bool load(const QString& filePath); ///< Read a sidecar, false if missing or invalid
+			bool save(const QString& filePath) const; ///< Write a sidecar
+
+			void setExponentialFit(double A, double B, double C0, double areaCm2, bool milliamps); ///< Store an Ith fit with rate B = 1/T0
+			const ExponentialFit& exponentialFit() const { return expFit; } ///< Threshold fit
+
+			void addTracePeaks(const QString& label, const Peak& center, const QVector<Peak>& sideModes); ///< Append a spectrum's peaks
+			const QVector<TracePeaks>& tracePeaks() const { return peaks; } ///< Peaks per spectrum
+			void setFrequencyRange(double fmin, double fmax) { freqMin = fmin; freqMax = fmax; } ///< Emission range [THz]
+			double frequencyMin() const { return freqMin; } ///< Lowest mode frequency [THz], 0 if none
+			double frequencyMax() const { return freqMax; } ///< Highest mode frequency [THz], 0 if none
+			QString frequencyRangeString() const; ///< "f1 THz - f2 THz" as shown on the datasheet, empty if none
+
+		private:
+			ExponentialFit expFit;     ///< Threshold fit
+			QVector<TracePeaks> peaks; ///< Peak table
+			double freqMin = 0.0;      ///< Emission range start [THz]
+			double freqMax = 0.0;      ///< Emission range end [THz]
+	};
+#endif // FITRESULTS_H
@@ -0,0 +1,207 @@
+/**
+ * \file        GraceFigureJob.cpp
+ * \brief       Parses, analyses and plots one measurement set of a device.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QFile>
+#include <QCryptographicHash>
+#include <QDebug>
+#include "GraceFigureJob.h"
+#include "LIVGracePlot.h"
+#include "IthGracePlot.h"
+#include "SpectraGracePlot.h"
+#include "core/project/ProjectFile.h"
+
+/**
+ * \brief The six measurement sets, in the order the wizard plots them.
+ */
+const QVector<GraceFigureJob::FigureSet>& GraceFigureJob::figureSets()
+{
+    static const QVector<FigureSet> sets = {
+        { "Pulsed LIV",                      "pulsed", QString(),     "pulsed_liv"       },
+        { "Pulsed FTIR - fixed temperature", "pulsed", "current",     "pulsed_ftir_vs_I" },
+        { "Pulsed FTIR - fixed current",     "pulsed", "temperature", "pulsed_ftir_vs_T" },
+        { "CW LIV",                          "cw",     QString(),     "cw_liv"           },
+        { "CW FTIR - fixed temperature",     "cw",     "current",     "cw_ftir_vs_I"     },
+        { "CW FTIR - fixed current",         "cw",     "temperature", "cw_ftir_vs_T"     }
+    };
+    return sets;
+}
+
+/**
+ * \brief Constructs a job for one measurement set.
+ * \param set             Set to process.
+ * \param collectedData   Wizard or DataMap data of the device; copied.
+ * \param graceFiguresDir Folder the .agr files are written to; must exist.
+ */
+GraceFigureJob::GraceFigureJob(const FigureSet& set, const QVariantMap& collectedData, const QString& graceFiguresDir)
+    : set(set)
+    , data(collectedData)
+    , outputDir(graceFiguresDir)
+    , liv(nullptr)
+    , ith(nullptr)
+    , spectra(nullptr)
+{
+    QVariantMap dimensions = data.value("Dimensions").toMap();
+    width = dimensions.value("width").toDouble();
+    length = dimensions.value("length").toDouble();
+}
+
+/**
+ * \brief Deletes the parsed data; the processors have no parent.
+ */
+GraceFigureJob::~GraceFigureJob()
+{
+    delete ith;
+    delete liv;
+    delete spectra;
+}
+
+/**
+ * \brief Hashes the inputs of the set's figures.
+ *
+ * \return The hex SHA-1 of the file map (paths, values and file contents),
+ *         the ridge dimensions and the scale or frequency window of the
+ *         set, or an empty array if a measurement file cannot be read.
+ *
+ * Reading the files is far cheaper than parsing and plotting them, so a
+ * resumed batch uses this to skip sets whose figures are already written.
+ */
+QByteArray GraceFigureJob::inputHash() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(set.field.toUtf8());
+    hash.addData(QByteArray::number(width, 'g', 17));
+    hash.addData(QByteArray::number(length, 'g', 17));
+    if (set.isLIV())
+        hash.addData(data.value(set.prefix + "_power_scale_liv", 100.0).toString().toUtf8());
+    else
+        hash.addData((data.value(set.prefix + "_fmin_spectra").toString() + ";"
+                      + data.value(set.prefix + "_fmax_spectra").toString()).toUtf8());
+
+    const QVariantMap files = data.value(set.field).toMap();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        hash.addData(it.key().toUtf8());
+        hash.addData(it.value().toString().toUtf8());
+
+        QFile file(it.key());
+        if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file))
+            return QByteArray();
+    }
+    return hash.result().toHex();
+}
+
+/**
+ * \brief Reads the measurement files of the set.
+ *
+ * \return false if the collected data has no such file map.
+ */
+bool GraceFigureJob::parse()
+{
+    if (!data.contains(set.field))
+        return false;
+
+    if (set.isLIV()) {
+        liv = new LIVDataProcessor(set.field, data[set.field].toMap(), "temperature",
+                                   data.value(set.prefix + "_power_scale_liv", 100.0).toDouble());
+    } else {
+        spectra = new SpectraDataProcessor(
+            set.field,
+            data[set.field].toMap(),
+            set.traceVariable,
+            data.value(set.prefix + "_fmin_spectra", 0.0).toDouble(),
+            data.value(set.prefix + "_fmax_spectra", 0.0).toDouble()
+        );
+    }
+    return true;
+}
+
+/**
+ * \brief Takes the parsed traces of the set from a saved project.
+ *
+ * \param project An open project.
+ * \return false if the project does not hold the set or its columns are damaged.
+ *
+ * analyse() then refits the threshold current from the same traces the
+ * project was saved with. Side modes are not stored, so the emission range
+ * only spans the centre modes.
+ */
+bool GraceFigureJob::restore(const ProjectFile& project)
+{
+    if (set.isLIV())
+        liv = project.livData(set.field);
+    else
+        spectra = project.spectraData(set.field);
+    return liv || spectra;
+}
+
+/**
+ * \brief Fits the threshold current, or finds the emission range.
+ *
+ * Adds <mode>_I_exp_*, <mode>_J_exp_* or <mode>_ftir_fixed_temp_freq_range
+ * to results().
+ */
+void GraceFigureJob::analyse()
+{
+    if (liv) {
+        ith = new IthDataProcessor(liv, 3.0);
+        if (!ith->canPlot())
+            return;
+
+        double A, B, C0;
+        ith->getExponentialFitParams(A, B, C0);
+
+        newData[set.prefix + "_I_exp_A"] = QString::number(A, 'f', 2);
+        newData[set.prefix + "_I_exp_B"] = QString::number(B, 'f', 2);
+        newData[set.prefix + "_I_exp_C0"] = QString::number(C0, 'f', 2);
+
+        double scale = 1e5 / (width * length);
+
+        newData[set.prefix + "_J_exp_A"] = QString::number(A * scale, 'f', 2);
+        newData[set.prefix + "_J_exp_B"] = QString::number(B * scale, 'f', 2);
+        newData[set.prefix + "_J_exp_C0"] = QString::number(C0 * scale, 'f', 2);
+    }
+
+    // The datasheet quotes the emission range of the fixed-temperature series
+    if (spectra && set.traceVariable == "current") {
+        QString freqRange = spectra->getGlobalFrequencyRangeString();
+        if (!freqRange.isEmpty())
+            newData[set.prefix + "_ftir_fixed_temp_freq_range"] = freqRange;
+    }
+}
+
+/**
+ * \brief Writes the figures of the set.
+ *
+ * \return Paths of the .agr files written.
+ */
+QStringList GraceFigureJob::plot()
+{
+    QStringList files;
+
+    if (liv) {
+        QString livOutputPath = outputDir + "/" + set.baseName + ".agr";
+        LIVGracePlot livPlot;
+        livPlot.plot_liv(livOutputPath.toStdString(), liv, width, length);
+        files.append(livOutputPath);
+
+        if (ith && ith->canPlot()) {
+            QString ithOutputPath = outputDir + "/" + ithBaseName() + ".agr";
+            IthGracePlot ithPlot;
+            ithPlot.plot_Ith_vs_T(ithOutputPath.toStdString(), ith, width, length);
+            files.append(ithOutputPath);
+        } else {
+            qDebug() << "Skipping Ith plot: insufficient valid traces";
+        }
+    }
+
+    if (spectra) {
+        QString spectraOutputPath = outputDir + "/" + set.baseName + ".agr";
+        SpectraGracePlot spectraPlot;
+        spectraPlot.plot_spectra_waterfall(spectraOutputPath.toStdString(), spectra);
+        files.append(spectraOutputPath);
+    }
+
+    return files;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file    GraceFigureJob.h
+ * \brief   GraceFigureJob class - parses, analyses and plots one measurement set of a device
+ * \author  Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+#pragma once
+#ifndef GRACEFIGUREJOB_H
+	#define GRACEFIGUREJOB_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QByteArray>
+	#include <QVariantMap>
+	#include <QVector>
+	#include "core/dataprocessing/LIVDataProcessor.h"
+	#include "core/dataprocessing/IthDataProcessor.h"
+	#include "core/dataprocessing/SpectraDataProcessor.h"
+
+	class ProjectFile;
+
+	/**
+	 * \class GraceFigureJob
+	 * \brief The figures of one file map ("Pulsed LIV", "CW FTIR - fixed current", ...).
+	 *
+	 * The work is split into the steps parse(), analyse() and plot(), which
+	 * must be called in that order but may run on different threads, as long
+	 * as only one thread uses a job at a time. restore() replaces parse()
+	 * when the traces come from a saved project instead of the raw files. A job keeps its own copy of
+	 * the collected data and returns what it adds to it through results(),
+	 * so jobs of the same device can run concurrently.
+	 *
+	 * - L-I-V sets: analyse() fits the threshold current, plot() writes
+	 *   <mode>_liv.agr and, if enough traces have a threshold,
+	 *   Ith_vs_T_<mode>_liv.agr.
+	 * - Spectra sets: analyse() finds the emission range of the
+	 *   fixed-temperature series, plot() writes the waterfall.
+	 */
+	class GraceFigureJob
+	{
+		public:
+			/// One of the six measurement sets of a device.
+			struct FigureSet
+			{
+				QString field;          ///< File map key, e.g. "Pulsed LIV"
+				QString prefix;         ///< "pulsed" or "cw"
+				QString traceVariable;  ///< "current" or "temperature" for spectra, empty for L-I-V
+				QString baseName;       ///< Figure name without extension
+
+				bool isLIV() const { return traceVariable.isEmpty(); } ///< L-I-V rather than spectra
+			};
+
+			static const QVector<FigureSet>& figureSets(); ///< All sets, in plotting order
+
+			GraceFigureJob(const FigureSet& set, const QVariantMap& collectedData, const QString& graceFiguresDir); ///< Constructor
+			~GraceFigureJob(); ///< Deletes the parsed data
+
+			QByteArray inputHash() const; ///< SHA-1 of everything the figures depend on, empty on error
+			bool parse();        ///< Read the measurement files, false if the set is not in the data
+			bool restore(const ProjectFile& project); ///< Take the traces from a project, false if it does not hold the set
+			void analyse();      ///< Threshold fit or emission range
+			QStringList plot();  ///< Write the .agr files, returns their paths
+
+			const FigureSet& figureSet() const { return set; } ///< Set handled by this job
+			int fileCount() const { return data.value(set.field).toMap().size(); } ///< Measurement files of the set
+			const QVariantMap& results() const { return newData; } ///< Entries to add to the collected data
+
+			LIVDataProcessor *livData() const { return liv; }             ///< Parsed L-I-V data, after parse()
+			IthDataProcessor *ithData() const { return ith; }             ///< Threshold analysis, after analyse()
+			SpectraDataProcessor *spectraData() const { return spectra; } ///< Parsed spectra, after parse()
+			QString ithBaseName() const { return "Ith_vs_T_" + set.baseName; } ///< Name of the Ith(T) figure
+
+		private:
+			GraceFigureJob(const GraceFigureJob&) = delete;
+			GraceFigureJob& operator=(const GraceFigureJob&) = delete;
+
+			FigureSet set;          ///< Set handled by this job
+			QVariantMap data;       ///< Collected data of the device
+			QString outputDir;      ///< GraceFigures folder
+			double width;           ///< Ridge width [um]
+			double length;          ///< Ridge length [mm]
+			QVariantMap newData;    ///< Fit results and emission range
+
+			LIVDataProcessor *liv;         ///< L-I-V data, or null
+			IthDataProcessor *ith;         ///< Threshold analysis, or null
+			SpectraDataProcessor *spectra; ///< Spectra data, or null
+	};
+#endif // GRACEFIGUREJOB_H
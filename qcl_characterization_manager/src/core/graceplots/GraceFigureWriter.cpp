@@ -0,0 +1,71 @@
+/**
+ * \file        GraceFigureWriter.cpp
+ * \brief       Writes the Grace figures of a device from its collected data.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QDebug>
+#include "GraceFigureWriter.h"
+
+/**
+ * \brief Constructs a writer for one GraceFigures folder.
+ * \param graceFiguresDir Folder the .agr files are written to; created if missing.
+ * \param parent          Optional parent QObject.
+ */
+GraceFigureWriter::GraceFigureWriter(const QString& graceFiguresDir, QObject *parent)
+    : QObject(parent)
+    , outputDir(graceFiguresDir)
+    , fitsAdded(false)
+{
+}
+
+/**
+ * \brief Writes every figure the collected data has measurements for.
+ *
+ * \param collectedData Wizard or DataMap data; receives the threshold fit
+ *                      parameters (<mode>_I_exp_*, <mode>_J_exp_*) and the
+ *                      emission range (<mode>_ftir_fixed_temp_freq_range).
+ * \return false if the output folder cannot be created.
+ */
+bool GraceFigureWriter::write(QVariantMap& collectedData)
+{
+    files.clear();
+    jobs.clear();
+    fitsAdded = false;
+
+    QDir dir(outputDir);
+    if (!dir.exists() && !dir.mkpath(outputDir)) {
+        qWarning() << "Failed to create directory:" << outputDir;
+        return false;
+    }
+
+    QVariantMap dimensions = collectedData.value("Dimensions").toMap();
+    double w = dimensions.value("width").toDouble();
+    double l = dimensions.value("length").toDouble();
+
+    for (const GraceFigureJob::FigureSet& set : GraceFigureJob::figureSets()) {
+        QSharedPointer<GraceFigureJob> job(new GraceFigureJob(set, collectedData, outputDir));
+        if (!job->parse())
+            continue;
+
+        job->analyse();
+        files.append(job->plot());
+        jobs.append(job);
+
+        if (job->livData()) {
+            emit livWritten(set.baseName, job->livData(), w, l);
+            if (job->ithData() && job->ithData()->canPlot())
+                emit ithWritten(job->ithBaseName(), job->ithData(), w, l);
+        }
+        if (job->spectraData())
+            emit spectraWritten(set.baseName, job->spectraData());
+
+        const QVariantMap& results = job->results();
+        for (auto it = results.constBegin(); it != results.constEnd(); ++it)
+            collectedData[it.key()] = it.value();
+        if (set.isLIV() && !results.isEmpty())
+            fitsAdded = true;
+    }
+    return true;
+}
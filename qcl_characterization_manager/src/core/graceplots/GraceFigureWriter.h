@@ -0,0 +1,59 @@
+/**
+ * \file    GraceFigureWriter.h
+ * \brief   GraceFigureWriter class - writes every Grace figure of a device from its collected data
+ * \author  Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+#pragma once
+#ifndef GRACEFIGUREWRITER_H
+	#define GRACEFIGUREWRITER_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QStringList>
+	#include <QVariantMap>
+	#include <QSharedPointer>
+	#include "GraceFigureJob.h"
+
+	/**
+	 * \class GraceFigureWriter
+	 * \brief Parses the measurement files of a device and writes its .agr figures.
+	 *
+	 * For each of the six file maps present in the collected data ("Pulsed LIV",
+	 * "CW FTIR - fixed current", ...) the data is parsed and the matching figure
+	 * is written to the GraceFigures folder:
+	 * - <mode>_liv.agr and, if enough traces have a threshold, Ith_vs_T_<mode>_liv.agr
+	 * - <mode>_ftir_vs_I.agr (fixed temperature) and <mode>_ftir_vs_T.agr (fixed current)
+	 *
+	 * Threshold fits and the emission frequency range are added to the collected
+	 * data under the keys the datasheet reads. The writer uses no widgets, so it
+	 * runs the same in the wizard and in the command-line tool. The *Written()
+	 * signals are emitted directly after each figure so that other exporters
+	 * can reuse the parsed data, which is kept until the next write().
+	 *
+	 * The work of each set is done by a GraceFigureJob; WaferScheduler runs
+	 * the same jobs step by step on its thread pool.
+	 */
+	class GraceFigureWriter : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			explicit GraceFigureWriter(const QString& graceFiguresDir, QObject *parent = nullptr); ///< Constructor
+
+			bool write(QVariantMap& collectedData); ///< Write all figures, returns false if the folder cannot be created
+			const QStringList& writtenFiles() const { return files; } ///< .agr files written by the last write()
+			bool hasFitResults() const { return fitsAdded; } ///< True if write() added threshold fits to the data
+			const QList<QSharedPointer<GraceFigureJob>>& figureJobs() const { return jobs; } ///< Jobs of the last write(), with their parsed data
+
+		signals:
+			void livWritten(const QString& baseName, LIVDataProcessor *data, double width, double length); ///< L-I-V figure written
+			void ithWritten(const QString& baseName, IthDataProcessor *data, double width, double length); ///< Ith(T) figure written
+			void spectraWritten(const QString& baseName, SpectraDataProcessor *data); ///< Spectra figure written
+
+		private:
+			QString outputDir;  ///< GraceFigures folder
+			QList<QSharedPointer<GraceFigureJob>> jobs; ///< Jobs of the last run, owning the parsed data
+			QStringList files;  ///< Figures written by the last run
+			bool fitsAdded;     ///< Threshold fits were added by the last run
+	};
+#endif // GRACEFIGUREWRITER_H
@@ -10,6 +10,7 @@
 #include <iomanip>
 #include <QtConcurrent>
 #include "IthGracePlot.h"
+#include "FitResults.h"
 #include <cmath>
 #include <QVector>
 #include <iostream>
@@ -22,6 +23,7 @@
  * This function writes a Grace-formatted output file plotting experimental Ith data against temperature,
  * including an optional exponential fit curve. It automatically scales current units (A or mA) depending
  * on the data range and configures axis labels, colors, and graph layout accordingly.
+ * The fit parameters are also saved to a FitResults sidecar next to the file.
  * 
  * \param filename The path to the output Grace plot file.
  * \param data Pointer to an IthDataProcessor object providing experimental data and fit results.
@@ -83,10 +85,12 @@ void IthGracePlot::plot_Ith_vs_T(std::string filename, IthDataProcessor *data, c
 
     int numFitPoints = 50;
     auto [T_fit, Ith_fit] = data->applyExponentialFit(numFitPoints);
+    FitResults fitResults;
 
     if (!Ith_fit.isEmpty()) {
         double A, B, C0;
         data->getExponentialFitParams(A, B, C0);
+        fitResults.setExponentialFit(A, B, C0, (w * 1e-4) * (l * 0.1), convertToMilli);
 
         if (convertToMilli) {
             A *= 1000.0;
@@ -123,6 +127,9 @@ void IthGracePlot::plot_Ith_vs_T(std::string filename, IthDataProcessor *data, c
     setAxis(outfile, "y", jlabel, J_step, 1.5, "opposite", false);
 
     outfile.close();
+
+    // Written even without a fit, so a stale sidecar never outlives its figure
+    fitResults.save(FitResults::pathFor(QString::fromStdString(filename)));
 }
 
 /**
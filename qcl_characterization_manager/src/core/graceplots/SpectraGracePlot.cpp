@@ -9,11 +9,14 @@
  */
 
 #include "SpectraGracePlot.h"
+#include "FitResults.h"
 #include "core/dataprocessing/SpectraDataProcessor.h"
 #include <QVector>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <limits>
+#include <algorithm>
 
 /**
  * @brief Generates a waterfall plot of spectra data and writes it to a file.
@@ -21,7 +24,8 @@
  * This function creates a multi-trace spectra waterfall plot, where each trace
  * is vertically offset to visualize overlapping spectra. The X-axis represents
  * frequency in THz, and the Y-axis shows arbitrary units. Legends are automatically
- * generated for each trace.
+ * generated for each trace. The center and side modes of every trace are saved
+ * to a FitResults sidecar next to the file.
  *
  * @param filename The output file name where the plot data will be written.
  * @param data Pointer to the SpectraDataProcessor containing spectra data and metadata.
@@ -83,4 +87,23 @@ void SpectraGracePlot::plot_spectra_waterfall(std::string filename, SpectraDataP
     }
 
     outfile.close();
+
+    // Peak table for the datasheet, so it never has to parse the legends back
+    FitResults fitResults;
+    QVector<Peak> centerModes = data->getCenterModeData();
+    QVector<QVector<Peak>> sideModes = data->getSideModeData();
+    double f_min = std::numeric_limits<double>::max();
+    double f_max = std::numeric_limits<double>::lowest();
+    for (int i = 0; i < centerModes.size() && i < sideModes.size() && i < valueList.size(); ++i) {
+        fitResults.addTracePeaks(valueList[i], centerModes[i], sideModes[i]);
+        f_min = std::min(f_min, centerModes[i].frequency);
+        f_max = std::max(f_max, centerModes[i].frequency);
+        for (const Peak& side : sideModes[i]) {
+            f_min = std::min(f_min, side.frequency);
+            f_max = std::max(f_max, side.frequency);
+        }
+    }
+    if (!fitResults.tracePeaks().isEmpty())
+        fitResults.setFrequencyRange(f_min, f_max);
+    fitResults.save(FitResults::pathFor(QString::fromStdString(filename)));
 }
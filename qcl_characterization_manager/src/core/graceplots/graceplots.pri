@@ -1,6 +1,18 @@
 SOURCES += \
     $$PWD/GracePlot.cpp \
+    $$PWD/FitResults.cpp \
+    $$PWD/LIVGracePlot.cpp \
+    $$PWD/IthGracePlot.cpp \
+    $$PWD/SpectraGracePlot.cpp \
+    $$PWD/GraceFigureJob.cpp \
+    $$PWD/GraceFigureWriter.cpp \
 
 HEADERS += \
 	$$PWD/GracePlot.h \
+	$$PWD/FitResults.h \
+	$$PWD/LIVGracePlot.h \
+	$$PWD/IthGracePlot.h \
+	$$PWD/SpectraGracePlot.h \
+	$$PWD/GraceFigureJob.h \
+	$$PWD/GraceFigureWriter.h \
 
@@ -0,0 +1,239 @@
+/**
+ * \file        BatchManifest.cpp
+ * \brief       JSON manifest of completed device stages used to resume batch runs.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+#include "BatchManifest.h"
+
+namespace
+{
+    /// Bumped when the JSON layout changes; older manifests are ignored.
+    constexpr int manifestVersion = 1;
+
+    /// Modification time used to detect outputs replaced or deleted since the stage ran.
+    qint64 modificationTime(const QString& filePath)
+    {
+        QFileInfo info(filePath);
+        return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    }
+}
+
+/**
+ * \brief   Constructs a manifest bound to a JSON file.
+ * \param   manifestFilePath - Path of the manifest, usually from pathFor().
+ */
+BatchManifest::BatchManifest(const QString& manifestFilePath)
+    : filePath(manifestFilePath)
+{
+}
+
+/**
+ * \brief Returns the manifest location for a device directory.
+ *
+ * \param deviceDir The device output directory.
+ * \return <deviceDir>/BatchManifest.json
+ */
+QString BatchManifest::pathFor(const QString& deviceDir)
+{
+    return QDir(deviceDir).absoluteFilePath("BatchManifest.json");
+}
+
+/**
+ * \brief Reads the manifest from disk.
+ *
+ * \return true if a valid manifest was read. A missing, corrupt or
+ *         incompatible file leaves the manifest empty, so every stage runs
+ *         again.
+ */
+bool BatchManifest::load()
+{
+    entries.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    QJsonObject root = document.object();
+    if (root.value("version").toInt() != manifestVersion) {
+        qWarning() << "Ignoring incompatible batch manifest:" << filePath;
+        return false;
+    }
+
+    const QJsonObject stages = root.value("stages").toObject();
+    for (auto it = stages.begin(); it != stages.end(); ++it) {
+        QJsonObject object = it.value().toObject();
+
+        Entry entry;
+        entry.hash = object.value("sha1").toString().toLatin1();
+        entry.completed = object.value("completed").toString();
+        entry.results = object.value("results").toObject().toVariantMap();
+
+        const QJsonArray outputs = object.value("outputs").toArray();
+        for (const QJsonValue& output : outputs) {
+            QJsonObject outputObject = output.toObject();
+            entry.outputs.insert(outputObject.value("path").toString(),
+                                 qint64(outputObject.value("modified").toDouble()));
+        }
+
+        entries.insert(it.key(), entry);
+    }
+
+    return true;
+}
+
+/**
+ * \brief Writes the manifest to disk.
+ *
+ * \return true on success.
+ *
+ * QSaveFile writes to a temporary file, flushes it to disk and renames it
+ * over the old manifest, so a crash mid-write keeps the previous manifest.
+ */
+bool BatchManifest::save() const
+{
+    QJsonObject stages;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        QJsonArray outputs;
+        for (auto output = it->outputs.constBegin(); output != it->outputs.constEnd(); ++output) {
+            QJsonObject outputObject;
+            outputObject.insert("path", output.key());
+            outputObject.insert("modified", double(output.value()));
+            outputs.append(outputObject);
+        }
+
+        QJsonObject object;
+        object.insert("sha1", QString::fromLatin1(it->hash));
+        object.insert("completed", it->completed);
+        object.insert("outputs", outputs);
+        if (!it->results.isEmpty())
+            object.insert("results", QJsonObject::fromVariantMap(it->results));
+        stages.insert(it.key(), object);
+    }
+
+    QJsonObject root;
+    root.insert("version", manifestVersion);
+    root.insert("stages", stages);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write batch manifest:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+/**
+ * \brief Checks whether a stage can be skipped.
+ *
+ * \param stage     Stage name.
+ * \param inputHash Hash of the stage's current inputs.
+ * \return true if the entry matches and every output is still as written.
+ */
+bool BatchManifest::isComplete(const QString& stage, const QByteArray& inputHash) const
+{
+    auto it = entries.constFind(stage);
+    if (it == entries.constEnd() || inputHash.isEmpty() || it->hash != inputHash)
+        return false;
+
+    for (auto output = it->outputs.constBegin(); output != it->outputs.constEnd(); ++output) {
+        qint64 modified = modificationTime(absolutePath(output.key()));
+        if (modified < 0 || modified != output.value())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Returns the outputs recorded for a stage.
+ *
+ * \param stage Stage name.
+ * \return Absolute paths, empty if the stage is not recorded.
+ */
+QStringList BatchManifest::outputs(const QString& stage) const
+{
+    QStringList paths;
+    const QMap<QString, qint64> recorded = entries.value(stage).outputs;
+    for (auto it = recorded.constBegin(); it != recorded.constEnd(); ++it)
+        paths.append(absolutePath(it.key()));
+    return paths;
+}
+
+/**
+ * \brief Returns the values a stage added to the collected data.
+ *
+ * \param stage Stage name.
+ * \return e.g. the threshold fit of a figure stage, empty if none.
+ */
+QVariantMap BatchManifest::results(const QString& stage) const
+{
+    return entries.value(stage).results;
+}
+
+/**
+ * \brief Records a completed stage.
+ *
+ * \param stage     Stage name.
+ * \param inputHash Hash of the inputs the stage ran on.
+ * \param outputs   The files it wrote; they must exist.
+ * \param results   Values it added to the collected data.
+ * \return false if an output is missing; the stage is then forgotten, so
+ *         the next run redoes it.
+ */
+bool BatchManifest::record(const QString& stage, const QByteArray& inputHash, const QStringList& outputs,
+                           const QVariantMap& results)
+{
+    Entry entry;
+    entry.hash = inputHash;
+    entry.completed = QDateTime::currentDateTime().toString(Qt::ISODate);
+    entry.results = results;
+    for (const QString& output : outputs) {
+        qint64 modified = modificationTime(output);
+        if (modified < 0) {
+            qWarning() << "Not recording stage" << stage << "- missing output:" << output;
+            entries.remove(stage);
+            return false;
+        }
+        entry.outputs.insert(relativePath(output), modified);
+    }
+
+    entries.insert(stage, entry);
+    return true;
+}
+
+/**
+ * \brief Forgets a stage, so the next run redoes it.
+ *
+ * \param stage Stage name.
+ */
+void BatchManifest::remove(const QString& stage)
+{
+    entries.remove(stage);
+}
+
+/**
+ * \brief Expresses a path relative to the folder holding the manifest.
+ */
+QString BatchManifest::relativePath(const QString& path) const
+{
+    return QFileInfo(filePath).absoluteDir().relativeFilePath(QFileInfo(path).absoluteFilePath());
+}
+
+/**
+ * \brief Resolves a manifest-relative path.
+ */
+QString BatchManifest::absolutePath(const QString& relative) const
+{
+    return QDir::cleanPath(QFileInfo(filePath).absoluteDir().absoluteFilePath(relative));
+}
@@ -0,0 +1,73 @@
+/**
+ * @file BatchManifest.h
+ * @brief Declaration of BatchManifest, the record of which stages of a device are done.
+ *
+ * The manifest lives in the device directory and maps every completed stage
+ * to the hash of its inputs and the outputs it produced, so an interrupted
+ * batch can be restarted without redoing finished work.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef BATCHMANIFEST_H
+	#define BATCHMANIFEST_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QByteArray>
+	#include <QVariantMap>
+	#include <QMap>
+
+	/**
+	 * @class BatchManifest
+	 * @brief Persistent map of stage -> input hash, outputs and results.
+	 *
+	 * Stored as JSON in <deviceDir>/BatchManifest.json. Stages are named by
+	 * the caller ("figures/pulsed_liv", "convert", "datasheet", ...). An
+	 * entry is written only after its stage succeeded, and the file is
+	 * replaced atomically, so a batch killed at any point leaves either the
+	 * previous or the new manifest on disk, never a partial one.
+	 *
+	 * A stage is complete when its input hash matches the entry and every
+	 * recorded output still exists with the modification time it had when
+	 * the stage finished; a stage with a missing output is never recorded.
+	 * Failed stages are removed, so a restart retries exactly the stages
+	 * that failed, never ran, or whose inputs changed.
+	 * Paths are kept relative to the device directory, as in
+	 * ConversionManifest, so a device folder can be moved.
+	 */
+	class BatchManifest
+	{
+		public:
+			explicit BatchManifest(const QString& manifestFilePath = QString()); ///< Constructor, does not read the file
+
+			static QString pathFor(const QString& deviceDir); ///< Manifest location for a device directory
+
+			bool load();  ///< Read the manifest; a missing or unreadable file gives an empty manifest
+			bool save() const; ///< Atomically write the manifest
+
+			bool isComplete(const QString& stage, const QByteArray& inputHash) const; ///< True if the stage can be skipped
+			QStringList outputs(const QString& stage) const; ///< Recorded outputs of a stage, absolute
+			QVariantMap results(const QString& stage) const; ///< Values the stage added to the collected data
+			bool record(const QString& stage, const QByteArray& inputHash, const QStringList& outputs,
+						const QVariantMap& results = QVariantMap()); ///< Store a completed stage whose outputs all exist
+			void remove(const QString& stage); ///< Forget a stage, e.g. after it failed
+
+		private:
+			/// One completed stage.
+			struct Entry
+			{
+				QByteArray hash;               ///< SHA-1 of the stage inputs (hex)
+				QString completed;             ///< ISO timestamp of completion
+				QMap<QString, qint64> outputs; ///< Output path -> modification time (ms since epoch)
+				QVariantMap results;           ///< Values added to the collected data
+			};
+
+			QString relativePath(const QString& filePath) const; ///< Path relative to the device directory
+			QString absolutePath(const QString& relative) const; ///< Path resolved against the device directory
+
+			QString filePath;              ///< Manifest JSON file
+			QMap<QString, Entry> entries;  ///< Stage name -> entry
+	};
+#endif // BATCHMANIFEST_H
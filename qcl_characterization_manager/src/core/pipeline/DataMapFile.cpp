@@ -0,0 +1,224 @@
+/**
+ * \file        DataMapFile.cpp
+ * \brief       Reads and writes the collected data saved in a <Sample>_DataMap.txt file.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+#include <algorithm>
+#include "DataMapFile.h"
+
+/**
+ * \brief Keys of the six file pages, saved as path -> value maps.
+ */
+const QStringList& DataMapFile::fileMapKeys()
+{
+    static const QStringList keys = {
+        "Pulsed LIV",
+        "CW LIV",
+        "Pulsed FTIR - fixed temperature",
+        "Pulsed FTIR - fixed current",
+        "CW FTIR - fixed temperature",
+        "CW FTIR - fixed current"
+    };
+    return keys;
+}
+
+/**
+ * \brief Finds the DataMap file of a device.
+ *
+ * \param deviceDir Device output directory.
+ * \return Absolute path of the first *_DataMap.txt by name, or an empty string.
+ */
+QString DataMapFile::find(const QString& deviceDir)
+{
+    QDir dir(deviceDir);
+    QStringList dataMaps = dir.entryList({ "*_DataMap.txt" }, QDir::Files, QDir::Name);
+    return dataMaps.isEmpty() ? QString() : dir.absoluteFilePath(dataMaps.first());
+}
+
+/**
+ * \brief Finds the device directories below a folder.
+ *
+ * \param rootDir A device directory, or a folder holding one directory per device.
+ * \return rootDir itself and each direct subfolder that contain a *_DataMap.txt, sorted by name.
+ */
+QStringList DataMapFile::findDeviceDirectories(const QString& rootDir)
+{
+    QStringList deviceDirs;
+    const QStringList dataMapFilter = { "*_DataMap.txt" };
+
+    QDir root(rootDir);
+    if (!root.entryList(dataMapFilter, QDir::Files).isEmpty())
+        deviceDirs.append(root.absolutePath());
+
+    const QStringList subDirs = root.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString& subDir : subDirs) {
+        QDir dir(root.absoluteFilePath(subDir));
+        if (!dir.entryList(dataMapFilter, QDir::Files).isEmpty())
+            deviceDirs.append(dir.absolutePath());
+    }
+    return deviceDirs;
+}
+
+/**
+ * \brief Reads the collected data of a device from its DataMap file.
+ *
+ * \param filePath DataMap file.
+ * \param error    Receives the reason of a failure, may be null.
+ * \return The collected data as the wizard produced it, or an empty map.
+ *
+ * All keys end in the same column, which is taken from the first entry. A
+ * line with " = " in that column starts a new entry; other lines belong to
+ * the preceding file map, or continue a multi-line value such as the
+ * experimental notes. In a file map line the value is the text after the
+ * last space, since the path is padded with spaces to align the values.
+ * Values are returned as strings, the dimensions as doubles.
+ */
+QVariantMap DataMapFile::read(const QString& filePath, QString *error)
+{
+    QVariantMap params;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = "Cannot read " + filePath;
+        return params;
+    }
+
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty())
+        lines.removeLast();
+
+    QVariantMap dimensions;
+    QVariantMap fileMap;
+    QString fileMapKey;  // file map being read
+    QString lastKey;     // value continued by unindented lines
+    int equalsColumn = -1;
+
+    auto isEntry = [&equalsColumn](const QString& line) {
+        bool equals = line.mid(equalsColumn, 3) == " = "
+                      || (line.length() == equalsColumn + 2 && line.endsWith(" ="));
+        return equals && !line.left(equalsColumn).trimmed().isEmpty();
+    };
+
+    for (const QString& line : lines) {
+        if (equalsColumn < 0) {
+            // header and blank lines before the first entry
+            equalsColumn = line.indexOf(" = ");
+            if (equalsColumn < 0 && line.endsWith(" ="))
+                equalsColumn = line.length() - 2;
+            if (equalsColumn < 0)
+                continue;
+        }
+
+        if (isEntry(line)) {
+            if (!fileMapKey.isEmpty())
+                params[fileMapKey] = fileMap;
+            fileMapKey.clear();
+            lastKey.clear();
+
+            QString key = line.left(equalsColumn).trimmed();
+            QString value = line.mid(equalsColumn + 3);
+
+            if (key == "Width" || key == "Length" || key == "Height") {
+                dimensions[key.toLower()] = value.trimmed().toDouble();
+            } else if (fileMapKeys().contains(key)) {
+                fileMapKey = key;
+                fileMap.clear();
+            } else {
+                params[key] = value;
+                lastKey = key;
+            }
+            continue;
+        }
+
+        if (!fileMapKey.isEmpty()) {
+            QString entry = line.mid(equalsColumn + 5);
+            int split = entry.lastIndexOf(' ');
+            QString path = split < 0 ? entry : entry.left(split);
+            while (path.endsWith(' '))
+                path.chop(1);
+            if (!path.isEmpty())
+                fileMap[path] = split < 0 ? QString() : entry.mid(split + 1);
+        } else if (!lastKey.isEmpty()) {
+            params[lastKey] = params.value(lastKey).toString() + "\n" + line;
+        }
+    }
+
+    if (!fileMapKey.isEmpty())
+        params[fileMapKey] = fileMap;
+    if (!dimensions.isEmpty())
+        params["Dimensions"] = dimensions;
+
+    if (params.isEmpty() && error)
+        *error = "Empty DataMap file " + filePath;
+    return params;
+}
+
+/**
+ * \brief Saves collected data in the DataMap format.
+ *
+ * \param filePath      DataMap file, replaced only once it is completely written.
+ * \param collectedData Wizard data, with "Dimensions" and the file maps as QVariantMaps.
+ * \return true on success.
+ */
+bool DataMapFile::write(const QString& filePath, const QVariantMap& collectedData)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream out(&file);
+
+    out << "\n=== Collected Data ===\n";
+
+    // Compute max key length for alignment
+    int maxKeyWidth = 0;
+    for (auto it = collectedData.constBegin(); it != collectedData.constEnd(); ++it) {
+        if (it.key().length() > maxKeyWidth)
+            maxKeyWidth = it.key().length();
+    }
+
+    // Column where paths start for file maps
+    const int pathColumn = maxKeyWidth + 5;
+
+    for (auto it = collectedData.constBegin(); it != collectedData.constEnd(); ++it) {
+        const QString &key = it.key();
+        const QVariant &value = it.value();
+
+        if (key == "Dimensions") {
+            QVariantMap dimensions = value.toMap();
+            double w = dimensions.value("width").toDouble();
+            double l = dimensions.value("length").toDouble();
+            double h = dimensions.value("height").toDouble();
+
+            out << QString("%1 = %2\n").arg("Width", maxKeyWidth).arg(w);
+            out << QString("%1 = %2\n").arg("Length", maxKeyWidth).arg(l);
+            out << QString("%1 = %2\n").arg("Height", maxKeyWidth).arg(h);
+        } else if (fileMapKeys().contains(key)) {
+            // Print key with '=' on its own line
+            out << QString("%1 = \n").arg(key, maxKeyWidth);
+
+            QVariantMap fileMap = value.toMap();
+
+            // Find longest path for neat alignment
+            int maxPathLen = 0;
+            for (auto mit = fileMap.constBegin(); mit != fileMap.constEnd(); ++mit)
+                maxPathLen = std::max(maxPathLen, int(mit.key().length()));
+
+            // Output each path and value aligned
+            for (auto mit = fileMap.constBegin(); mit != fileMap.constEnd(); ++mit) {
+                QString pathPadded = mit.key().leftJustified(maxPathLen, ' ');
+                out << QString(pathColumn, ' ') << pathPadded << " " << mit.value().toString() << "\n";
+            }
+        } else {
+            out << QString("%1 = %2\n").arg(key, maxKeyWidth).arg(value.toString());
+        }
+    }
+
+    out.flush();
+    return file.commit();
+}
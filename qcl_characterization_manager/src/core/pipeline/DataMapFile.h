@@ -0,0 +1,35 @@
+/**
+ * @file DataMapFile.h
+ * @brief Declaration of DataMapFile, which reads and writes the <Sample>_DataMap.txt of a device.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef DATAMAPFILE_H
+	#define DATAMAPFILE_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QVariantMap>
+
+	/**
+	 * @class DataMapFile
+	 * @brief Saves the collected data of the wizard and reads it back.
+	 *
+	 * The file has one right-aligned "key = value" line per entry, the
+	 * dimensions as Width/Length/Height, and each file map as a "key = " line
+	 * followed by one indented "path value" line per file. read() returns the
+	 * same map the wizard wrote, so a device can be processed again without
+	 * going through the wizard.
+	 */
+	class DataMapFile
+	{
+		public:
+			static QString find(const QString& deviceDir); ///< The *_DataMap.txt of a device directory, empty if none
+			static QStringList findDeviceDirectories(const QString& rootDir); ///< Root and subfolders holding a *_DataMap.txt
+			static QVariantMap read(const QString& filePath, QString *error = nullptr); ///< Collected data saved in a DataMap file
+			static bool write(const QString& filePath, const QVariantMap& collectedData); ///< Save collected data
+			static const QStringList& fileMapKeys(); ///< Keys whose values are path -> value maps
+	};
+#endif // DATAMAPFILE_H
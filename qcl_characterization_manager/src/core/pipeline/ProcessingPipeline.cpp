@@ -0,0 +1,225 @@
+/**
+ * \file        ProcessingPipeline.cpp
+ * \brief       Processes one device from collected data to datasheet without any UI.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include "ProcessingPipeline.h"
+#include "core/graceplots/GraceFigureWriter.h"
+#include "core/project/AnalyticsExporter.h"
+#include "core/datasheetgenerator/DataSheetGenerator.h"
+#include "core/datasheetgenerator/LatexBuilder.h"
+
+/**
+ * \brief   Constructs an idle pipeline running all stages.
+ * \param   parent - Optional parent QObject.
+ *
+ * Only the PDF figures are produced by default, since the datasheet needs
+ * nothing else; see setOutputProfiles().
+ */
+ProcessingPipeline::ProcessingPipeline(QObject *parent)
+    : QObject(parent)
+    , stages(AllStages)
+    , pdflatexPath(LatexBuilder::defaultPdflatexPath())
+    , maxJobs(0)
+    , outputProfiles(FileConverter::PdfOutput)
+    , running(false)
+    , failedFigures(0)
+{
+}
+
+/**
+ * \brief Starts processing one device.
+ *
+ * \param collectedData Wizard, DataMap or configuration data of the device.
+ * \param outputDir     Device output directory; GraceFigures, Figures and the
+ *                      datasheet are written below it.
+ *
+ * Returns immediately; the first stage starts from the event loop.
+ */
+void ProcessingPipeline::run(const QVariantMap& collectedData, const QString& outputDir)
+{
+    if (running) {
+        qWarning() << "Processing already in progress for:" << this->outputDir;
+        return;
+    }
+
+    this->collectedData = collectedData;
+    this->outputDir = QDir(outputDir).absolutePath();
+    running = true;
+    failedFigures = 0;
+
+    QMetaObject::invokeMethod(this, [this]() { nextStage(Stage(0)); }, Qt::QueuedConnection);
+}
+
+/**
+ * \brief Starts the first requested stage after the given one, or finishes.
+ *
+ * \param done The stage that just ended, or 0 before the first stage.
+ */
+void ProcessingPipeline::nextStage(Stage done)
+{
+    if (int(done) < int(FigureStage) && stages.testFlag(FigureStage)) {
+        if (runFigures())
+            nextStage(FigureStage);
+        return;
+    }
+
+    if (int(done) < int(ConversionStage) && stages.testFlag(ConversionStage)) {
+        startConversion();
+        return;
+    }
+
+    if (int(done) < int(DataSheetStage) && stages.testFlag(DataSheetStage)) {
+        startDataSheet();
+        return;
+    }
+
+    if (failedFigures > 0)
+        finish(false, QString("%1 figure(s) failed to convert").arg(failedFigures));
+    else
+        finish(true, stages.testFlag(DataSheetStage) ? dataSheetPath() : outputDir);
+}
+
+/**
+ * \brief Parses the measurements and writes the Grace figures.
+ *
+ * With setAnalyticsDir(), the traces and results are also exported as
+ * columns; a failed export is reported but does not stop the run.
+ *
+ * \return false if the run was aborted.
+ */
+bool ProcessingPipeline::runFigures()
+{
+    beginStage("Writing Grace figures");
+
+    GraceFigureWriter writer(outputDir + "/GraceFigures");
+    if (!writer.write(collectedData)) {
+        finish(false, "Cannot create " + outputDir + "/GraceFigures");
+        return false;
+    }
+
+    if (writer.writtenFiles().isEmpty())
+        qWarning() << "No measurement files in the collected data of" << outputDir;
+
+    // The export streams from the parsed data, so it runs while the writer still holds it
+    if (!analyticsDir.isEmpty()) {
+        AnalyticsExporter exporter(analyticsDir);
+        exporter.setParameters(collectedData);
+        for (const QSharedPointer<GraceFigureJob>& job : writer.figureJobs())
+            exporter.addJob(*job);
+        if (!exporter.write())
+            qWarning() << "Analytics export failed:" << analyticsDir;
+    }
+
+    endStage();
+    return true;
+}
+
+/**
+ * \brief Converts every .agr file in GraceFigures.
+ *
+ * Unchanged figures are skipped by FileConverter's manifest. A figure that
+ * fails does not stop the run; the datasheet leaves it out and the run is
+ * reported as failed at the end.
+ */
+void ProcessingPipeline::startConversion()
+{
+    beginStage("Converting figures");
+
+    FileConverter *converter = new FileConverter(this);
+    converter->setOutputProfiles(outputProfiles);
+    if (maxJobs > 0)
+        converter->setMaxConcurrentJobs(maxJobs);
+
+    connect(converter, &FileConverter::progressChanged, this, &ProcessingPipeline::progressChanged);
+    connect(converter, &FileConverter::figureConverted, this, [this](const QString& agrFilePath, bool success) {
+        if (!success) {
+            ++failedFigures;
+            qWarning() << "Failed to convert" << agrFilePath;
+        }
+    });
+    connect(converter, &FileConverter::conversionFinished, this, [this, converter]() {
+        converter->deleteLater();
+        endStage();
+        nextStage(ConversionStage);
+    });
+
+    converter->processAgrFilesToPsAndPdf(outputDir + "/GraceFigures");
+}
+
+/**
+ * \brief Writes LaserDataSheet.tex and compiles it.
+ */
+void ProcessingPipeline::startDataSheet()
+{
+    beginStage("Generating datasheet");
+
+    QString texPath = outputDir + "/LaserDataSheet.tex";
+
+    QMap<QString, QString> pulsedMetadata;
+    QMap<QString, QString> cwMetadata;
+    DataSheetGenerator::splitMeasurementMetadata(collectedData, pulsedMetadata, cwMetadata);
+
+    QFile::remove(texPath);  // so a failed write is not hidden by an old file
+    DataSheetGenerator generator(texPath, collectedData);
+    generator.setMeasurementMetadata(pulsedMetadata, cwMetadata);
+    generator.generate();
+
+    if (!QFile::exists(texPath)) {
+        finish(false, "Failed to write " + texPath);
+        return;
+    }
+
+    if (!QFile::exists(pdflatexPath)) {
+        finish(false, "pdflatex not found: " + pdflatexPath);
+        return;
+    }
+
+    LatexBuilder *builder = new LatexBuilder(pdflatexPath, this);
+    builder->setFormatCacheDir(formatCacheDir);
+    connect(builder, &LatexBuilder::finished, this, [this, builder](bool success, const QString& /*pdfPath*/, int /*passes*/) {
+        builder->deleteLater();
+        endStage();
+        if (!success) {
+            finish(false, "pdflatex failed, see " + outputDir + "/LaserDataSheet.log");
+            return;
+        }
+        nextStage(DataSheetStage);
+    });
+    builder->build(texPath, DataSheetGenerator::preamble());
+}
+
+/**
+ * \brief Reports the start of a stage and starts its timer.
+ */
+void ProcessingPipeline::beginStage(const QString& description)
+{
+    currentStage = description;
+    stageTimer.start();
+    emit stageStarted(description);
+}
+
+/**
+ * \brief Reports the end of the current stage with its duration.
+ */
+void ProcessingPipeline::endStage()
+{
+    emit stageFinished(currentStage, stageTimer.elapsed());
+    currentStage.clear();
+}
+
+/**
+ * \brief Ends the run.
+ *
+ * \param success true if every requested stage succeeded.
+ * \param message Datasheet or output path on success, otherwise the reason.
+ */
+void ProcessingPipeline::finish(bool success, const QString& message)
+{
+    running = false;
+    emit finished(success, message);
+}
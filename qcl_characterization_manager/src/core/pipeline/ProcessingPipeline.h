@@ -0,0 +1,98 @@
+/**
+ * @file ProcessingPipeline.h
+ * @brief Declaration of ProcessingPipeline, which processes one device without any UI.
+ *
+ * Runs the same steps as the wizard's Grace page: parsing and analysis,
+ * Grace figures, conversion to PDF and the LaTeX datasheet.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef PROCESSINGPIPELINE_H
+	#define PROCESSINGPIPELINE_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QVariantMap>
+	#include <QElapsedTimer>
+	#include "core/fileconversion/FileConverter.h"
+
+	/**
+	 * @class ProcessingPipeline
+	 * @brief Takes collected data to a compiled datasheet using only QtCore.
+	 *
+	 * Stages, each optional:
+	 * 1. FigureStage: GraceFigureWriter parses the measurement files, fits the
+	 *    thresholds and writes <out>/GraceFigures/*.agr.
+	 * 2. ConversionStage: FileConverter turns every .agr in GraceFigures into
+	 *    <out>/Figures/*.pdf (and any raster tiers requested).
+	 * 3. DataSheetStage: DataSheetGenerator writes <out>/LaserDataSheet.tex
+	 *    and LatexBuilder compiles it.
+	 *
+	 * Skipped stages use what an earlier run left in the output directory, so
+	 * e.g. the datasheet can be rebuilt from existing figures alone. The
+	 * pipeline is asynchronous and needs a running event loop; finished() is
+	 * emitted exactly once per run().
+	 */
+	class ProcessingPipeline : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			/// Steps of a run; combine as Stages.
+			enum Stage
+			{
+				FigureStage     = 0x1, ///< Parse, analyse and write the Grace figures
+				ConversionStage = 0x2, ///< Convert the Grace figures
+				DataSheetStage  = 0x4, ///< Generate and compile the datasheet
+				AllStages       = FigureStage | ConversionStage | DataSheetStage
+			};
+			Q_DECLARE_FLAGS(Stages, Stage)
+
+			explicit ProcessingPipeline(QObject *parent = nullptr); ///< Constructor
+
+			void setStages(Stages stages) { this->stages = stages; } ///< Stages run by run() (default all)
+			void setPdflatexPath(const QString& path) { pdflatexPath = path; } ///< pdflatex for the datasheet
+			void setFormatCacheDir(const QString& dir) { formatCacheDir = dir; } ///< Shared precompiled preamble folder
+			void setMaxConcurrentJobs(int count) { maxJobs = count; } ///< Conversion pool size, 0 for one per core
+			void setOutputProfiles(FileConverter::OutputProfiles profiles) { outputProfiles = profiles; } ///< Conversion outputs (default PDF)
+			void setAnalyticsDir(const QString& dir) { analyticsDir = dir; } ///< Export the traces and results as columns, empty for none
+
+			void run(const QVariantMap& collectedData, const QString& outputDir); ///< Start processing one device
+			bool isRunning() const { return running; } ///< True until finished() is emitted
+			const QVariantMap& data() const { return collectedData; } ///< Collected data with the analysis results
+			QString dataSheetPath() const { return outputDir + "/LaserDataSheet.pdf"; } ///< PDF written by the datasheet stage
+
+		signals:
+			void stageStarted(const QString& description); ///< A stage begins
+			void progressChanged(int completed, int total); ///< Figures converted so far
+			void stageFinished(const QString& description, qint64 elapsedMs); ///< A stage ended
+			void finished(bool success, const QString& message); ///< The run is over
+
+		private:
+			bool runFigures(); ///< Figure stage, synchronous
+			void startConversion(); ///< Conversion stage
+			void startDataSheet(); ///< Datasheet stage
+			void nextStage(Stage done); ///< Start the stage after done
+			void beginStage(const QString& description); ///< Report and time a stage
+			void endStage(); ///< Report the time of the current stage
+			void finish(bool success, const QString& message); ///< Emit finished()
+
+			Stages stages;            ///< Stages to run
+			QString pdflatexPath;     ///< pdflatex executable
+			QString formatCacheDir;   ///< Shared format folder, empty for none
+			int maxJobs;              ///< Conversion pool size, 0 for default
+			FileConverter::OutputProfiles outputProfiles; ///< Conversion outputs
+			QString analyticsDir;     ///< Columnar export folder, empty for none
+
+			QVariantMap collectedData; ///< Data of the device being processed
+			QString outputDir;         ///< Device output directory
+			bool running;              ///< A run is in progress
+			int failedFigures;         ///< Figures that failed to convert
+			QString currentStage;      ///< Description of the running stage
+			QElapsedTimer stageTimer;  ///< Time of the running stage
+	};
+
+	Q_DECLARE_OPERATORS_FOR_FLAGS(ProcessingPipeline::Stages)
+#endif // PROCESSINGPIPELINE_H
@@ -0,0 +1,702 @@
+/**
+ * \file        WaferScheduler.cpp
+ * \brief       Processes many devices as stage tasks on a work-stealing pool.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTextStream>
+#include <QCryptographicHash>
+#include <QDebug>
+#include "WaferScheduler.h"
+#include "DataMapFile.h"
+#include "core/graceplots/GraceFigureJob.h"
+#include "core/datasheetgenerator/DataSheetGenerator.h"
+#include "core/datasheetgenerator/LatexBuilder.h"
+
+namespace
+{
+    /// Name of the datasheet written into every device directory.
+    const QString dataSheetName = "LaserDataSheet";
+
+    /// Tasks assumed per device before any DataMap has been read.
+    const int defaultDeviceTasks = 20;
+
+    /// Files a figure converts to, named as FileConverter names them.
+    QStringList conversionOutputs(const QString& deviceDir, const QString& agrFilePath,
+                                  FileConverter::OutputProfiles profiles)
+    {
+        QString figuresDir = deviceDir + "/Figures";
+        QString baseName = QFileInfo(agrFilePath).baseName();
+
+        QStringList outputs;
+        if (profiles & FileConverter::PdfOutput)
+            outputs.append(figuresDir + "/" + baseName + ".pdf");
+        for (FileConverter::OutputProfile tier : { FileConverter::PrintTier, FileConverter::PreviewTier, FileConverter::ThumbnailTier }) {
+            if (profiles & tier)
+                outputs.append(FileConverter::tierDirectory(figuresDir, tier) + "/" + baseName + ".png");
+        }
+        return outputs;
+    }
+
+    /// Manifest stage of a measurement set.
+    QString figureStage(const GraceFigureJob& job)
+    {
+        return "figures/" + job.figureSet().baseName;
+    }
+}
+
+/**
+ * \brief   Constructs an idle scheduler.
+ * \param   parent      - Optional parent QObject.
+ * \param   threadCount - Pool threads, 0 for one per core.
+ *
+ * The pool gets one thread per core by default and the external stages one process per
+ * core. pdflatex builds are limited to half the cores, since each one holds
+ * a whole TeX installation in memory.
+ */
+WaferScheduler::WaferScheduler(QObject *parent, int threadCount)
+    : QObject(parent)
+    , pool(threadCount > 0 ? threadCount : QThread::idealThreadCount())
+    , maxProcesses(qMax(1, QThread::idealThreadCount()))
+    , maxBuilds(qMax(1, QThread::idealThreadCount() / 2))
+    , pdflatexPath(LatexBuilder::defaultPdflatexPath())
+    , outputProfiles(FileConverter::PdfOutput)
+    , resume(true)
+    , processesInUse(0)
+    , buildsRunning(0)
+    , buildsDone(0)
+    , devicesDone(0)
+    , tasksDone(0)
+    , runElapsedMs(0)
+    , running(false)
+    , cancelled(false)
+{
+}
+
+/**
+ * \brief Drops queued tasks and waits for the running ones, whose results are discarded.
+ */
+WaferScheduler::~WaferScheduler()
+{
+    cancelled = true;
+    pool.clear();
+    pool.waitForDone();
+}
+
+/**
+ * \brief Names a stage for reports.
+ */
+QString WaferScheduler::stageName(Stage stage)
+{
+    switch (stage) {
+    case ParseStage:     return "parse";
+    case AnalyseStage:   return "analyse";
+    case PlotStage:      return "plot";
+    case ConvertStage:   return "convert";
+    case DataSheetStage: return "datasheet";
+    default:             return QString();
+    }
+}
+
+/**
+ * \brief Starts processing.
+ *
+ * \param deviceDirs Device output directories, each holding a *_DataMap.txt.
+ *
+ * Returns immediately; deviceFinished() is emitted per device and
+ * finished() once all of them are done.
+ */
+void WaferScheduler::run(const QStringList& deviceDirs)
+{
+    if (running) {
+        qWarning() << "Wafer run already in progress";
+        return;
+    }
+
+    results.clear();
+    states.clear();
+    conversionQueue.clear();
+    dataSheetQueue.clear();
+    for (const QString& deviceDir : deviceDirs) {
+        DeviceResult result;
+        result.deviceDir = QDir(deviceDir).absolutePath();
+        result.stageMs.fill(0, StageCount);
+        results.append(result);
+        states.append(DeviceState());
+    }
+
+    processesInUse = 0;
+    buildsRunning = 0;
+    buildsDone = 0;
+    devicesDone = 0;
+    tasksDone = 0;
+    stageBusyMs.fill(0, StageCount);
+    runElapsedMs = 0;
+    cancelled = false;
+    running = true;
+    runTimer.start();
+
+    if (results.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this]() {
+            running = false;
+            emit finished(0, 0);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    for (int i = 0; i < results.size(); ++i)
+        submitLoad(i);
+}
+
+/**
+ * \brief Queues reading a device's DataMap on the pool.
+ */
+void WaferScheduler::submitLoad(int index)
+{
+    const QString deviceDir = results[index].deviceDir;
+
+    pool.submit([this, index, deviceDir]() {
+        if (cancelled)
+            return;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QString error;
+        QVariantMap data;
+        QString dataMapPath = DataMapFile::find(deviceDir);
+        if (dataMapPath.isEmpty())
+            error = "No *_DataMap.txt found";
+        else
+            data = DataMapFile::read(dataMapPath, &error);
+
+        BatchManifest manifest(BatchManifest::pathFor(deviceDir));
+        if (resume)
+            manifest.load();
+
+        qint64 elapsedMs = timer.elapsed();
+        QMetaObject::invokeMethod(this, [=]() { onLoaded(index, data, manifest, error, elapsedMs); }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * \brief Queues one step of a measurement set on the pool.
+ *
+ * \param manifest Copy of the device's manifest, used by the parse step to
+ *                 skip a set whose figures are recorded as up to date.
+ *
+ * Called from a pool thread for every step after the first, so the step
+ * lands on that thread's deque.
+ */
+void WaferScheduler::submitStep(int index, QSharedPointer<GraceFigureJob> job, Stage stage, const BatchManifest& manifest)
+{
+    pool.submit([this, index, job, stage, manifest]() {
+        if (cancelled)
+            return;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QStringList files;
+        QByteArray inputHash;
+        bool parsed = true;
+        bool reused = false;
+        if (stage == ParseStage) {
+            inputHash = job->inputHash();
+            reused = manifest.isComplete(figureStage(*job), inputHash);
+            if (reused)
+                files = manifest.outputs(figureStage(*job));
+            else
+                parsed = job->parse();
+        } else if (stage == AnalyseStage) {
+            job->analyse();
+        } else {
+            files = job->plot();
+        }
+
+        qint64 elapsedMs = timer.elapsed();
+
+        // Only one thread uses a job at a time: the next step is queued once this one is done
+        if (stage != PlotStage && parsed && !reused)
+            submitStep(index, job, Stage(stage + 1));
+
+        QMetaObject::invokeMethod(this, [=]() { onStepFinished(index, job, stage, elapsedMs, files, inputHash, reused); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+/**
+ * \brief Plans the figure tasks of a device once its DataMap is read.
+ */
+void WaferScheduler::onLoaded(int index, const QVariantMap& data, const BatchManifest& manifest,
+                              const QString& error, qint64 elapsedMs)
+{
+    DeviceState& state = states[index];
+    if (state.phase == Phase::Done)
+        return;
+
+    state.timer.start();
+    state.tasks = 1;
+    countTask(index, ParseStage, elapsedMs);
+
+    if (data.isEmpty()) {
+        finishDevice(index, false, error);
+        return;
+    }
+
+    QString graceFiguresDir = results[index].deviceDir + "/GraceFigures";
+    if (!QDir().mkpath(graceFiguresDir)) {
+        finishDevice(index, false, "Cannot create " + graceFiguresDir);
+        return;
+    }
+
+    state.data = data;
+    state.manifest = manifest;
+    state.phase = Phase::Figures;
+
+    QList<QSharedPointer<GraceFigureJob>> jobs;
+    for (const GraceFigureJob::FigureSet& set : GraceFigureJob::figureSets()) {
+        if (data.contains(set.field))
+            jobs.append(QSharedPointer<GraceFigureJob>::create(set, data, graceFiguresDir));
+    }
+
+    // Three steps per set, about one conversion per figure (two for L-I-V), and the datasheet
+    for (const QSharedPointer<GraceFigureJob>& job : jobs)
+        state.tasks += 3 + (job->figureSet().isLIV() ? 2 : 1);
+    state.tasks += 1;
+    state.setsPending = jobs.size();
+
+    if (jobs.isEmpty()) {
+        qWarning() << "No measurement files in the DataMap of" << results[index].deviceDir;
+        onFiguresDone(index);
+        return;
+    }
+
+    for (const QSharedPointer<GraceFigureJob>& job : jobs)
+        submitStep(index, job, ParseStage, state.manifest);
+    reportProgress();
+}
+
+/**
+ * \brief Accounts for a finished figure step; queues the conversion after the last set.
+ *
+ * A set is done after its plot step, or after its parse step if the
+ * manifest already had its figures (\p reused). Plotted sets are recorded
+ * in the manifest right away, so a crash later on keeps them.
+ */
+void WaferScheduler::onStepFinished(int index, QSharedPointer<GraceFigureJob> job, Stage stage, qint64 elapsedMs,
+                                    const QStringList& files, const QByteArray& inputHash, bool reused)
+{
+    DeviceState& state = states[index];
+    if (state.phase != Phase::Figures)
+        return;  // cancelled or failed meanwhile
+
+    countTask(index, stage, elapsedMs);
+    const QString manifestStage = figureStage(*job);
+
+    if (stage == ParseStage)
+        state.setHashes[manifestStage] = inputHash;
+
+    QVariantMap newData;
+    if (reused) {
+        state.tasks -= 2;  // analyse and plot
+        ++results[index].resumedStages;
+        newData = state.manifest.results(manifestStage);
+    } else if (stage == PlotStage) {
+        newData = job->results();
+        state.manifest.record(manifestStage, state.setHashes.value(manifestStage), files, newData);
+        saveManifest(index);
+    } else {
+        reportProgress();
+        return;
+    }
+
+    for (auto it = newData.constBegin(); it != newData.constEnd(); ++it)
+        state.data[it.key()] = it.value();
+    state.figures.append(files);
+
+    if (--state.setsPending > 0) {
+        reportProgress();
+        return;
+    }
+
+    onFiguresDone(index);
+    reportProgress();
+}
+
+/**
+ * \brief Queues a device's conversion once all its figures are written.
+ *
+ * The conversion's inputs are the figures, which follow from the set
+ * hashes; if the manifest has a conversion of the same sets, the device
+ * goes straight to its datasheet.
+ */
+void WaferScheduler::onFiguresDone(int index)
+{
+    DeviceState& state = states[index];
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(int(outputProfiles)));
+    for (auto it = state.setHashes.constBegin(); it != state.setHashes.constEnd(); ++it)
+        hash.addData(it.key().toUtf8() + '=' + it.value() + ';');
+    state.conversionHash = hash.result().toHex();
+
+    if (state.manifest.isComplete("convert", state.conversionHash)) {
+        state.tasks = state.tasksDone + 1;  // only the datasheet is left
+        ++results[index].resumedStages;
+        state.phase = Phase::Building;
+        dataSheetQueue.enqueue(index);
+    } else {
+        state.phase = Phase::Converting;
+        conversionQueue.enqueue(index);
+    }
+    startExternalStages();
+}
+
+/**
+ * \brief Starts datasheet builds and conversions while process slots are free.
+ */
+void WaferScheduler::startExternalStages()
+{
+    if (cancelled)
+        return;
+
+    // Until one build has cached the preamble format, builds run one at a time
+    int buildLimit = maxBuilds;
+    if (buildsDone == 0 && !formatCacheDir.isEmpty()
+        && !QFile::exists(LatexBuilder::cachedFormatPath(formatCacheDir, pdflatexPath, DataSheetGenerator::preamble())))
+        buildLimit = 1;
+
+    while (!dataSheetQueue.isEmpty() && processesInUse < maxProcesses && buildsRunning < buildLimit)
+        startDataSheet(dataSheetQueue.dequeue());
+
+    while (!conversionQueue.isEmpty() && processesInUse < maxProcesses)
+        startConversion(conversionQueue.dequeue());
+}
+
+/**
+ * \brief Converts the figures of a device with as many process slots as are free.
+ */
+void WaferScheduler::startConversion(int index)
+{
+    DeviceState& state = states[index];
+    QElapsedTimer timer;
+    timer.start();
+
+    int slots = qMin(maxProcesses - processesInUse, qMax(1, state.figures.size()));
+    processesInUse += slots;
+    conversionSlots[index] = slots;
+
+    FileConverter *converter = new FileConverter(this);
+    converter->setOutputProfiles(outputProfiles);
+    converter->setMaxConcurrentJobs(slots);
+    converters[index] = converter;
+
+    connect(converter, &FileConverter::figureConverted, this, [this, index](const QString& agrFilePath, bool success) {
+        if (!success) {
+            ++states[index].failedFigures;
+            qWarning() << "Failed to convert" << agrFilePath;
+        }
+        countTask(index, ConvertStage, 0);
+        reportProgress();
+    });
+    connect(converter, &FileConverter::conversionFinished, this, [this, index, converter, timer]() {
+        qint64 elapsedMs = timer.elapsed();
+        converter->deleteLater();
+        converters.remove(index);
+        processesInUse -= conversionSlots.take(index);
+
+        DeviceState& state = states[index];
+        results[index].stageMs[ConvertStage] += elapsedMs;
+        stageBusyMs[ConvertStage] += elapsedMs;
+        state.tasks = state.tasksDone + 1;  // the conversion count was an estimate
+
+        if (state.failedFigures == 0 && !cancelled) {
+            QStringList outputs;
+            for (const QString& agrFilePath : state.figures)
+                outputs.append(conversionOutputs(results[index].deviceDir, agrFilePath, outputProfiles));
+            state.manifest.record("convert", state.conversionHash, outputs);
+        } else {
+            state.manifest.remove("convert");
+        }
+        saveManifest(index);
+
+        if (cancelled) {
+            finishDevice(index, false, "Cancelled");
+        } else {
+            state.phase = Phase::Building;
+            dataSheetQueue.enqueue(index);
+        }
+        startExternalStages();
+    });
+
+    converter->processAgrFilesToPsAndPdf(results[index].deviceDir + "/GraceFigures");
+}
+
+/**
+ * \brief Writes a device's .tex file and starts compiling it.
+ */
+void WaferScheduler::startDataSheet(int index)
+{
+    DeviceState& state = states[index];
+    QString texPath = results[index].deviceDir + "/" + dataSheetName + ".tex";
+
+    QMap<QString, QString> pulsedMetadata;
+    QMap<QString, QString> cwMetadata;
+    DataSheetGenerator::splitMeasurementMetadata(state.data, pulsedMetadata, cwMetadata);
+
+    QFile::remove(texPath);  // so a failed write is not hidden by an old file
+    DataSheetGenerator generator(texPath, state.data);
+    generator.setMeasurementMetadata(pulsedMetadata, cwMetadata);
+    generator.generate();
+
+    if (!QFile::exists(texPath)) {
+        finishDevice(index, false, "Failed to write " + texPath);
+        return;
+    }
+
+    // The .tex holds every value of the datasheet; the figures follow from the conversion
+    QByteArray inputHash;
+    QFile texFile(texPath);
+    if (texFile.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(&texFile);
+        hash.addData(state.conversionHash);
+        inputHash = hash.result().toHex();
+    }
+
+    if (state.failedFigures == 0 && state.manifest.isComplete("datasheet", inputHash)
+        && !state.manifest.outputs("datasheet").isEmpty()) {
+        countTask(index, DataSheetStage, 0);
+        ++results[index].resumedStages;
+        results[index].pdfPath = state.manifest.outputs("datasheet").first();
+        finishDevice(index, true, QString());
+        return;
+    }
+
+    if (!QFile::exists(pdflatexPath)) {
+        finishDevice(index, false, "pdflatex not found: " + pdflatexPath);
+        return;
+    }
+
+    ++processesInUse;
+    ++buildsRunning;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    LatexBuilder *builder = new LatexBuilder(pdflatexPath, this);
+    builder->setFormatCacheDir(formatCacheDir);
+    connect(builder, &LatexBuilder::finished, this, [this, index, builder, timer, inputHash](bool success, const QString& pdfPath, int /*passes*/) {
+        qint64 elapsedMs = timer.elapsed();
+        builder->deleteLater();
+        --processesInUse;
+        --buildsRunning;
+        ++buildsDone;
+
+        countTask(index, DataSheetStage, elapsedMs);
+
+        int failedFigures = states[index].failedFigures;
+        if (success && failedFigures == 0)
+            states[index].manifest.record("datasheet", inputHash, { pdfPath });
+        else
+            states[index].manifest.remove("datasheet");
+        saveManifest(index);
+
+        if (!success)
+            finishDevice(index, false, "pdflatex failed, see " + dataSheetName + ".log");
+        else if (failedFigures > 0)
+            finishDevice(index, false, QString("%1 figure(s) failed to convert").arg(failedFigures));
+        else {
+            results[index].pdfPath = pdfPath;
+            finishDevice(index, true, QString());
+        }
+        startExternalStages();
+    });
+    builder->build(texPath, DataSheetGenerator::preamble());
+}
+
+/**
+ * \brief Writes a device's manifest; a failed write only costs a redo on resume.
+ */
+void WaferScheduler::saveManifest(int index)
+{
+    if (!states[index].manifest.save())
+        qWarning() << "Stages of" << results[index].deviceDir << "will run again on resume";
+}
+
+/**
+ * \brief Adds a finished task to the device and run totals.
+ */
+void WaferScheduler::countTask(int index, Stage stage, qint64 elapsedMs)
+{
+    ++states[index].tasksDone;
+    ++tasksDone;
+    results[index].stageMs[stage] += elapsedMs;
+    stageBusyMs[stage] += elapsedMs;
+}
+
+/**
+ * \brief Records a device's result, frees its data and reports the end of the run.
+ */
+void WaferScheduler::finishDevice(int index, bool success, const QString& error)
+{
+    DeviceState& state = states[index];
+    if (state.phase == Phase::Done)
+        return;
+
+    state.phase = Phase::Done;
+    state.data.clear();
+    state.figures.clear();
+    state.manifest = BatchManifest();
+    state.tasks = state.tasksDone;
+
+    DeviceResult& result = results[index];
+    result.success = success;
+    result.error = error;
+    result.elapsedMs = state.timer.isValid() ? state.timer.elapsed() : 0;
+
+    ++devicesDone;
+    emit deviceFinished(result.deviceDir, success, devicesDone, results.size());
+    reportProgress();
+
+    if (devicesDone == results.size()) {
+        runElapsedMs = runTimer.elapsed();
+        running = false;
+
+        int succeeded = 0;
+        for (const DeviceResult& r : results)
+            succeeded += r.success ? 1 : 0;
+        emit finished(succeeded, results.size() - succeeded);
+    }
+}
+
+/**
+ * \brief Drops queued work and fails the devices that have not reached an external stage.
+ *
+ * Running conversions are cancelled; running pdflatex builds finish and are
+ * reported normally. finished() is emitted once they are all done.
+ */
+void WaferScheduler::cancel()
+{
+    if (!running)
+        return;
+
+    cancelled = true;
+    pool.clear();
+
+    QList<int> queued = conversionQueue + dataSheetQueue;
+    conversionQueue.clear();
+    dataSheetQueue.clear();
+
+    for (int i = 0; i < states.size(); ++i) {
+        Phase phase = states[i].phase;
+        if (phase == Phase::Converting && converters.contains(i))
+            converters[i]->cancel();  // reported from conversionFinished
+        else if (phase == Phase::Waiting || phase == Phase::Figures || queued.contains(i))
+            finishDevice(i, false, "Cancelled");
+    }
+}
+
+/**
+ * \brief Estimates the stage tasks of the whole run.
+ *
+ * Devices whose DataMap has not been read count as the average of those
+ * that have.
+ */
+int WaferScheduler::estimatedTasks() const
+{
+    int known = 0;
+    int knownTasks = 0;
+    for (const DeviceState& state : states) {
+        if (state.tasks > 0) {
+            ++known;
+            knownTasks += state.tasks;
+        }
+    }
+
+    int perUnknown = known > 0 ? (knownTasks + known - 1) / known : defaultDeviceTasks;
+    return knownTasks + (states.size() - known) * perUnknown;
+}
+
+/**
+ * \brief Devices finished per minute of wall time so far.
+ */
+double WaferScheduler::devicesPerMinute() const
+{
+    qint64 elapsedMs = running ? runTimer.elapsed() : runElapsedMs;
+    return elapsedMs > 0 ? devicesDone * 60000.0 / elapsedMs : 0.0;
+}
+
+/**
+ * \brief Remaining tasks divided by the task rate so far.
+ *
+ * \return Milliseconds, 0 once finished, -1 before the first task.
+ */
+qint64 WaferScheduler::etaMs() const
+{
+    if (!running)
+        return 0;
+    if (tasksDone == 0)
+        return -1;
+
+    int remaining = qMax(0, estimatedTasks() - tasksDone);
+    return qint64(double(runTimer.elapsed()) * remaining / tasksDone);
+}
+
+/**
+ * \brief Emits progressChanged() with the current figures.
+ */
+void WaferScheduler::reportProgress()
+{
+    emit progressChanged(tasksDone, qMax(tasksDone, estimatedTasks()), devicesPerMinute(), etaMs());
+}
+
+/**
+ * \brief Formats the results of the run.
+ *
+ * \return Totals, throughput and the time spent per stage, then one line
+ *         per device with its status, time and PDF path or failure reason.
+ */
+QString WaferScheduler::summary() const
+{
+    int succeeded = 0;
+    int nameWidth = 0;
+    for (const DeviceResult& result : results) {
+        succeeded += result.success ? 1 : 0;
+        nameWidth = qMax(nameWidth, int(result.deviceDir.length()));
+    }
+
+    QString report;
+    QTextStream out(&report);
+    out << "=== Wafer Processing Report ===\n";
+    out << "Date: " << QDateTime::currentDateTime().toString("dd-MM-yyyy hh:mm:ss") << "\n";
+    out << "Threads: " << pool.threadCount() << ", process limit: " << maxProcesses
+        << ", parallel datasheets: " << maxBuilds << "\n";
+    out << "Devices: " << results.size() << ", succeeded: " << succeeded
+        << ", failed: " << results.size() - succeeded
+        << ", wall time: " << QString::number(runElapsedMs / 1000.0, 'f', 1) << " s"
+        << ", " << QString::number(devicesPerMinute(), 'f', 1) << " devices/min\n";
+    int resumedStages = 0;
+    for (const DeviceResult& result : results)
+        resumedStages += result.resumedStages;
+    out << "Tasks: " << tasksDone << ", stolen: " << pool.stolenCount()
+        << ", stages reused from manifests: " << resumedStages << "\n";
+
+    out << "Task time:";
+    for (int stage = 0; stage < StageCount; ++stage)
+        out << " " << stageName(Stage(stage)) << " " << QString::number(stageBusyMs.value(stage) / 1000.0, 'f', 1) << " s";
+    out << "\n\n";
+
+    for (const DeviceResult& result : results) {
+        out << result.deviceDir.leftJustified(nameWidth) << "  "
+            << (result.success ? "OK    " : "FAILED") << "  "
+            << QString::number(result.elapsedMs / 1000.0, 'f', 1).rightJustified(7) << " s  "
+            << (result.success ? result.pdfPath : result.error) << "\n";
+    }
+    return report;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file WaferScheduler.h
+ * @brief Declaration of WaferScheduler, which processes many devices as a pool of stage tasks.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef WAFERSCHEDULER_H
+	#define WAFERSCHEDULER_H
+
+	#include <QObject>
+	#include <QString>
+	#include <QStringList>
+	#include <QVector>
+	#include <QVariantMap>
+	#include <QQueue>
+	#include <QHash>
+	#include <QSharedPointer>
+	#include <QElapsedTimer>
+	#include <atomic>
+	#include "WorkStealingPool.h"
+	#include "BatchManifest.h"
+	#include "core/fileconversion/FileConverter.h"
+
+	class GraceFigureJob;
+
+	/**
+	 * @class WaferScheduler
+	 * @brief Takes every device of a wafer from its DataMap to a compiled datasheet.
+	 *
+	 * Each device is split into stage tasks:
+	 * 1. Parse: read the DataMap, then the files of each measurement set.
+	 * 2. Analyse: threshold fit or emission range of each set.
+	 * 3. Plot: the .agr figures of each set.
+	 * 4. Convert: FileConverter turns the device's figures into PDFs.
+	 * 5. DataSheet: DataSheetGenerator and LatexBuilder.
+	 *
+	 * Parse, analyse and plot run as separate GraceFigureJob steps on a
+	 * WorkStealingPool. The next step of a set is queued on the thread that
+	 * ran the previous one, and idle threads steal queued steps. A device
+	 * with a few small files therefore finishes quickly, even when a device
+	 * with hundreds of spectra was submitted before it.
+	 *
+	 * Convert and DataSheet start external processes. They are started from
+	 * the owning thread's event loop and share one limit on running processes
+	 * (setMaxProcesses()). A conversion takes as many process slots as it has
+	 * figures, up to what is free; a pdflatex build takes one. Devices go
+	 * through these stages in the order their figures became ready, and
+	 * datasheets go before new conversions so that started devices finish
+	 * first. While the shared preamble format is not cached yet, only one
+	 * datasheet builds at a time, as in BatchDataSheetRunner.
+	 *
+	 * Every device keeps a BatchManifest. Each measurement set, the
+	 * conversion and the datasheet are recorded with the hash of their
+	 * inputs once they succeed, and a later run over the same devices skips
+	 * whatever is recorded and still valid: a set whose measurement files
+	 * are unchanged is not parsed or plotted, and so on down the stages. A
+	 * batch that died half way therefore resumes where it stopped, and only
+	 * failed or stale stages run again. setResume(false) ignores the
+	 * manifests but still rewrites them.
+	 *
+	 * Progress is reported as a task count, a device rate and an ETA. The
+	 * ETA divides the remaining tasks by the task rate so far; devices whose
+	 * DataMap has not been read yet count as the average device.
+	 */
+	class WaferScheduler : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			/// Stages of a device, in order.
+			enum Stage
+			{
+				ParseStage,     ///< DataMap and measurement files
+				AnalyseStage,   ///< Threshold fits and emission ranges
+				PlotStage,      ///< Grace figures
+				ConvertStage,   ///< Figure conversion (external)
+				DataSheetStage, ///< Datasheet build (external)
+				StageCount
+			};
+
+			/**
+			 * @struct DeviceResult
+			 * @brief Outcome of one device.
+			 */
+			struct DeviceResult {
+				QString deviceDir;        ///< Device output directory
+				QString pdfPath;          ///< Datasheet PDF, empty if none was produced
+				bool success = false;     ///< True if every stage succeeded
+				QString error;            ///< Reason of a failure
+				qint64 elapsedMs = 0;     ///< Wall time from the first task to the end
+				QVector<qint64> stageMs;  ///< Time spent per Stage
+				int resumedStages = 0;    ///< Manifest stages reused instead of run
+			};
+
+			explicit WaferScheduler(QObject *parent = nullptr, int threadCount = 0); ///< Constructor, 0 threads for one per core
+			~WaferScheduler() override; ///< Drops queued tasks and waits for running ones
+
+			void setMaxProcesses(int count) { maxProcesses = qMax(1, count); } ///< Limit on external processes
+			int maxProcessCount() const { return maxProcesses; } ///< Limit on external processes
+			void setMaxDataSheetBuilds(int count) { maxBuilds = qMax(1, count); } ///< Limit on concurrent pdflatex builds
+			void setPdflatexPath(const QString& path) { pdflatexPath = path; } ///< pdflatex for the datasheets
+			void setFormatCacheDir(const QString& dir) { formatCacheDir = dir; } ///< Shared precompiled preamble folder
+			void setOutputProfiles(FileConverter::OutputProfiles profiles) { outputProfiles = profiles; } ///< Conversion outputs (default PDF)
+			void setResume(bool enabled) { resume = enabled; } ///< Skip stages recorded as done (default true)
+			int threadCount() const { return pool.threadCount(); } ///< Threads running parse, analyse and plot
+
+			void run(const QStringList& deviceDirs); ///< Start processing
+			bool isRunning() const { return running; } ///< True until finished() is emitted
+			const QVector<DeviceResult>& deviceResults() const { return results; } ///< Results, in input order
+
+			int completedTasks() const { return tasksDone; } ///< Stage tasks done so far
+			int estimatedTasks() const; ///< Estimated stage tasks of the whole run
+			double devicesPerMinute() const; ///< Device throughput so far
+			qint64 etaMs() const; ///< Estimated time to completion, -1 if unknown
+
+			QString summary() const; ///< Text report of all devices and stages
+			static QString stageName(Stage stage); ///< "parse", "analyse", ...
+
+		public slots:
+			void cancel(); ///< Drop queued work; running processes are stopped or finish
+
+		signals:
+			void deviceFinished(const QString& deviceDir, bool success, int completed, int total); ///< One device is done
+			void progressChanged(int completedTasks, int estimatedTasks, double devicesPerMinute, qint64 etaMs); ///< After every task
+			void finished(int succeeded, int failed); ///< All devices are done
+
+		private:
+			/// Where a device is.
+			enum class Phase { Waiting, Figures, Converting, Building, Done };
+
+			/// Work state of one device, next to its DeviceResult.
+			struct DeviceState {
+				Phase phase = Phase::Waiting; ///< Current phase
+				QVariantMap data;             ///< Collected data, dropped when done
+				int setsPending = 0;          ///< Measurement sets not plotted yet
+				QStringList figures;          ///< .agr files written
+				int failedFigures = 0;        ///< Figures that failed to convert
+				int tasks = 0;                ///< Expected stage tasks, 0 before the DataMap is read
+				int tasksDone = 0;            ///< Stage tasks done
+				QElapsedTimer timer;          ///< Started with the first task
+				BatchManifest manifest;       ///< Completed stages of the device
+				QMap<QString, QByteArray> setHashes; ///< Input hash of each measurement set
+				QByteArray conversionHash;    ///< Input hash of the conversion
+			};
+
+			void submitLoad(int index); ///< Queue reading a DataMap
+			void submitStep(int index, QSharedPointer<GraceFigureJob> job, Stage stage,
+							const BatchManifest& manifest = BatchManifest()); ///< Queue a figure step
+			void onLoaded(int index, const QVariantMap& data, const BatchManifest& manifest,
+						  const QString& error, qint64 elapsedMs); ///< DataMap read
+			void onStepFinished(int index, QSharedPointer<GraceFigureJob> job, Stage stage, qint64 elapsedMs,
+								const QStringList& files, const QByteArray& inputHash, bool reused); ///< Figure step done
+			void onFiguresDone(int index); ///< Queue the conversion, or skip it if recorded
+			void saveManifest(int index); ///< Write a device's manifest
+			void startExternalStages(); ///< Start conversions and builds up to the limits
+			void startConversion(int index); ///< Convert a device's figures
+			void startDataSheet(int index); ///< Write and build a device's datasheet
+			void countTask(int index, Stage stage, qint64 elapsedMs); ///< Account for a finished task
+			void finishDevice(int index, bool success, const QString& error); ///< Record a device's result
+			void reportProgress(); ///< Emit progressChanged()
+
+			WorkStealingPool pool;       ///< Threads of the parse, analyse and plot steps
+			int maxProcesses;            ///< Limit on external processes
+			int maxBuilds;               ///< Limit on concurrent pdflatex builds
+			QString pdflatexPath;        ///< pdflatex executable
+			QString formatCacheDir;      ///< Shared format folder, empty for none
+			FileConverter::OutputProfiles outputProfiles; ///< Conversion outputs
+			bool resume;                 ///< Read the manifests before running
+
+			QVector<DeviceResult> results;   ///< One entry per device
+			QVector<DeviceState> states;     ///< One entry per device
+			QQueue<int> conversionQueue;     ///< Devices whose figures are written
+			QQueue<int> dataSheetQueue;      ///< Devices whose figures are converted
+			QHash<int, FileConverter*> converters; ///< Conversions in flight, by device
+			QHash<int, int> conversionSlots; ///< Process slots held by each conversion
+			int processesInUse;              ///< Slots held by conversions and builds
+			int buildsRunning;               ///< pdflatex builds in flight
+			int buildsDone;                  ///< pdflatex builds finished
+			int devicesDone;                 ///< Devices finished
+			int tasksDone;                   ///< Stage tasks finished
+			QVector<qint64> stageBusyMs;     ///< Summed task time per Stage
+			QElapsedTimer runTimer;          ///< Wall time of the run
+			qint64 runElapsedMs;             ///< Wall time once finished
+			bool running;                    ///< A run is in progress
+			std::atomic<bool> cancelled;     ///< Set by cancel(), read by pool threads
+	};
+#endif // WAFERSCHEDULER_H
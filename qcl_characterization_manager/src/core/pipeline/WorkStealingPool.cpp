@@ -0,0 +1,172 @@
+/**
+ * \file        WorkStealingPool.cpp
+ * \brief       Thread pool with per-thread deques and work stealing.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "WorkStealingPool.h"
+
+namespace
+{
+    /// Index of the pool thread running the current code, -1 elsewhere.
+    thread_local int currentWorker = -1;
+
+    /// Pool owning currentWorker, so nested pools do not mix up their indices.
+    thread_local const WorkStealingPool *currentPool = nullptr;
+}
+
+/**
+ * \brief   Starts the threads.
+ * \param   threadCount - Number of threads, at least one.
+ */
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : queued(0)
+    , pending(0)
+    , stolen(0)
+    , nextWorker(0)
+    , stopping(false)
+{
+    threadCount = qMax(1, threadCount);
+    for (int i = 0; i < threadCount; ++i)
+        workers.append(new Worker);
+
+    for (int i = 0; i < threadCount; ++i) {
+        workers[i]->thread = QThread::create([this, i]() { run(i); });
+        workers[i]->thread->start();
+    }
+}
+
+/**
+ * \brief Drops queued tasks, waits for running ones and joins the threads.
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    clear();
+    {
+        QMutexLocker locker(&stateMutex);
+        stopping = true;
+    }
+    workAvailable.wakeAll();
+
+    // Join every thread before freeing any deque, since idle threads still look for work to steal
+    for (Worker *worker : workers)
+        worker->thread->wait();
+    for (Worker *worker : workers) {
+        delete worker->thread;
+        delete worker;
+    }
+}
+
+/**
+ * \brief Queues a task.
+ *
+ * From a pool thread the task goes to that thread's own deque, otherwise to
+ * the next deque in turn.
+ */
+void WorkStealingPool::submit(Task task)
+{
+    int index = currentPool == this ? currentWorker : int(nextWorker++ % unsigned(workers.size()));
+
+    ++pending;
+    {
+        QMutexLocker locker(&workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+
+    QMutexLocker locker(&stateMutex);
+    ++queued;
+    workAvailable.wakeOne();
+}
+
+/**
+ * \brief Drops every queued task; running tasks are not affected.
+ */
+void WorkStealingPool::clear()
+{
+    int dropped = 0;
+    for (Worker *worker : workers) {
+        QMutexLocker locker(&worker->mutex);
+        dropped += int(worker->tasks.size());
+        worker->tasks.clear();
+    }
+
+    QMutexLocker locker(&stateMutex);
+    queued -= dropped;
+    if ((pending -= dropped) == 0)
+        allDone.wakeAll();
+}
+
+/**
+ * \brief Blocks until no task is queued or running.
+ *
+ * Must not be called from a pool thread.
+ */
+void WorkStealingPool::waitForDone()
+{
+    QMutexLocker locker(&stateMutex);
+    while (pending.load() > 0)
+        allDone.wait(&stateMutex);
+}
+
+/**
+ * \brief Takes the next task for a thread.
+ *
+ * \param index Thread asking.
+ * \param task  Receives the task.
+ * \return false if every deque is empty.
+ */
+bool WorkStealingPool::take(int index, Task& task)
+{
+    {
+        Worker *own = workers[index];
+        QMutexLocker locker(&own->mutex);
+        if (!own->tasks.empty()) {
+            task = std::move(own->tasks.front());
+            own->tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the other end, starting with the next thread along
+    for (int offset = 1; offset < workers.size(); ++offset) {
+        Worker *victim = workers[(index + offset) % workers.size()];
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+            ++stolen;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Thread body: runs tasks until the pool is destroyed.
+ */
+void WorkStealingPool::run(int index)
+{
+    currentWorker = index;
+    currentPool = this;
+
+    forever {
+        Task task;
+        if (take(index, task)) {
+            --queued;
+            task();
+
+            if (--pending == 0) {
+                QMutexLocker locker(&stateMutex);
+                allDone.wakeAll();
+            }
+            continue;
+        }
+
+        QMutexLocker locker(&stateMutex);
+        if (stopping)
+            return;
+        // queued can briefly be below zero while a submit is between its push and its count
+        if (queued.load() <= 0)
+            workAvailable.wait(&stateMutex);
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file WorkStealingPool.h
+ * @brief Declaration of WorkStealingPool, a thread pool with one task queue per thread.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef WORKSTEALINGPOOL_H
+	#define WORKSTEALINGPOOL_H
+
+	#include <QMutex>
+	#include <QWaitCondition>
+	#include <QVector>
+	#include <QThread>
+	#include <atomic>
+	#include <deque>
+	#include <functional>
+
+	/**
+	 * @class WorkStealingPool
+	 * @brief Runs short tasks on a fixed set of threads that steal from each other.
+	 *
+	 * Every thread owns a deque. A task submitted from one of the pool's own
+	 * threads goes to that thread's deque, so follow-up work stays on the
+	 * thread whose caches hold its data; tasks submitted from elsewhere are
+	 * spread round-robin. A thread works through its own deque oldest first
+	 * and, once it is empty, steals the newest task of another thread, so a
+	 * thread that drew small tasks does not idle while another one still has
+	 * a long queue.
+	 *
+	 * Tasks must not block on each other. The destructor drops queued tasks
+	 * and waits for running ones.
+	 */
+	class WorkStealingPool
+	{
+		public:
+			using Task = std::function<void()>; ///< Unit of work
+
+			explicit WorkStealingPool(int threadCount = QThread::idealThreadCount()); ///< Starts the threads
+			~WorkStealingPool(); ///< Drops queued tasks and joins the threads
+
+			void submit(Task task); ///< Queue a task
+			void clear(); ///< Drop every queued task
+			void waitForDone(); ///< Block until no task is queued or running
+			int threadCount() const { return workers.size(); } ///< Number of threads
+			int stolenCount() const { return stolen.load(); } ///< Tasks run by another thread than they were queued on
+
+		private:
+			WorkStealingPool(const WorkStealingPool&) = delete;
+			WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+			/// One thread and its queue.
+			struct Worker
+			{
+				QMutex mutex;            ///< Guards tasks
+				std::deque<Task> tasks;  ///< Queued tasks, oldest first
+				QThread *thread = nullptr; ///< Thread running run()
+			};
+
+			void run(int index); ///< Thread body
+			bool take(int index, Task& task); ///< Own oldest task, or another thread's newest
+
+			QVector<Worker*> workers;       ///< One per thread
+			QMutex stateMutex;              ///< Guards sleeping, waiting and stopping
+			QWaitCondition workAvailable;   ///< Signalled when a task is queued
+			QWaitCondition allDone;         ///< Signalled when the pool drains
+			std::atomic<int> queued;        ///< Tasks in the deques
+			std::atomic<int> pending;       ///< Tasks queued or running
+			std::atomic<int> stolen;        ///< Tasks run after a steal
+			std::atomic<unsigned> nextWorker; ///< Round-robin target of outside submissions
+			bool stopping;                  ///< Set by the destructor
+	};
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,13 @@
+SOURCES += \
+    $$PWD/BatchManifest.cpp \
+    $$PWD/DataMapFile.cpp \
+    $$PWD/ProcessingPipeline.cpp \
+    $$PWD/WaferScheduler.cpp \
+    $$PWD/WorkStealingPool.cpp
+
+HEADERS += \
+    $$PWD/BatchManifest.h \
+    $$PWD/DataMapFile.h \
+    $$PWD/ProcessingPipeline.h \
+    $$PWD/WaferScheduler.h \
+    $$PWD/WorkStealingPool.h
@@ -0,0 +1,496 @@
+/**
+ * \file        AnalyticsExporter.cpp
+ * \brief       Writes the traces and extracted parameters of a device as memory-mappable .npy columns.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "AnalyticsExporter.h"
+#include "core/graceplots/GraceFigureJob.h"
+#include "core/dataprocessing/LIVDataProcessor.h"
+#include "core/dataprocessing/IthDataProcessor.h"
+#include "core/dataprocessing/SpectraDataProcessor.h"
+
+namespace
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    /// numpy dtype of a column in the byte order of this machine.
+    QString dtype(char kind)
+    {
+        const char byteOrder = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? '<' : '>';
+        return QString(kind == 'i' ? "%1i4" : "%1f8").arg(QLatin1Char(byteOrder));
+    }
+
+    /**
+     * npy 1.0 header of a 1-D array. The dictionary is padded with spaces so
+     * that the data starts on a 64 byte boundary, as numpy itself does.
+     */
+    QByteArray npyHeader(const QString& descr, qint64 rows)
+    {
+        QByteArray dictionary = QString("{'descr': '%1', 'fortran_order': False, 'shape': (%2,), }")
+                                    .arg(descr).arg(rows).toLatin1();
+        const int preamble = 10;  // magic, version and header length
+        int total = preamble + dictionary.size() + 1;
+        dictionary.append(QByteArray((64 - total % 64) % 64, ' '));
+        dictionary.append('\n');
+
+        QByteArray header("\x93NUMPY\x01\x00", 8);
+        header.append(char(dictionary.size() & 0xff));
+        header.append(char((dictionary.size() >> 8) & 0xff));
+        return header + dictionary;
+    }
+
+    /**
+     * One .npy column, written through QSaveFile so a failed export never
+     * leaves a half-written file behind an old, valid one.
+     */
+    class ColumnFile
+    {
+        public:
+            ColumnFile(const QString& filePath, const QString& descr, qint64 rows)
+                : file(filePath), rows(rows)
+            {
+                QByteArray header = npyHeader(descr, rows);
+                ok = file.open(QIODevice::WriteOnly) && file.write(header) == header.size();
+            }
+
+            /// Appends the first \p count values of \p values, padding with NaN if it is shorter.
+            void append(const QVector<double>& values, qint64 count)
+            {
+                qint64 available = qMin<qint64>(values.size(), count);
+                writeRaw(values.constData(), available);
+                fill(nan, count - available);
+            }
+
+            /// Appends \p count copies of a value.
+            template<typename T>
+            void fill(T value, qint64 count)
+            {
+                if (count <= 0)
+                    return;
+                const std::vector<T> block(size_t(qMin<qint64>(count, 4096)), value);
+                for (qint64 done = 0; done < count; done += qint64(block.size()))
+                    writeRaw(block.data(), qMin<qint64>(count - done, qint64(block.size())));
+            }
+
+            bool commit()
+            {
+                if (ok && written != rows) {
+                    qWarning() << "Column" << file.fileName() << "has" << written << "of" << rows << "rows";
+                    ok = false;
+                }
+                if (!ok) {
+                    qWarning() << "Failed to write analytics column:" << file.fileName() << file.errorString();
+                    file.cancelWriting();
+                    return false;
+                }
+                return file.commit();
+            }
+
+        private:
+            template<typename T>
+            void writeRaw(const T *data, qint64 count)
+            {
+                if (!ok || count <= 0)
+                    return;
+                qint64 size = count * qint64(sizeof(T));
+                ok = file.write(reinterpret_cast<const char*>(data), size) == size;
+                written += count;
+            }
+
+            QSaveFile file;
+            qint64 rows;
+            qint64 written = 0;
+            bool ok = false;
+    };
+
+    /**
+     * Columns of one table, opened with the row count known up front so the
+     * headers can be written before the data is streamed in.
+     */
+    class Table
+    {
+        public:
+            Table(const QDir& dir, const QString& name, qint64 rows)
+                : dir(dir), name(name), rows(rows)
+            {
+            }
+
+            ColumnFile& column(const QString& columnName, char kind, const QString& unit, const QString& description)
+            {
+                QString fileName = name + "." + columnName + ".npy";
+                QString descr = dtype(kind);
+                files.emplace_back(new ColumnFile(dir.absoluteFilePath(fileName), descr, rows));
+
+                QJsonObject column;
+                column.insert("name", columnName);
+                column.insert("file", fileName);
+                column.insert("dtype", descr);
+                column.insert("unit", unit);
+                column.insert("description", description);
+                columns.append(column);
+                return *files.back();
+            }
+
+            /// Commits every column and returns the table's entry of the schema.
+            bool commit(QJsonObject& schema)
+            {
+                bool ok = true;
+                for (const std::unique_ptr<ColumnFile>& file : files)
+                    ok = file->commit() && ok;
+
+                QJsonObject table;
+                table.insert("rows", double(rows));
+                table.insert("columns", columns);
+                schema.insert(name, table);
+                return ok;
+            }
+
+        private:
+            QDir dir;
+            QString name;
+            qint64 rows;
+            std::vector<std::unique_ptr<ColumnFile>> files;
+            QJsonArray columns;
+    };
+
+    /// Numeric trace value, NaN if the label is not a number.
+    double traceValue(const QString& label)
+    {
+        bool ok = false;
+        double value = label.toDouble(&ok);
+        return ok ? value : nan;
+    }
+
+    /**
+     * Free spectral range of one spectrum: the median spacing of its centre
+     * and side modes, NaN if fewer than two modes were found.
+     */
+    double freeSpectralRange(const Peak& center, const QVector<Peak>& sideModes)
+    {
+        std::vector<double> frequencies;
+        frequencies.reserve(size_t(sideModes.size()) + 1);
+        frequencies.push_back(center.frequency);
+        for (const Peak& peak : sideModes)
+            frequencies.push_back(peak.frequency);
+        if (frequencies.size() < 2)
+            return nan;
+
+        std::sort(frequencies.begin(), frequencies.end());
+        std::vector<double> spacings;
+        for (size_t i = 1; i < frequencies.size(); ++i)
+            spacings.push_back(frequencies[i] - frequencies[i - 1]);
+
+        auto middle = spacings.begin() + spacings.size() / 2;
+        std::nth_element(spacings.begin(), middle, spacings.end());
+        if (spacings.size() % 2 == 1)
+            return *middle;
+        double upper = *middle;
+        double lower = *std::max_element(spacings.begin(), middle);
+        return 0.5 * (lower + upper);
+    }
+}
+
+/**
+ * \brief   Constructs an empty export.
+ * \param   directory - Folder receiving the columns, usually from directoryFor().
+ */
+AnalyticsExporter::AnalyticsExporter(const QString& directory)
+    : directory(QDir(directory).absolutePath())
+    , width(0.0)
+    , length(0.0)
+{
+}
+
+/**
+ * \brief Returns the default export location of a device.
+ *
+ * \param outputDir Device output directory.
+ * \return <outputDir>/Analytics
+ */
+QString AnalyticsExporter::directoryFor(const QString& outputDir)
+{
+    return QDir(outputDir).absoluteFilePath("Analytics");
+}
+
+/**
+ * \brief Takes the sample name and the ridge dimensions from the collected data.
+ *
+ * The dimensions turn Ith into Jth; without them Jth is NaN.
+ */
+void AnalyticsExporter::setParameters(const QVariantMap& collectedData)
+{
+    sampleName = collectedData.value("Sample Name").toString();
+    QVariantMap dimensions = collectedData.value("Dimensions").toMap();
+    width = dimensions.value("width").toDouble();
+    length = dimensions.value("length").toDouble();
+}
+
+/**
+ * \brief Adds the processors of a measurement set.
+ *
+ * \param job A job whose analyse() has run; it must outlive write().
+ */
+void AnalyticsExporter::addJob(const GraceFigureJob& job)
+{
+    const QString name = job.figureSet().field;
+    if (job.livData())
+        addLIV(name, job.livData());
+    if (job.ithData())
+        addIth(name, job.ithData());
+    if (job.spectraData())
+        addSpectra(name, job.spectraData());
+}
+
+/**
+ * \brief Adds the L-I-V traces of a file map.
+ */
+void AnalyticsExporter::addLIV(const QString& name, LIVDataProcessor *data)
+{
+    dataset(name).liv = data;
+}
+
+/**
+ * \brief Adds the threshold analysis of a file map.
+ */
+void AnalyticsExporter::addIth(const QString& name, IthDataProcessor *data)
+{
+    dataset(name).ith = data;
+}
+
+/**
+ * \brief Adds the spectra of a file map.
+ */
+void AnalyticsExporter::addSpectra(const QString& name, SpectraDataProcessor *data)
+{
+    dataset(name).spectra = data;
+}
+
+/**
+ * \brief Returns the entry of a file map, appending it on first use.
+ */
+AnalyticsExporter::Dataset& AnalyticsExporter::dataset(const QString& name)
+{
+    for (Dataset& entry : datasets) {
+        if (entry.name == name)
+            return entry;
+    }
+    Dataset entry;
+    entry.name = name;
+    datasets.append(entry);
+    return datasets.last();
+}
+
+/**
+ * \brief Writes every table and then schema.json.
+ *
+ * \return true on success.
+ *
+ * Row counts are summed from the processors first, so each column's header
+ * is final before its data is written; the vectors then go from the
+ * processors to the files without being copied or formatted. The schema is
+ * written last, so a folder with a schema always has complete columns.
+ */
+bool AnalyticsExporter::write() const
+{
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        qWarning() << "Failed to create analytics folder:" << directory;
+        return false;
+    }
+
+    QJsonObject tables;
+    bool ok = true;
+
+    // traces: one row per measured point
+    {
+        qint64 rows = 0;
+        for (const Dataset& entry : datasets) {
+            if (entry.liv)
+                for (const QVector<double>& x : entry.liv->getXList()) rows += x.size();
+            else if (entry.spectra)
+                for (const QVector<double>& x : entry.spectra->getXList()) rows += x.size();
+        }
+
+        Table table(dir, "traces", rows);
+        ColumnFile& datasetColumn = table.column("dataset", 'i', "", "Dataset code, see the datasets list");
+        ColumnFile& traceColumn = table.column("trace", 'i', "", "Trace index within the dataset");
+        ColumnFile& valueColumn = table.column("value", 'f', "K or mA", "Temperature or current the trace was measured at");
+        ColumnFile& xColumn = table.column("x", 'f', "A or THz", "Current (L-I-V) or frequency (spectra)");
+        ColumnFile& y1Column = table.column("y1", 'f', "V or a.u.", "Voltage (L-I-V) or intensity (spectra)");
+        ColumnFile& y2Column = table.column("y2", 'f', "a.u.", "Scaled optical power (L-I-V), NaN for spectra");
+
+        for (int code = 0; code < datasets.size(); ++code) {
+            const Dataset& entry = datasets[code];
+            if (!entry.liv && !entry.spectra)
+                continue;
+
+            const QList<QString>& values = entry.liv ? entry.liv->getValueList() : entry.spectra->getValueList();
+            const QList<QVector<double>>& xList = entry.liv ? entry.liv->getXList() : entry.spectra->getXList();
+            const QList<QVector<double>>& y1List = entry.liv ? entry.liv->getY1List() : entry.spectra->getY1List();
+
+            for (int trace = 0; trace < xList.size(); ++trace) {
+                const QVector<double>& x = xList[trace];
+                qint64 count = x.size();
+                datasetColumn.fill<qint32>(code, count);
+                traceColumn.fill<qint32>(trace, count);
+                valueColumn.fill<double>(traceValue(values.value(trace)), count);
+                xColumn.append(x, count);
+                y1Column.append(y1List.value(trace), count);
+                if (entry.liv)
+                    y2Column.append(entry.liv->getY2List().value(trace), count);
+                else
+                    y2Column.fill<double>(nan, count);
+            }
+        }
+        ok = table.commit(tables) && ok;
+    }
+
+    // threshold: one row per L-I-V trace that reached threshold
+    {
+        qint64 rows = 0;
+        for (const Dataset& entry : datasets)
+            if (entry.ith) rows += entry.ith->getTemperatures().size();
+
+        double scale = width > 0.0 && length > 0.0 ? 1e5 / (width * length) : nan;
+
+        Table table(dir, "threshold", rows);
+        ColumnFile& datasetColumn = table.column("dataset", 'i', "", "Dataset code, see the datasets list");
+        ColumnFile& tColumn = table.column("T", 'f', "K", "Heat sink temperature");
+        ColumnFile& ithColumn = table.column("Ith", 'f', "A", "Threshold current");
+        ColumnFile& jthColumn = table.column("Jth", 'f', "A/cm^2", "Threshold current density");
+        ColumnFile& drColumn = table.column("DR", 'f', "mA", "Dynamic range above threshold");
+
+        for (int code = 0; code < datasets.size(); ++code) {
+            const IthDataProcessor *ith = datasets[code].ith;
+            if (!ith)
+                continue;
+
+            const QVector<double> ithValues = ith->getThresholdCurrents();
+            qint64 count = ith->getTemperatures().size();
+            datasetColumn.fill<qint32>(code, count);
+            tColumn.append(ith->getTemperatures(), count);
+            ithColumn.append(ithValues, count);
+            QVector<double> jthValues(ithValues.size());
+            std::transform(ithValues.begin(), ithValues.end(), jthValues.begin(),
+                           [scale](double value) { return value * scale; });
+            jthColumn.append(jthValues, count);
+            drColumn.append(ith->getDynamicRanges(), count);
+        }
+        ok = table.commit(tables) && ok;
+    }
+
+    // threshold_fit: the exponential fit of each L-I-V dataset
+    {
+        qint64 rows = 0;
+        for (const Dataset& entry : datasets)
+            if (entry.ith && entry.ith->canPlot()) ++rows;
+
+        Table table(dir, "threshold_fit", rows);
+        ColumnFile& datasetColumn = table.column("dataset", 'i', "", "Dataset code, see the datasets list");
+        ColumnFile& aColumn = table.column("A", 'f', "A", "Prefactor of Ith = A exp(B T) + C0");
+        ColumnFile& bColumn = table.column("B", 'f', "1/K", "Rate of Ith = A exp(B T) + C0");
+        ColumnFile& c0Column = table.column("C0", 'f', "A", "Offset of Ith = A exp(B T) + C0");
+        ColumnFile& t0Column = table.column("T0", 'f', "K", "Characteristic temperature 1/B");
+
+        for (int code = 0; code < datasets.size(); ++code) {
+            IthDataProcessor *ith = datasets[code].ith;
+            if (!ith || !ith->canPlot())
+                continue;
+
+            double A, B, C0;
+            ith->getExponentialFitParams(A, B, C0);
+            datasetColumn.fill<qint32>(code, 1);
+            aColumn.fill<double>(A, 1);
+            bColumn.fill<double>(B, 1);
+            c0Column.fill<double>(C0, 1);
+            t0Column.fill<double>(B != 0.0 ? 1.0 / B : nan, 1);
+        }
+        ok = table.commit(tables) && ok;
+    }
+
+    // modes: the centre mode and mode spacing of each spectrum
+    {
+        qint64 rows = 0;
+        for (const Dataset& entry : datasets)
+            if (entry.spectra) rows += entry.spectra->getCenterModeData().size();
+
+        Table table(dir, "modes", rows);
+        ColumnFile& datasetColumn = table.column("dataset", 'i', "", "Dataset code, see the datasets list");
+        ColumnFile& traceColumn = table.column("trace", 'i', "", "Trace index within the dataset");
+        ColumnFile& valueColumn = table.column("value", 'f', "K or mA", "Temperature or current the spectrum was measured at");
+        ColumnFile& f0Column = table.column("f0", 'f', "THz", "Centre mode frequency");
+        ColumnFile& amplitudeColumn = table.column("amplitude", 'f', "a.u.", "Centre mode amplitude");
+        ColumnFile& fwhmColumn = table.column("FWHM", 'f', "THz", "Centre mode full width at half maximum");
+        ColumnFile& qColumn = table.column("Q", 'f', "", "Centre mode quality factor");
+        ColumnFile& fsrColumn = table.column("FSR", 'f', "THz", "Median spacing of the centre and side modes, NaN below two modes");
+        ColumnFile& sideModesColumn = table.column("side_modes", 'i', "", "Number of side modes");
+
+        for (int code = 0; code < datasets.size(); ++code) {
+            SpectraDataProcessor *spectra = datasets[code].spectra;
+            if (!spectra)
+                continue;
+
+            const QVector<Peak> centers = spectra->getCenterModeData();
+            const QVector<QVector<Peak>> sideModes = spectra->getSideModeData();
+            const QList<QString>& values = spectra->getValueList();
+            for (int trace = 0; trace < centers.size(); ++trace) {
+                const Peak& center = centers[trace];
+                const QVector<Peak> sides = sideModes.value(trace);
+                datasetColumn.fill<qint32>(code, 1);
+                traceColumn.fill<qint32>(trace, 1);
+                valueColumn.fill<double>(traceValue(values.value(trace)), 1);
+                f0Column.fill<double>(center.frequency, 1);
+                amplitudeColumn.fill<double>(center.amplitude, 1);
+                fwhmColumn.fill<double>(center.fwhm, 1);
+                qColumn.fill<double>(center.qFactor, 1);
+                fsrColumn.fill<double>(freeSpectralRange(center, sides), 1);
+                sideModesColumn.fill<qint32>(sides.size(), 1);
+            }
+        }
+        ok = table.commit(tables) && ok;
+    }
+
+    if (!ok)
+        return false;
+
+    QJsonArray datasetList;
+    for (const Dataset& entry : datasets) {
+        QJsonObject object;
+        object.insert("name", entry.name);
+        object.insert("kind", entry.liv ? "liv" : "spectra");
+        object.insert("traceVariable", entry.liv ? entry.liv->traceVariable
+                                                 : entry.spectra ? entry.spectra->traceVariable : QString());
+        datasetList.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("version", schemaVersion);
+    root.insert("format", "npy");
+    root.insert("sample", sampleName);
+    root.insert("width_um", width);
+    root.insert("length_mm", length);
+    root.insert("created", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("datasets", datasetList);
+    root.insert("tables", tables);
+
+    QSaveFile file(dir.absoluteFilePath("schema.json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write analytics schema:" << file.fileName();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file AnalyticsExporter.h
+ * @brief Declaration of AnalyticsExporter, which writes traces and extracted parameters as columnar files.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef ANALYTICSEXPORTER_H
+	#define ANALYTICSEXPORTER_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QVariantMap>
+	#include <QVector>
+
+	class GraceFigureJob;
+	class LIVDataProcessor;
+	class IthDataProcessor;
+	class SpectraDataProcessor;
+
+	/**
+	 * @class AnalyticsExporter
+	 * @brief Exports a device for analysis tools as one NumPy .npy file per column.
+	 *
+	 * Every column is a 1-D .npy array in native byte order whose data starts
+	 * on a 64 byte boundary, so numpy.load(path, mmap_mode="r") and similar
+	 * readers use it in place. schema.json lists the tables, their row count
+	 * and, per column, the file, dtype, unit and meaning, and maps the
+	 * dataset codes to the file map names.
+	 *
+	 * Tables:
+	 * - traces: one row per measured point; dataset, trace, value, x, y1, y2.
+	 * - threshold: one row per L-I-V trace above threshold; dataset, T, Ith,
+	 *   Jth, DR.
+	 * - threshold_fit: one row per L-I-V dataset; dataset, A, B, C0, T0 of
+	 *   Ith = A exp(B T) + C0.
+	 * - modes: one row per spectrum; dataset, trace, value, f0, amplitude,
+	 *   FWHM, Q, FSR, side mode count.
+	 *
+	 * The add*() calls only keep the processors; write() streams their
+	 * vectors straight into the files, so the processors must stay alive
+	 * until it returns.
+	 */
+	class AnalyticsExporter
+	{
+		public:
+			static const int schemaVersion = 1; ///< Bumped when columns are renamed or removed
+
+			explicit AnalyticsExporter(const QString& directory); ///< Constructor
+
+			static QString directoryFor(const QString& outputDir); ///< <outputDir>/Analytics
+
+			void setParameters(const QVariantMap& collectedData); ///< Sample name and ridge dimensions
+
+			void addJob(const GraceFigureJob& job); ///< Processors of one measurement set
+			void addLIV(const QString& dataset, LIVDataProcessor *data); ///< L-I-V traces
+			void addIth(const QString& dataset, IthDataProcessor *data); ///< Threshold and dynamic range results
+			void addSpectra(const QString& dataset, SpectraDataProcessor *data); ///< Spectra and their modes
+
+			bool write() const; ///< Write the columns and the schema
+			QString directoryName() const { return directory; } ///< Export folder
+
+		private:
+			/**
+			 * @struct Dataset
+			 * @brief Processors of one file map.
+			 */
+			struct Dataset {
+				QString name;                           ///< File map, e.g. "Pulsed LIV"
+				LIVDataProcessor *liv = nullptr;         ///< L-I-V data, or null
+				IthDataProcessor *ith = nullptr;         ///< Threshold analysis, or null
+				SpectraDataProcessor *spectra = nullptr; ///< Spectra, or null
+			};
+
+			Dataset& dataset(const QString& name); ///< Entry of a file map, added if new
+
+			QString directory;         ///< Export folder
+			QString sampleName;        ///< Sample name of the collected data
+			double width;              ///< Ridge width [um]
+			double length;             ///< Ridge length [mm]
+			QVector<Dataset> datasets; ///< In the order they were added; the index is the dataset code
+	};
+#endif // ANALYTICSEXPORTER_H
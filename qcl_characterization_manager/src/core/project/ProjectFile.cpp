@@ -0,0 +1,382 @@
+/**
+ * \file        ProjectFile.cpp
+ * \brief       Memory-mapped reader of .qclproj project files.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <QDebug>
+#include "ProjectFile.h"
+#include "core/dataprocessing/LIVDataProcessor.h"
+#include "core/dataprocessing/SpectraDataProcessor.h"
+
+namespace
+{
+    /// True if [offset, offset + size) lies within a file of fileSize bytes, without overflowing.
+    bool fitsIn(quint64 offset, quint64 size, quint64 fileSize)
+    {
+        return offset <= fileSize && size <= fileSize - offset;
+    }
+}
+
+/**
+ * \brief   Constructs a closed project.
+ * \param   filePath - Path of the .qclproj file.
+ */
+ProjectFile::ProjectFile(const QString& filePath)
+    : file(filePath)
+    , mapped(nullptr)
+    , mappedSize(0)
+    , fileMajor(0)
+    , fileMinor(0)
+    , dataOffset(0)
+    , dataSize(0)
+{
+}
+
+/**
+ * \brief Unmaps the file.
+ */
+ProjectFile::~ProjectFile()
+{
+    close();
+}
+
+/**
+ * \brief Returns the default project location of a device.
+ *
+ * \param outputDir     Device output directory.
+ * \param collectedData Collected data, for the sample name.
+ * \return <outputDir>/<Sample>.qclproj, with the sample name sanitised as
+ *         for the DataMap file.
+ */
+QString ProjectFile::pathFor(const QString& outputDir, const QVariantMap& collectedData)
+{
+    QString sampleName = collectedData.value("Sample Name").toString();
+    if (sampleName.isEmpty())
+        sampleName = "results";
+    else
+        sampleName = sampleName.replace(QRegularExpression("[^a-zA-Z0-9_]"), "_");
+    return QDir(outputDir).absoluteFilePath(sampleName + ".qclproj");
+}
+
+/**
+ * \brief Maps the file and reads its header and metadata.
+ *
+ * \param error Receives the reason of a failure, may be null.
+ * \return false if the file cannot be mapped, is not a project, was written
+ *         by a newer major version or is truncated.
+ */
+bool ProjectFile::open(QString *error)
+{
+    close();
+
+    auto fail = [this, error](const QString& reason) {
+        qWarning() << "Cannot open project" << file.fileName() << ":" << reason;
+        if (error) *error = reason;
+        close();
+        return false;
+    };
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return fail("Projects can only be mapped on little-endian machines");
+#endif
+
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+
+    mappedSize = file.size();
+    if (mappedSize < headerSize)
+        return fail("Not a project file");
+
+    mapped = file.map(0, mappedSize);
+    if (!mapped)
+        return fail(file.errorString());
+
+    if (QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), 8) != magic())
+        return fail("Not a project file");
+
+    fileMajor = qFromLittleEndian<quint16>(mapped + 8);
+    fileMinor = qFromLittleEndian<quint16>(mapped + 10);
+    if (fileMajor > majorVersion)
+        return fail(QString("Written by a newer version (format %1)").arg(version()));
+
+    dataOffset = qFromLittleEndian<quint64>(mapped + 16);
+    dataSize = qFromLittleEndian<quint64>(mapped + 24);
+    quint64 metadataOffset = qFromLittleEndian<quint64>(mapped + 32);
+    quint64 metadataSize = qFromLittleEndian<quint64>(mapped + 40);
+    if (!fitsIn(dataOffset, dataSize, quint64(mappedSize)) || !fitsIn(metadataOffset, metadataSize, quint64(mappedSize)))
+        return fail("Truncated project file");
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(
+        QByteArray::fromRawData(reinterpret_cast<const char*>(mapped + metadataOffset), qsizetype(metadataSize)), &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+        return fail("Corrupt metadata: " + parseError.errorString());
+
+    metadata = document.object();
+    columns = metadata.value("columns").toArray();
+    return true;
+}
+
+/**
+ * \brief Unmaps and closes the file.
+ */
+void ProjectFile::close()
+{
+    if (mapped)
+        file.unmap(mapped);
+    file.close();
+
+    mapped = nullptr;
+    mappedSize = 0;
+    fileMajor = 0;
+    fileMinor = 0;
+    dataOffset = 0;
+    dataSize = 0;
+    metadata = QJsonObject();
+    columns = QJsonArray();
+}
+
+/**
+ * \brief Returns the format version of the open file, e.g. "1.0".
+ */
+QString ProjectFile::version() const
+{
+    return QString("%1.%2").arg(fileMajor).arg(fileMinor);
+}
+
+/**
+ * \brief Returns the collected data saved with the project.
+ */
+QVariantMap ProjectFile::parameters() const
+{
+    return metadata.value("parameters").toObject().toVariantMap();
+}
+
+/**
+ * \brief Returns the PDF figures of the project.
+ */
+QStringList ProjectFile::figures() const
+{
+    return absolutePaths("figures");
+}
+
+/**
+ * \brief Returns the PNG figures shown in the carousel.
+ */
+QStringList ProjectFile::previews() const
+{
+    return absolutePaths("previews");
+}
+
+/**
+ * \brief Returns the file maps stored in the project, e.g. "Pulsed LIV".
+ */
+QStringList ProjectFile::datasets() const
+{
+    return metadata.value("datasets").toObject().keys();
+}
+
+/**
+ * \brief Returns "liv" or "spectra", or an empty string for an unknown dataset.
+ */
+QString ProjectFile::datasetKind(const QString& dataset) const
+{
+    return metadata.value("datasets").toObject().value(dataset).toObject().value("kind").toString();
+}
+
+/**
+ * \brief Returns the scalar properties of a dataset.
+ *
+ * \param dataset File map name.
+ * \return Trace variable, ranges and scale factor, and the fit parameters
+ *         of the threshold analysis; the trace values and column indices
+ *         are left out.
+ */
+QVariantMap ProjectFile::datasetInfo(const QString& dataset) const
+{
+    QVariantMap info = metadata.value("datasets").toObject().value(dataset).toObject().toVariantMap();
+    info.remove("values");
+    info.remove("traces");
+    info.remove("results");
+    return info;
+}
+
+/**
+ * \brief Returns the temperature or current label of every trace.
+ */
+QStringList ProjectFile::traceValues(const QString& dataset) const
+{
+    QStringList values;
+    const QJsonArray array = metadata.value("datasets").toObject().value(dataset).toObject().value("values").toArray();
+    for (const QJsonValue& value : array)
+        values.append(value.toString());
+    return values;
+}
+
+/**
+ * \brief Returns one column of one trace.
+ *
+ * \param dataset File map name.
+ * \param trace   Trace index, as in traceValues().
+ * \param column  "x", "y1" or "y2".
+ * \return The mapped values, or a null column.
+ */
+ProjectColumn ProjectFile::traceColumn(const QString& dataset, int trace, const QString& column) const
+{
+    const QJsonArray traces = metadata.value("datasets").toObject().value(dataset).toObject().value("traces").toArray();
+    if (trace < 0 || trace >= traces.size())
+        return ProjectColumn();
+
+    QJsonValue index = traces.at(trace).toObject().value(column);
+    return index.isDouble() ? this->column(index.toInt()) : ProjectColumn();
+}
+
+/**
+ * \brief Returns a derived result column of a dataset.
+ *
+ * \param dataset File map name.
+ * \param column  "T", "Ith", "DR" for L-I-V data; "frequency", "amplitude",
+ *                "fwhm", "qFactor" for spectra.
+ * \return The mapped values, or a null column.
+ */
+ProjectColumn ProjectFile::resultColumn(const QString& dataset, const QString& column) const
+{
+    QJsonValue index = metadata.value("datasets").toObject().value(dataset).toObject()
+                           .value("results").toObject().value(column);
+    return index.isDouble() ? this->column(index.toInt()) : ProjectColumn();
+}
+
+/**
+ * \brief Rebuilds the L-I-V data of a dataset from its columns.
+ *
+ * \param dataset File map name.
+ * \return The normalised traces as the processor had them when the project
+ *         was saved, or null if the dataset is not L-I-V data or a column is
+ *         missing or damaged. The caller owns the processor.
+ */
+LIVDataProcessor *ProjectFile::livData(const QString& dataset) const
+{
+    if (datasetKind(dataset) != "liv")
+        return nullptr;
+
+    QStringList values = traceValues(dataset);
+    QList<QVector<double>> x = traceColumns(dataset, "x");
+    QList<QVector<double>> y1 = traceColumns(dataset, "y1");
+    QList<QVector<double>> y2 = traceColumns(dataset, "y2");
+    if (x.size() != values.size() || y1.size() != values.size() || y2.size() != values.size()) {
+        qWarning() << "Damaged L-I-V columns in project" << file.fileName() << ":" << dataset;
+        return nullptr;
+    }
+
+    QJsonObject object = metadata.value("datasets").toObject().value(dataset).toObject();
+    return new LIVDataProcessor(dataset, object.value("traceVariable").toString(), values, x, y1, y2,
+                                object.value("preNormMaxY2").toDouble(), object.value("scaleFactor").toDouble(100.0));
+}
+
+/**
+ * \brief Rebuilds the spectra of a dataset from its columns.
+ *
+ * \param dataset File map name.
+ * \return The normalised spectra with their centre modes, or null if the
+ *         dataset is not spectra or a column is missing or damaged. Side
+ *         modes are not stored. The caller owns the processor.
+ */
+SpectraDataProcessor *ProjectFile::spectraData(const QString& dataset) const
+{
+    if (datasetKind(dataset) != "spectra")
+        return nullptr;
+
+    QStringList values = traceValues(dataset);
+    QList<QVector<double>> x = traceColumns(dataset, "x");
+    QList<QVector<double>> y1 = traceColumns(dataset, "y1");
+
+    ProjectColumn frequency = resultColumn(dataset, "frequency");
+    ProjectColumn amplitude = resultColumn(dataset, "amplitude");
+    ProjectColumn fwhm = resultColumn(dataset, "fwhm");
+    ProjectColumn qFactor = resultColumn(dataset, "qFactor");
+
+    if (x.size() != values.size() || y1.size() != values.size()
+        || frequency.size != values.size() || amplitude.size != values.size()
+        || fwhm.size != values.size() || qFactor.size != values.size()) {
+        qWarning() << "Damaged spectra columns in project" << file.fileName() << ":" << dataset;
+        return nullptr;
+    }
+
+    QVector<Peak> centerModes;
+    for (qint64 i = 0; i < frequency.size; ++i)
+        centerModes.append(Peak{ frequency.data[i], amplitude.data[i], fwhm.data[i], qFactor.data[i] });
+
+    QJsonObject object = metadata.value("datasets").toObject().value(dataset).toObject();
+    return new SpectraDataProcessor(dataset, object.value("traceVariable").toString(), values, x, y1, centerModes,
+                                    object.value("xMin").toDouble(), object.value("xMax").toDouble());
+}
+
+/**
+ * \brief Resolves an entry of the column table against the mapping.
+ *
+ * Entries outside the column area, off the column alignment or with a
+ * negative count give a null column, so a damaged file cannot make callers
+ * read past the mapping.
+ */
+ProjectColumn ProjectFile::column(int index) const
+{
+    if (!mapped || index < 0 || index >= columns.size())
+        return ProjectColumn();
+
+    const QJsonArray entry = columns.at(index).toArray();
+    double offset = entry.at(0).toDouble(-1.0);
+    double count = entry.at(1).toDouble(-1.0);
+    if (offset < double(dataOffset) || count < 0.0 || offset > double(dataOffset + dataSize))
+        return ProjectColumn();
+
+    quint64 start = quint64(offset);
+    quint64 values = quint64(count);
+    if (start % columnAlignment != 0 || values > (dataOffset + dataSize - start) / sizeof(double))
+        return ProjectColumn();
+
+    ProjectColumn result;
+    result.data = reinterpret_cast<const double*>(mapped + start);
+    result.size = qint64(values);
+    return result;
+}
+
+/**
+ * \brief Copies one column of every trace of a dataset.
+ *
+ * \return One vector per trace, in trace order; the list stops at the first
+ *         missing or damaged column, so callers compare its size with
+ *         traceValues().
+ */
+QList<QVector<double>> ProjectFile::traceColumns(const QString& dataset, const QString& column) const
+{
+    QList<QVector<double>> list;
+    int count = metadata.value("datasets").toObject().value(dataset).toObject().value("traces").toArray().size();
+    for (int trace = 0; trace < count; ++trace) {
+        ProjectColumn values = traceColumn(dataset, trace, column);
+        if (values.isNull())
+            break;
+        list.append(values.toVector());
+    }
+    return list;
+}
+
+/**
+ * \brief Reads a list of project-relative paths from the metadata.
+ */
+QStringList ProjectFile::absolutePaths(const QString& key) const
+{
+    QDir projectDir = QFileInfo(file.fileName()).absoluteDir();
+
+    QStringList paths;
+    const QJsonArray array = metadata.value(key).toArray();
+    for (const QJsonValue& value : array)
+        paths.append(QDir::cleanPath(projectDir.absoluteFilePath(value.toString())));
+    return paths;
+}
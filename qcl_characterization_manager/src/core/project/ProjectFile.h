@@ -0,0 +1,124 @@
+/**
+ * @file ProjectFile.h
+ * @brief Declaration of ProjectFile, which opens a saved .qclproj project.
+ *
+ * A project holds everything needed to reopen a device without its raw
+ * measurement files: the wizard parameters, the parsed traces, the derived
+ * threshold, dynamic range and peak results, and the figures.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef PROJECTFILE_H
+	#define PROJECTFILE_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QVariantMap>
+	#include <QVector>
+	#include <QFile>
+	#include <QJsonObject>
+	#include <QJsonArray>
+
+	class LIVDataProcessor;
+	class SpectraDataProcessor;
+
+	/**
+	 * @struct ProjectColumn
+	 * @brief One column of doubles inside a mapped project file.
+	 *
+	 * The data is not copied: it points into the mapping of the ProjectFile
+	 * it came from and is valid until that file is closed.
+	 */
+	struct ProjectColumn
+	{
+		const double *data = nullptr; ///< First value, null for a missing column
+		qint64 size = 0;              ///< Number of values
+
+		bool isNull() const { return data == nullptr; } ///< True for a missing column
+		QVector<double> toVector() const { return QVector<double>(data, data + size); } ///< Copy of the values
+	};
+
+	/**
+	 * @class ProjectFile
+	 * @brief Read-only, memory-mapped view of a .qclproj file.
+	 *
+	 * Layout (all integers little-endian):
+	 * - 64 byte header: magic "QCLPROJ\0", major and minor version (16 bit
+	 *   each), flags, then offset and size of the column area and of the
+	 *   metadata.
+	 * - Column area: one block of raw little-endian doubles per column, each
+	 *   starting on a 64 byte boundary so it can be used in place.
+	 * - Metadata: compact JSON with the parameters, the figures (relative to
+	 *   the project folder), the column table [offset, count] and, per file
+	 *   map, the trace values and column indices of its traces and results.
+	 *
+	 * open() maps the file and parses only the header and the metadata, so a
+	 * project opens in about the same time whatever the size of its traces;
+	 * the column pages are read by the OS the first time they are used.
+	 * livData() and spectraData() copy the columns of a dataset back into a
+	 * processor, which is how a reopened project gets its interactive views
+	 * and fit results without the raw files.
+	 * Files with a newer major version are refused, while a newer minor
+	 * version only adds metadata keys that older readers ignore.
+	 *
+	 * Datasets are keyed by file map ("Pulsed LIV", ...). L-I-V traces have
+	 * the columns "x" (current), "y1" (voltage) and "y2" (optical power), and the
+	 * results "T", "Ith" and "DR". Spectra traces have "x" (frequency) and
+	 * "y1" (intensity), and the centre mode of each trace as the results
+	 * "frequency", "amplitude", "fwhm" and "qFactor".
+	 */
+	class ProjectFile
+	{
+		public:
+			static const quint16 majorVersion = 1; ///< Incompatible layout changes
+			static const quint16 minorVersion = 0; ///< Compatible additions
+			static const int headerSize = 64;      ///< Bytes before the column area
+			static const int columnAlignment = 64; ///< Alignment of every column block
+			static QByteArray magic() { return QByteArray("QCLPROJ\0", 8); } ///< First eight bytes of a project
+
+			explicit ProjectFile(const QString& filePath); ///< Constructor, does not open the file
+			~ProjectFile(); ///< Unmaps the file
+
+			static QString pathFor(const QString& outputDir, const QVariantMap& collectedData); ///< <outputDir>/<Sample>.qclproj
+
+			bool open(QString *error = nullptr); ///< Map the file and read its metadata
+			void close(); ///< Unmap the file; columns become invalid
+			bool isOpen() const { return mapped != nullptr; } ///< True after a successful open()
+			QString fileName() const { return file.fileName(); } ///< Project file path
+			QString version() const; ///< "major.minor" of the open file
+
+			QVariantMap parameters() const; ///< Collected data of the wizard, with the fit results
+			QStringList figures() const; ///< PDF figures, absolute
+			QStringList previews() const; ///< PNG figures shown in the carousel, absolute
+
+			QStringList datasets() const; ///< File maps stored in the project
+			QString datasetKind(const QString& dataset) const; ///< "liv" or "spectra"
+			QVariantMap datasetInfo(const QString& dataset) const; ///< Trace variable, scale, fit parameters, ...
+			QStringList traceValues(const QString& dataset) const; ///< Temperature or current of each trace
+			ProjectColumn traceColumn(const QString& dataset, int trace, const QString& column) const; ///< Column of one trace
+			ProjectColumn resultColumn(const QString& dataset, const QString& column) const; ///< Derived result column
+
+			LIVDataProcessor *livData(const QString& dataset) const; ///< L-I-V traces of a dataset, owned by the caller
+			SpectraDataProcessor *spectraData(const QString& dataset) const; ///< Spectra and centre modes of a dataset, owned by the caller
+
+		private:
+			ProjectFile(const ProjectFile&) = delete;
+			ProjectFile& operator=(const ProjectFile&) = delete;
+
+			ProjectColumn column(int index) const; ///< Entry of the column table
+			QList<QVector<double>> traceColumns(const QString& dataset, const QString& column) const; ///< One column of every trace, copied
+			QStringList absolutePaths(const QString& key) const; ///< Metadata path list resolved against the project folder
+
+			QFile file;              ///< Project file
+			uchar *mapped;           ///< Mapping of the whole file
+			qint64 mappedSize;       ///< Size of the mapping
+			quint16 fileMajor;       ///< Major version of the open file
+			quint16 fileMinor;       ///< Minor version of the open file
+			quint64 dataOffset;      ///< Start of the column area
+			quint64 dataSize;        ///< Size of the column area
+			QJsonObject metadata;    ///< Parsed metadata
+			QJsonArray columns;      ///< Column table: [offset, count] per column
+	};
+#endif // PROJECTFILE_H
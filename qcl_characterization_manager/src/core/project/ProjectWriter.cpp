@@ -0,0 +1,269 @@
+/**
+ * \file        ProjectWriter.cpp
+ * \brief       Writes the parameters, traces, results and figures of a device to a .qclproj file.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include "ProjectWriter.h"
+#include "ProjectFile.h"
+#include "core/graceplots/GraceFigureJob.h"
+
+namespace
+{
+    /// Bytes needed to bring size up to the column alignment.
+    qint64 padding(qint64 size)
+    {
+        return (ProjectFile::columnAlignment - size % ProjectFile::columnAlignment) % ProjectFile::columnAlignment;
+    }
+
+    /// Writes doubles as little-endian, in place on little-endian machines.
+    bool writeDoubles(QSaveFile& file, const QVector<double>& values)
+    {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        qint64 size = values.size() * qint64(sizeof(double));
+        return file.write(reinterpret_cast<const char*>(values.constData()), size) == size;
+#else
+        QByteArray buffer(values.size() * int(sizeof(double)), Qt::Uninitialized);
+        for (int i = 0; i < values.size(); ++i) {
+            quint64 bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            qToLittleEndian(bits, buffer.data() + i * sizeof(double));
+        }
+        return file.write(buffer) == buffer.size();
+#endif
+    }
+}
+
+/**
+ * \brief   Constructs an empty project.
+ * \param   filePath - Path of the .qclproj file, usually from ProjectFile::pathFor().
+ */
+ProjectWriter::ProjectWriter(const QString& filePath)
+    : filePath(QFileInfo(filePath).absoluteFilePath())
+{
+}
+
+/**
+ * \brief Sets the figures the project refers to.
+ *
+ * \param pdfFiles     PDF figures used by the datasheet.
+ * \param previewFiles PNG figures shown in the carousel.
+ *
+ * Only the paths are stored, relative to the project folder.
+ */
+void ProjectWriter::setFigures(const QStringList& pdfFiles, const QStringList& previewFiles)
+{
+    figures.clear();
+    previews.clear();
+    for (const QString& path : pdfFiles)
+        figures.append(relativePath(path));
+    for (const QString& path : previewFiles)
+        previews.append(relativePath(path));
+}
+
+/**
+ * \brief Adds the parsed data and the derived results of a measurement set.
+ *
+ * \param job A job whose analyse() has run.
+ */
+void ProjectWriter::addJob(const GraceFigureJob& job)
+{
+    const QString dataset = job.figureSet().field;
+    if (job.livData())
+        addLIV(dataset, job.livData());
+    if (job.ithData())
+        addIth(dataset, job.ithData());
+    if (job.spectraData())
+        addSpectra(dataset, job.spectraData());
+}
+
+/**
+ * \brief Adds the L-I-V traces of a file map.
+ */
+void ProjectWriter::addLIV(const QString& dataset, LIVDataProcessor *data)
+{
+    QJsonObject object = datasets.value(dataset).toObject();
+    object.insert("kind", "liv");
+    object.insert("traceVariable", data->traceVariable);
+    object.insert("values", QJsonArray::fromStringList(data->getValueList()));
+    object.insert("minX", data->getMinX());
+    object.insert("maxX", data->getMaxX());
+    object.insert("minY1", data->getMinY1());
+    object.insert("maxY1", data->getMaxY1());
+    object.insert("preNormMaxY2", data->getPreNormMaxY2());
+    object.insert("scaleFactor", data->getScaleFactor());
+
+    QJsonArray traces;
+    for (int i = 0; i < data->getXList().size(); ++i) {
+        QJsonObject trace;
+        trace.insert("x", addColumn(data->getXList().at(i)));
+        trace.insert("y1", addColumn(data->getY1List().value(i)));
+        trace.insert("y2", addColumn(data->getY2List().value(i)));
+        traces.append(trace);
+    }
+    object.insert("traces", traces);
+    datasets.insert(dataset, object);
+}
+
+/**
+ * \brief Adds the threshold current and dynamic range of a file map, with the fit parameters.
+ */
+void ProjectWriter::addIth(const QString& dataset, IthDataProcessor *data)
+{
+    QJsonObject object = datasets.value(dataset).toObject();
+
+    QJsonObject results = object.value("results").toObject();
+    results.insert("T", addColumn(data->getTemperatures()));
+    results.insert("Ith", addColumn(data->getThresholdCurrents()));
+    results.insert("DR", addColumn(data->getDynamicRanges()));
+    object.insert("results", results);
+
+    if (data->canPlot()) {
+        double A, B, C0;
+        data->getExponentialFitParams(A, B, C0);
+        object.insert("ithFitA", A);
+        object.insert("ithFitB", B);
+        object.insert("ithFitC0", C0);
+    }
+
+    QVector<double> coefficients;
+    data->getPolynomialCoefficients(coefficients);
+    QJsonArray polynomial;
+    for (double coefficient : coefficients)
+        polynomial.append(coefficient);
+    object.insert("drPolynomial", polynomial);
+
+    datasets.insert(dataset, object);
+}
+
+/**
+ * \brief Adds the spectra of a file map and the centre mode of each trace.
+ */
+void ProjectWriter::addSpectra(const QString& dataset, SpectraDataProcessor *data)
+{
+    QJsonObject object = datasets.value(dataset).toObject();
+    object.insert("kind", "spectra");
+    object.insert("traceVariable", data->traceVariable);
+    object.insert("values", QJsonArray::fromStringList(data->getValueList()));
+    object.insert("xMin", data->getXmin());
+    object.insert("xMax", data->getXmax());
+    object.insert("frequencyRange", data->getGlobalFrequencyRangeString());
+
+    QJsonArray traces;
+    for (int i = 0; i < data->getXList().size(); ++i) {
+        QJsonObject trace;
+        trace.insert("x", addColumn(data->getXList().at(i)));
+        trace.insert("y1", addColumn(data->getY1List().value(i)));
+        traces.append(trace);
+    }
+    object.insert("traces", traces);
+
+    const QVector<Peak> peaks = data->getCenterModeData();
+    QVector<double> frequency, amplitude, fwhm, qFactor;
+    for (const Peak& peak : peaks) {
+        frequency.append(peak.frequency);
+        amplitude.append(peak.amplitude);
+        fwhm.append(peak.fwhm);
+        qFactor.append(peak.qFactor);
+    }
+
+    QJsonObject results;
+    results.insert("frequency", addColumn(frequency));
+    results.insert("amplitude", addColumn(amplitude));
+    results.insert("fwhm", addColumn(fwhm));
+    results.insert("qFactor", addColumn(qFactor));
+    object.insert("results", results);
+
+    datasets.insert(dataset, object);
+}
+
+/**
+ * \brief Queues a column for writing.
+ *
+ * \return Its index in the column table.
+ */
+int ProjectWriter::addColumn(const QVector<double>& values)
+{
+    columns.append(values);
+    return columns.size() - 1;
+}
+
+/**
+ * \brief Expresses a path relative to the project folder.
+ */
+QString ProjectWriter::relativePath(const QString& path) const
+{
+    return QFileInfo(filePath).absoluteDir().relativeFilePath(QFileInfo(path).absoluteFilePath());
+}
+
+/**
+ * \brief Writes the project.
+ *
+ * \return true on success.
+ *
+ * The offsets of all columns are known before anything is written, so the
+ * file is produced in one pass: header, aligned column blocks, metadata.
+ */
+bool ProjectWriter::write() const
+{
+    QJsonArray columnTable;
+    qint64 offset = ProjectFile::headerSize;
+    for (const QVector<double>& column : columns) {
+        columnTable.append(QJsonArray{ double(offset), double(column.size()) });
+        offset += column.size() * qint64(sizeof(double));
+        offset += padding(offset);
+    }
+    qint64 dataSize = offset - ProjectFile::headerSize;
+
+    QJsonObject root;
+    root.insert("parameters", QJsonObject::fromVariantMap(parameters));
+    root.insert("figures", QJsonArray::fromStringList(figures));
+    root.insert("previews", QJsonArray::fromStringList(previews));
+    root.insert("datasets", datasets);
+    root.insert("columns", columnTable);
+    QByteArray metadata = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+    QByteArray header(ProjectFile::headerSize, '\0');
+    uchar *bytes = reinterpret_cast<uchar*>(header.data());
+    std::memcpy(bytes, ProjectFile::magic().constData(), 8);
+    qToLittleEndian<quint16>(ProjectFile::majorVersion, bytes + 8);
+    qToLittleEndian<quint16>(ProjectFile::minorVersion, bytes + 10);
+    qToLittleEndian<quint32>(0, bytes + 12);  // flags
+    qToLittleEndian<quint64>(ProjectFile::headerSize, bytes + 16);
+    qToLittleEndian<quint64>(dataSize, bytes + 24);
+    qToLittleEndian<quint64>(offset, bytes + 32);
+    qToLittleEndian<quint64>(metadata.size(), bytes + 40);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write project:" << filePath;
+        return false;
+    }
+
+    bool ok = file.write(header) == header.size();
+    const QByteArray zeros(ProjectFile::columnAlignment, '\0');
+    for (const QVector<double>& column : columns) {
+        if (!ok)
+            break;
+        ok = writeDoubles(file, column);
+        qint64 pad = padding(file.pos());
+        if (ok && pad > 0)
+            ok = file.write(zeros.constData(), pad) == pad;
+    }
+    ok = ok && file.write(metadata) == metadata.size();
+
+    if (!ok) {
+        qWarning() << "Failed to write project:" << filePath << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ProjectWriter.h
+ * @brief Declaration of ProjectWriter, which saves a device as a .qclproj project.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#pragma once
+#ifndef PROJECTWRITER_H
+	#define PROJECTWRITER_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QVariantMap>
+	#include <QVector>
+	#include <QJsonObject>
+
+	class GraceFigureJob;
+	class LIVDataProcessor;
+	class IthDataProcessor;
+	class SpectraDataProcessor;
+
+	/**
+	 * @class ProjectWriter
+	 * @brief Collects the data of a device and writes it in the ProjectFile layout.
+	 *
+	 * The add*() calls copy the vectors they are given (Qt's implicit sharing
+	 * makes this cheap), so the processors may be deleted before write().
+	 * write() goes through QSaveFile, so an existing project is only
+	 * replaced once the new one is complete.
+	 */
+	class ProjectWriter
+	{
+		public:
+			explicit ProjectWriter(const QString& filePath); ///< Constructor
+
+			void setParameters(const QVariantMap& collectedData) { parameters = collectedData; } ///< Collected data of the wizard
+			void setFigures(const QStringList& pdfFiles, const QStringList& previewFiles); ///< Figures to reference
+
+			void addJob(const GraceFigureJob& job); ///< Parsed data and results of one measurement set
+			void addLIV(const QString& dataset, LIVDataProcessor *data); ///< L-I-V traces
+			void addIth(const QString& dataset, IthDataProcessor *data); ///< Threshold and dynamic range results
+			void addSpectra(const QString& dataset, SpectraDataProcessor *data); ///< Spectra traces and centre modes
+
+			bool write() const; ///< Save the project
+			QString fileName() const { return filePath; } ///< Project file path
+
+		private:
+			int addColumn(const QVector<double>& values); ///< Queue a column, returns its index
+			QString relativePath(const QString& path) const; ///< Path relative to the project folder
+
+			QString filePath;                ///< Project file
+			QVariantMap parameters;          ///< Collected data
+			QStringList figures;             ///< PDF figures, relative
+			QStringList previews;            ///< PNG figures, relative
+			QJsonObject datasets;            ///< Per file map metadata
+			QVector<QVector<double>> columns; ///< Column data, in file order
+	};
+#endif // PROJECTWRITER_H
@@ -0,0 +1,9 @@
+SOURCES += \
+    $$PWD/AnalyticsExporter.cpp \
+    $$PWD/ProjectFile.cpp \
+    $$PWD/ProjectWriter.cpp
+
+HEADERS += \
+    $$PWD/AnalyticsExporter.h \
+    $$PWD/ProjectFile.h \
+    $$PWD/ProjectWriter.h
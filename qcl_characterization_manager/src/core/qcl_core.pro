@@ -0,0 +1,14 @@
+# GUI-free core: data processing, Grace figures, conversion and the LaTeX
+# datasheet. Linked by the command-line tool in src/cli.
+lessThan(QT_MAJOR_VERSION, 6): error("Qt 6 is required (found Qt $$QT_VERSION)")
+
+TEMPLATE = lib
+TARGET = qcl_core
+CONFIG += staticlib c++17
+
+QT = core concurrent
+
+INCLUDEPATH += \
+    $$PWD/..
+
+include(core.pri)
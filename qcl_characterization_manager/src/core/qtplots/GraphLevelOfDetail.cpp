@@ -0,0 +1,122 @@
+/**
+ * \file        GraphLevelOfDetail.cpp
+ * \brief       Min/max level-of-detail pyramid that keeps dense graphs fast to pan and zoom.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "GraphLevelOfDetail.h"
+
+namespace
+{
+    /// Coarsest level size; below this a further level saves nothing.
+    constexpr int coarsestPoints = 2048;
+
+    /// First point at or after key.
+    int lowerIndex(const QVector<QCPGraphData> &data, double key)
+    {
+        return int(std::lower_bound(data.constBegin(), data.constEnd(), key,
+                                    [](const QCPGraphData &point, double k) { return point.key < k; })
+                   - data.constBegin());
+    }
+
+    /// First point after key.
+    int upperIndex(const QVector<QCPGraphData> &data, double key)
+    {
+        return int(std::upper_bound(data.constBegin(), data.constEnd(), key,
+                                    [](double k, const QCPGraphData &point) { return k < point.key; })
+                   - data.constBegin());
+    }
+
+    /// Halves a level: the minimum and maximum of every four points, in key order.
+    QVector<QCPGraphData> decimate(const QVector<QCPGraphData> &level)
+    {
+        QVector<QCPGraphData> result;
+        result.reserve(level.size() / 2 + 2);
+
+        for (int chunk = 0; chunk < level.size(); chunk += 4) {
+            int end = qMin(chunk + 4, int(level.size()));
+            int lowest = -1, highest = -1;
+            for (int i = chunk; i < end; ++i) {
+                double value = level[i].value;
+                if (std::isnan(value))
+                    continue;
+                if (lowest < 0 || value < level[lowest].value) lowest = i;
+                if (highest < 0 || value > level[highest].value) highest = i;
+            }
+
+            if (lowest < 0)
+                result.append(level[chunk]);  // all NaN: keep the gap in the line
+            else if (lowest == highest)
+                result.append(level[lowest]);
+            else {
+                result.append(level[qMin(lowest, highest)]);
+                result.append(level[qMax(lowest, highest)]);
+            }
+        }
+        return result;
+    }
+}
+
+/**
+ * \brief   Builds the pyramid of a trace and attaches it to a graph.
+ * \param   graph  - Graph to feed; becomes the parent.
+ * \param   keys   - Sorted keys of the trace.
+ * \param   values - Values of the trace.
+ */
+GraphLevelOfDetail::GraphLevelOfDetail(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values)
+    : QObject{graph}
+    , graph(graph)
+{
+    int count = qMin(keys.size(), values.size());
+    QVector<QCPGraphData> trace(count);
+    for (int i = 0; i < count; ++i)
+        trace[i] = QCPGraphData(keys[i], values[i]);
+    levels.append(trace);
+
+    while (levels.last().size() > coarsestPoints) {
+        QVector<QCPGraphData> next = decimate(levels.last());
+        levels.append(next);
+    }
+
+    connect(graph->parentPlot(), &QCustomPlot::beforeReplot, this, &GraphLevelOfDetail::update);
+}
+
+/**
+ * \brief Picks the level for the current view and hands its slice to the graph.
+ *
+ * Nothing is copied while the view stays inside the slice already held at
+ * the same level, which is the common case while panning.
+ */
+void GraphLevelOfDetail::update()
+{
+    QCPAxis *keyAxis = graph->keyAxis();
+    if (!keyAxis || levels.first().isEmpty())
+        return;
+
+    QCPRange range = keyAxis->range();
+    int pixels = keyAxis->orientation() == Qt::Horizontal ? keyAxis->axisRect()->width()
+                                                           : keyAxis->axisRect()->height();
+    pixels = qMax(1, int(pixels * graph->parentPlot()->bufferDevicePixelRatio()));
+
+    // Level k holds count / 2^k points of the view; keep at least two per pixel
+    const QVector<QCPGraphData> &trace = levels.first();
+    int count = upperIndex(trace, range.upper) - lowerIndex(trace, range.lower);
+    double pointsPerPixel = count / (2.0 * pixels);
+    int level = 0;
+    while (level + 1 < levels.size() && double(1 << (level + 1)) <= pointsPerPixel)
+        ++level;
+
+    if (level == shownLevel && range.lower >= shownKeys.lower && range.upper <= shownKeys.upper)
+        return;
+
+    QCPRange window(range.lower - range.size(), range.upper + range.size());
+    const QVector<QCPGraphData> &data = levels[level];
+    int first = qMax(0, lowerIndex(data, window.lower) - 1);
+    int last = qMin(int(data.size()), upperIndex(data, window.upper) + 1);
+
+    graph->data()->set(data.mid(first, last - first), true);
+    shownLevel = level;
+    shownKeys = window;
+}
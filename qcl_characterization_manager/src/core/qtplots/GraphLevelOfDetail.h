@@ -0,0 +1,52 @@
+/**
+ * @file GraphLevelOfDetail.h
+ * @brief Declaration of GraphLevelOfDetail, min/max decimation of dense QCustomPlot graphs.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#ifndef GRAPHLEVELOFDETAIL_H
+	#define GRAPHLEVELOFDETAIL_H
+
+	#include <QObject>
+	#include <QVector>
+	#include "qcustomplot.h"
+
+	/**
+	 * @class GraphLevelOfDetail
+	 * @brief Feeds a graph only the points its current view can show.
+	 *
+	 * On construction the trace is reduced into a pyramid of levels: each
+	 * level splits the previous one into chunks of four points and keeps the
+	 * minimum and the maximum of every chunk, in key order, so level k holds
+	 * two points per 2^(k+1) samples and every peak survives. Before each
+	 * replot the level with about two points per pixel of the visible key
+	 * range is picked and the slice around the view (one view width either
+	 * side, so panning rarely needs new data) is handed to the graph.
+	 *
+	 * A replot then costs a few thousand points per graph whatever the trace
+	 * length. The graph keeps the full trace until its first replot, so
+	 * offscreen exports, which draw without replotting, stay exact.
+	 *
+	 * The object is a child of the graph and is deleted with it. Keys must
+	 * be sorted in ascending order.
+	 */
+	class GraphLevelOfDetail : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			static const int minimumPoints = 4096; ///< Traces shorter than this are plotted directly
+
+			GraphLevelOfDetail(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values); ///< Build the pyramid
+
+		private slots:
+			void update(); ///< Hand the graph the slice of the right level for the view
+
+		private:
+			QCPGraph *graph;                         ///< Graph being fed
+			QVector<QVector<QCPGraphData>> levels;   ///< levels[0] is the trace, then halving min/max levels
+			int shownLevel = -1;                     ///< Level the graph holds
+			QCPRange shownKeys;                      ///< Key range the graph holds
+	};
+#endif // GRAPHLEVELOFDETAIL_H
@@ -18,12 +18,12 @@ QtLIVPlot::QtLIVPlot(LIVDataProcessor* data, const QString& outputDirectory, con
         QColor lineColor = valueToColor(value, data->traceVariable);
 
         addGraph(xAxis, yAxis);        // V-I curve
-        graph()->setData(x, y1);
+        setGraphData(graph(), x, y1);
         graph()->setPen(QPen(lineColor, 4));
         graph()->setName(value + data->unit);
 
         addGraph(xAxis, yAxis2);       // Normalized light output
-        graph()->setData(x, y2);
+        setGraphData(graph(), x, y2);
         graph()->setPen(QPen(lineColor, 4));
         graph()->removeFromLegend();
     }
@@ -66,16 +66,14 @@ QtLIVPlot::QtLIVPlot(LIVDataProcessor* data, const QString& outputDirectory, con
     yAxis->setRange(y1Min, y1Max);
     yAxis2->setRange(0, normMax);
 
-    // Set tick step manually using a fixed ticker
-    setTickStep({ xAxis, xAxis2, yAxis, yAxis2 }, 10);
+    // The view can be dragged and zoomed, so the default tickers pick a step
+    // for the visible range instead of a fixed one
+    xAxis2->setVisible(true);
+    yAxis2->setVisible(true);
 
-    // Optionally you can directly set the tickers:
-    QSharedPointer<QCPAxisTickerFixed> fixedTicker(new QCPAxisTickerFixed);
-    fixedTicker->setTickStep(10);
-    xAxis->setTicker(fixedTicker);
-    xAxis2->setTicker(fixedTicker);
-    yAxis->setTicker(fixedTicker);
-    yAxis2->setTicker(fixedTicker);
+    // Keep the current density axis in step with the current axis
+    connect(xAxis, QOverload<const QCPRange &>::of(&QCPAxis::rangeChanged),
+            this, &QtLIVPlot::updateSecondaryXAxis);
 }
 
 void QtLIVPlot::updateSecondaryXAxis()
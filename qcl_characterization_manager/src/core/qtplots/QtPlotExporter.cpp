@@ -0,0 +1,342 @@
+/**
+ * \file        QtPlotExporter.cpp
+ * \brief       Offscreen QCustomPlot export of the LIV, Ith and spectra figures.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "QtPlotExporter.h"
+#include "QtSpectraPlot.h"
+
+namespace
+{
+    /// Grace templates use a US-letter landscape page, in points.
+    constexpr int pageWidthPt = 792;
+    constexpr int pageHeightPt = 612;
+
+    /// Mirrors LIVGracePlot::chooseNiceStep(): the smallest 1, 2, 2.5, 5 or 10
+    /// times a power of ten giving at most maxTicks intervals.
+    double niceStep(double minVal, double maxVal, int maxTicks = 8)
+    {
+        double range = maxVal - minVal;
+        if (!(range > 0))
+            return 1.0;
+
+        double magnitude = std::pow(10.0, std::floor(std::log10(range / maxTicks)));
+        for (double base : { 1.0, 2.0, 2.5, 5.0, 10.0 }) {
+            if (range / (base * magnitude) <= maxTicks)
+                return base * magnitude;
+        }
+        return 10 * magnitude;
+    }
+
+    /// Fixed-step ticker, as Grace's "tick major" for an axis.
+    QSharedPointer<QCPAxisTicker> fixedTicker(double step)
+    {
+        QSharedPointer<QCPAxisTickerFixed> ticker(new QCPAxisTickerFixed);
+        ticker->setTickStep(step);
+        ticker->setScaleStrategy(QCPAxisTickerFixed::ssNone);
+        return ticker;
+    }
+
+    /// Line colours 1-15 of GracePlot::setColors(), in the order LIVGracePlot assigns them.
+    QColor graceColor(int trace)
+    {
+        static const QColor colors[] = {
+            QColor(0, 0, 0),     QColor(255, 0, 0),     QColor(0, 0, 255),    QColor(0, 139, 0),
+            QColor(255, 165, 0), QColor(188, 143, 143), QColor(103, 7, 72),   QColor(0, 255, 0),
+            QColor(0, 127, 255), QColor(184, 115, 51),  QColor(255, 215, 0),  QColor(255, 0, 255),
+            QColor(128, 128, 128), QColor(114, 33, 188), QColor(64, 224, 208)
+        };
+        return colors[trace % 15];
+    }
+}
+
+/**
+ * \brief   Constructs an exporter writing into the given 'Figures' directory.
+ * \param   figuresDirPath - Output 'Figures' directory.
+ *
+ * Defaults match FileConverter: the PDF and the print-resolution PNG.
+ */
+QtPlotExporter::QtPlotExporter(const QString& figuresDirPath)
+    : figuresDir(figuresDirPath)
+    , outputProfiles(FileConverter::PdfOutput | FileConverter::PrintTier)
+{
+    for (FileConverter::OutputProfile tier : { FileConverter::ThumbnailTier, FileConverter::PreviewTier, FileConverter::PrintTier })
+        tierDpi[tier] = FileConverter::defaultTierResolution(tier);
+}
+
+/**
+ * \brief Overrides the resolution of a raster tier.
+ *
+ * \param tier The raster tier (ignored for PdfOutput).
+ * \param dpi  Resolution in dots per inch; values below 1 are ignored.
+ */
+void QtPlotExporter::setTierResolution(FileConverter::OutputProfile tier, int dpi)
+{
+    if (tier == FileConverter::PdfOutput || dpi < 1)
+        return;
+    tierDpi[tier] = dpi;
+}
+
+/**
+ * \brief Exports the LIV figure.
+ *
+ * \param baseName File name without extension, e.g. "pulsed_liv".
+ * \param data     LIV traces.
+ * \param w        Ridge width in micrometers.
+ * \param l        Ridge length in millimeters.
+ * \return true if every requested output was written, false if there is
+ *         no trace to plot.
+ *
+ * Mirrors LIVGracePlot::plot_liv() rather than the interactive QtLIVPlot:
+ * V against I with a dashed grid, L against J on the opposite axes, ranges
+ * rounded out to whole tick steps, and the L range stretched to 1.75 times
+ * the scale factor so the L-I curves sit below the V-I curves.
+ */
+bool QtPlotExporter::exportLIV(const QString& baseName, LIVDataProcessor *data, double w, double l)
+{
+    const int numberOfTraces = data->getValueList().size();
+    if (numberOfTraces == 0)
+        return false;
+
+    double currDensityScale = 100000.0 / (w * l);  // [um x mm -> A/cm^2]
+
+    double Imin = std::numeric_limits<double>::max();
+    double Imax = std::numeric_limits<double>::lowest();
+    double Vmin = std::numeric_limits<double>::max();
+    double Vmax = std::numeric_limits<double>::lowest();
+    for (int i = 0; i < numberOfTraces; ++i) {
+        const QVector<double>& I = data->getXList()[i];
+        const QVector<double>& V = data->getY1List()[i];
+        if (!I.isEmpty()) {
+            Imin = std::min(Imin, *std::min_element(I.begin(), I.end()));
+            Imax = std::max(Imax, *std::max_element(I.begin(), I.end()));
+        }
+        if (!V.isEmpty()) {
+            Vmin = std::min(Vmin, *std::min_element(V.begin(), V.end()));
+            Vmax = std::max(Vmax, *std::max_element(V.begin(), V.end()));
+        }
+    }
+    if (Imin > Imax || Vmin > Vmax)
+        return false;
+
+    double I_step = niceStep(Imin, Imax);
+    double V_step = niceStep(Vmin, Vmax);
+    double J_step = niceStep(Imin * currDensityScale, Imax * currDensityScale);
+    double Lmax = 1.75 * data->getScaleFactor();
+    double L_step = niceStep(0.0, Lmax, 7);
+
+    QCustomPlot plot;
+    plot.setFont(QFont("Helvetica", 15));
+
+    QFont labelFont("Arial", 14, QFont::Bold);
+    QFont tickLabelFont("Arial", 12, QFont::Bold);
+    QPen axisPen(Qt::black, 2);
+
+    for (int i = 0; i < numberOfTraces; ++i) {
+        QPen tracePen(graceColor(i), 3);
+
+        plot.addGraph(plot.xAxis, plot.yAxis);
+        plot.graph()->setData(data->getXList()[i], data->getY1List()[i]);
+        plot.graph()->setPen(tracePen);
+
+        double value = data->getValueList()[i].toDouble();
+        plot.graph()->setName(QString::number(value, 'f', std::fmod(value, 1.0) == 0.0 ? 0 : 1) + " [K]");
+
+        QVector<double> J = data->getXList()[i];
+        for (double& val : J)
+            val *= currDensityScale;
+        plot.addGraph(plot.xAxis2, plot.yAxis2);
+        plot.graph()->setData(J, data->getY2List()[i]);
+        plot.graph()->setPen(tracePen);
+        plot.graph()->removeFromLegend();
+    }
+
+    plot.xAxis->setRange(std::floor(Imin / I_step) * I_step, std::ceil(Imax / I_step) * I_step);
+    plot.yAxis->setRange(std::floor(Vmin / V_step) * V_step, std::ceil(Vmax / V_step) * V_step);
+    plot.xAxis2->setRange(std::floor(Imin * currDensityScale / J_step) * J_step,
+                          std::ceil(Imax * currDensityScale / J_step) * J_step);
+    plot.yAxis2->setRange(0, Lmax);
+    plot.xAxis2->setVisible(true);
+    plot.yAxis2->setVisible(true);
+
+    plot.xAxis->setTicker(fixedTicker(I_step));
+    plot.yAxis->setTicker(fixedTicker(V_step));
+    plot.xAxis2->setTicker(fixedTicker(J_step));
+    plot.yAxis2->setTicker(fixedTicker(L_step));
+
+    plot.xAxis->setLabel("𝐼 [A]");
+    plot.yAxis->setLabel("𝑉 [V]");
+    plot.xAxis2->setLabel("𝐽 [A·cm⁻²]");
+    plot.yAxis2->setLabel(data->getScaleFactor() == 100.0 ? "𝐿 [a.u.]" : "𝐿 [mW]");
+
+    QPen gridPen(Qt::black, 1.1, Qt::DashLine);
+    for (QCPAxis *axis : { plot.xAxis, plot.yAxis, plot.xAxis2, plot.yAxis2 }) {
+        axis->setLabelFont(labelFont);
+        axis->setTickLabelFont(tickLabelFont);
+        axis->setBasePen(axisPen);
+        axis->setTickPen(axisPen);
+        axis->setSubTickPen(axisPen);
+        axis->grid()->setVisible(axis == plot.xAxis || axis == plot.yAxis);
+        axis->grid()->setPen(gridPen);
+    }
+
+    plot.legend->setVisible(true);
+    plot.legend->setFont(tickLabelFont);
+    plot.axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignLeft);
+
+    return save(plot, baseName);
+}
+
+/**
+ * \brief Exports the threshold current versus temperature figure.
+ *
+ * \param baseName File name without extension, e.g. "Ith_vs_T_pulsed_liv".
+ * \param data     Extracted thresholds.
+ * \param w        Ridge width in micrometers.
+ * \param l        Ridge length in millimeters.
+ * \return true if every requested output was written, false if there is
+ *         too little data to plot.
+ *
+ * Mirrors IthGracePlot::plot_Ith_vs_T(): experimental points, the exponential
+ * fit with its formula in the legend, mA units below 9.9 A and the current
+ * density on the right axis.
+ */
+bool QtPlotExporter::exportIth(const QString& baseName, IthDataProcessor *data, double w, double l)
+{
+    if (!data->canPlot())
+        return false;
+
+    QVector<double> T = data->getTemperatures();
+    QVector<double> Ith = data->getThresholdCurrents();
+    auto [T_fit, Ith_fit] = data->applyExponentialFit(50);
+
+    double Ith_max = *std::max_element(Ith.begin(), Ith.end()) * 1.05;
+    double Ith_min = *std::min_element(Ith.begin(), Ith.end());
+    double unitScale = Ith_max < 9.9 ? 1000.0 : 1.0;
+    QString unit = unitScale > 1.0 ? "mA" : "A";
+
+    for (double &val : Ith) val *= unitScale;
+    for (double &val : Ith_fit) val *= unitScale;
+
+    QCustomPlot plot;
+    plot.setFont(QFont("Helvetica", 15));
+
+    QFont labelFont("Arial", 14, QFont::Bold);
+    QFont tickLabelFont("Arial", 12, QFont::Bold);
+    QPen axisPen(Qt::black, 2);
+
+    plot.addGraph(plot.xAxis, plot.yAxis);
+    plot.graph()->setData(T, Ith);
+    plot.graph()->setLineStyle(QCPGraph::lsNone);
+    plot.graph()->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, Qt::black, Qt::white, 10));
+    plot.graph()->setName("Experimental data");
+
+    double area_cm2 = (w * 1e-4) * (l * 0.1); // um x mm -> cm^2
+    if (!Ith_fit.isEmpty()) {
+        double A, B, C0;
+        data->getExponentialFitParams(A, B, C0);
+
+        plot.addGraph(plot.xAxis, plot.yAxis);
+        plot.graph()->setData(T_fit, Ith_fit);
+        plot.graph()->setPen(QPen(Qt::red, 3));
+        plot.graph()->setName(QString("𝐼th(𝑇) = %1 + %2 exp(𝑇 / %3) [%4]\n𝐽th(𝑇) = %5 + %6 exp(𝑇 / %3) [A·cm⁻²]")
+                                  .arg(C0 * unitScale, 0, 'f', 1)
+                                  .arg(A * unitScale, 0, 'f', 1)
+                                  .arg(1.0 / B, 0, 'f', 1)
+                                  .arg(unit)
+                                  .arg(C0 / area_cm2, 0, 'f', 1)
+                                  .arg(A / area_cm2, 0, 'f', 1));
+    }
+
+    double T_min = *std::min_element(T.begin(), T.end());
+    double T_max = *std::max_element(T.begin(), T.end());
+    plot.xAxis->setRange(T_min, T_max + (T_max - T_min) * 0.1);
+    plot.yAxis->setRange(Ith_min * unitScale, Ith_max * unitScale);
+    plot.yAxis2->setRange(Ith_min / area_cm2, Ith_max / area_cm2);
+    plot.yAxis2->setVisible(true);
+
+    plot.xAxis->setLabel("𝑇 [K]");
+    plot.yAxis->setLabel("𝐼th [" + unit + "]");
+    plot.yAxis2->setLabel("𝐽th [A·cm⁻²]");
+
+    for (QCPAxis *axis : { plot.xAxis, plot.yAxis, plot.yAxis2 }) {
+        axis->setLabelFont(labelFont);
+        axis->setTickLabelFont(tickLabelFont);
+        axis->setBasePen(axisPen);
+        axis->setTickPen(axisPen);
+    }
+
+    plot.legend->setVisible(true);
+    plot.legend->setFont(tickLabelFont);
+    plot.axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignLeft);
+
+    return save(plot, baseName);
+}
+
+/**
+ * \brief Exports a spectra figure.
+ *
+ * \param baseName File name without extension, e.g. "pulsed_ftir_vs_I".
+ * \param data     Spectra traces.
+ * \return true if every requested output was written.
+ *
+ * Uses the normalised, vertically offset layout of the Grace waterfall plot.
+ */
+bool QtPlotExporter::exportSpectra(const QString& baseName, SpectraDataProcessor *data)
+{
+    if (data->getXList().isEmpty())
+        return false;
+
+    QtSpectraPlotSamePlot plot(data);
+    return save(plot, baseName);
+}
+
+/**
+ * \brief Writes one plot in every requested output profile.
+ *
+ * \param plot     Laid-out plot; it is exported without being shown.
+ * \param baseName File name without extension.
+ * \return true if every output was written.
+ *
+ * The PDF is exported with non-cosmetic pens so line widths scale with the
+ * page. Raster tiers render the same 792 x 612 pt page at dpi / 72 scale, so
+ * all tiers share one layout and differ only in pixel density.
+ */
+bool QtPlotExporter::save(QCustomPlot& plot, const QString& baseName)
+{
+    bool ok = true;
+
+    if (outputProfiles.testFlag(FileConverter::PdfOutput)) {
+        QString pdfPath = figuresDir + "/" + baseName + ".pdf";
+        if (QDir().mkpath(figuresDir) && plot.savePdf(pdfPath, pageWidthPt, pageHeightPt, QCP::epNoCosmetic)) {
+            files.append(pdfPath);
+        } else {
+            qWarning() << "Failed to export PDF:" << pdfPath;
+            ok = false;
+        }
+    }
+
+    for (auto it = tierDpi.constBegin(); it != tierDpi.constEnd(); ++it) {
+        if (!outputProfiles.testFlag(it.key()))
+            continue;
+
+        QString tierDir = FileConverter::tierDirectory(figuresDir, it.key());
+        QString pngPath = tierDir + "/" + baseName + ".png";
+        double scale = it.value() / 72.0;
+        if (QDir().mkpath(tierDir) && plot.savePng(pngPath, pageWidthPt, pageHeightPt, scale, -1, it.value())) {
+            files.append(pngPath);
+        } else {
+            qWarning() << "Failed to export PNG:" << pngPath;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
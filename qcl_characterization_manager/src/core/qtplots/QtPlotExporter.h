@@ -0,0 +1,64 @@
+/**
+ * @file QtPlotExporter.h
+ * @brief Declaration of QtPlotExporter, an offscreen QCustomPlot backend for the report figures.
+ *
+ * Builds the LIV, Ith and spectra figures with QCustomPlot and writes them
+ * with savePdf/savePng, as an alternative to the qtgrace + Ghostscript chain.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#ifndef QTPLOTEXPORTER_H
+	#define QTPLOTEXPORTER_H
+
+	#include <QString>
+	#include <QStringList>
+	#include <QMap>
+	#include "core/fileconversion/FileConverter.h"
+	#include "core/dataprocessing/LIVDataProcessor.h"
+	#include "core/dataprocessing/IthDataProcessor.h"
+	#include "core/dataprocessing/SpectraDataProcessor.h"
+
+	class QCustomPlot;
+
+	/**
+	 * @class QtPlotExporter
+	 * @brief Renders the report figures offscreen and exports them as PDF and PNG tiers.
+	 *
+	 * Plots are never shown; each is laid out on the same US-letter landscape
+	 * page (792 x 612 pt) that the Grace templates use and exported straight
+	 * from QCustomPlot. Output files use the same names and folders as
+	 * FileConverter, so the carousel and the datasheet pick them up unchanged:
+	 * - PdfOutput     -> Figures/<name>.pdf
+	 * - PrintTier     -> Figures/<name>.png
+	 * - PreviewTier   -> Figures/preview/<name>.png
+	 * - ThumbnailTier -> Figures/thumbnails/<name>.png
+	 *
+	 * Export is synchronous and must run on the GUI thread, since QCustomPlot
+	 * is a widget. It takes a few milliseconds per figure, so no process pool
+	 * is needed.
+	 */
+	class QtPlotExporter
+	{
+		public:
+			explicit QtPlotExporter(const QString& figuresDirPath); ///< Constructor, creates the output folders on first export
+
+			void setOutputProfiles(FileConverter::OutputProfiles profiles) { outputProfiles = profiles; } ///< Select which outputs are produced
+			FileConverter::OutputProfiles profiles() const { return outputProfiles; } ///< Outputs produced for each figure
+			void setTierResolution(FileConverter::OutputProfile tier, int dpi); ///< Override the DPI of a raster tier
+
+			bool exportLIV(const QString& baseName, LIVDataProcessor *data, double w, double l); ///< LIV figure (V and L against I, J on top)
+			bool exportIth(const QString& baseName, IthDataProcessor *data, double w, double l); ///< Ith vs T figure with exponential fit
+			bool exportSpectra(const QString& baseName, SpectraDataProcessor *data); ///< Offset (waterfall) spectra figure
+
+			QStringList writtenFiles() const { return files; } ///< Files written so far
+
+		private:
+			bool save(QCustomPlot& plot, const QString& baseName); ///< Export one plot in every requested profile
+
+			QString figuresDir;                                  ///< Output 'Figures' directory
+			FileConverter::OutputProfiles outputProfiles;        ///< Outputs to produce
+			QMap<FileConverter::OutputProfile, int> tierDpi;     ///< Resolution per raster tier
+			QStringList files;                                   ///< Files written so far
+	};
+#endif // QTPLOTEXPORTER_H
@@ -36,9 +36,8 @@ QtSpectraPlotStacked::QtSpectraPlotStacked(SpectraDataProcessor *data, QWidget *
 
     for (int i = 0; i < xList.length(); ++i) {
         for (double x : xList[i]) {
-            double scaledX = x / 33.356;
-            minX = std::min(minX, scaledX);
-            maxX = std::max(maxX, scaledX);
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
         }
         for (double y : y1List[i]) {
             minY1 = std::min(minY1, y);
@@ -59,13 +58,9 @@ QtSpectraPlotStacked::QtSpectraPlotStacked(SpectraDataProcessor *data, QWidget *
     for (int i = 0; i < xList.length(); i++) {
         int invertedIdx = xList.length() - 1 - i;
         const QString &value = valueList[invertedIdx];
-        QVector<double> x = xList[invertedIdx];
+        QVector<double> x = xList[invertedIdx];  // already in THz (SpectraDataProcessor)
         QVector<double> y1 = y1List[invertedIdx];
 
-        for (double &val : x) {
-            val /= 33.356;
-        }
-
         QColor lineColor = valueToColor(value, data->traceVariable);
 
         QCPAxisRect *_axisRect = new QCPAxisRect(this);
@@ -73,7 +68,7 @@ QtSpectraPlotStacked::QtSpectraPlotStacked(SpectraDataProcessor *data, QWidget *
         _axisRect->insetLayout()->setSizeConstraintRect(QCPColorScaleAxisRectPrivate::SizeConstraintRect::scrOuterRect);
 
         QCPGraph *_graph = addGraph(_axisRect->axis(QCPAxis::atBottom), _axisRect->axis(QCPAxis::atLeft));
-        _graph->setData(x, y1);
+        setGraphData(_graph, x, y1);
         _graph->setPen(QPen(lineColor, 4));
         _graph->setName(value + data->unit);
 
@@ -134,13 +129,9 @@ QtSpectraPlotSamePlot::QtSpectraPlotSamePlot(SpectraDataProcessor *data, QWidget
 
     for (int i = 0; i < xList.length(); i++) {
         const QString &value = valueList[i];
-        QVector<double> x = xList[i];
+        QVector<double> x = xList[i];  // already in THz (SpectraDataProcessor)
         QVector<double> y1 = y1List[i];
 
-        for (double &val : x) {
-            val /= 33.356;
-        }
-
         for (int j = 0; j < x.size(); ++j) {
             if (y1[j] > maxIntensity) {
                 maxIntensity = y1[j];
@@ -158,7 +149,7 @@ QtSpectraPlotSamePlot::QtSpectraPlotSamePlot(SpectraDataProcessor *data, QWidget
         QColor lineColor = valueToColor(value, data->traceVariable);
 
         addGraph(xAxis, yAxis);
-        graph()->setData(x, y1);
+        setGraphData(graph(), x, y1);
         graph()->setPen(QPen(lineColor, 4));
 
         QCPItemText *textLabel = new QCPItemText(this);
@@ -169,8 +160,8 @@ QtSpectraPlotSamePlot::QtSpectraPlotSamePlot(SpectraDataProcessor *data, QWidget
         textLabel->setText(value + data->unit);
     }
 
-    double newMinX = std::max(peakFrequency - 0.7, *std::min_element(xList[0].begin(), xList[0].end()) / 33.356);
-    double newMaxX = std::min(peakFrequency + 0.7, *std::max_element(xList[0].begin(), xList[0].end()) / 33.356);
+    double newMinX = std::max(peakFrequency - 0.7, *std::min_element(xList[0].begin(), xList[0].end()));
+    double newMaxX = std::min(peakFrequency + 0.7, *std::max_element(xList[0].begin(), xList[0].end()));
     xAxis->setRange(newMinX, newMaxX);
 
     QFont tickLabelFont("Arial", 12, QFont::Bold);
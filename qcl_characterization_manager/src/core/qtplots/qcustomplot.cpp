@@ -908,7 +908,12 @@ void QCPPaintBufferGlFbo::draw(QCPPainter *painter) const
     qDebug() << Q_FUNC_INFO << "OpenGL frame buffer object doesn't exist, reallocateBuffer was not called?";
     return;
   }
-  painter->drawImage(0, 0, mGlFrameBuffer->toImage());
+  // the framebuffer is mSize*mDevicePixelRatio pixels; tag the image so it is not drawn magnified on high-DPI screens
+  QImage image = mGlFrameBuffer->toImage();
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  image.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+  painter->drawImage(0, 0, image);
 }
 
 /* inherits documentation from base class */
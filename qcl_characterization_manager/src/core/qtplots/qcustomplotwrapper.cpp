@@ -1,11 +1,12 @@
 #include "qcustomplotwrapper.h"
+#include "GraphLevelOfDetail.h"
+#include <algorithm>
 
 QCustomPlotWrapper::QCustomPlotWrapper(IDataProcessor *data, QWidget *parent)
     : QCustomPlot{parent}
-    , data(data)
 {
-    // turn on OpenGL hardware acceleration // scaling issue, TODO
-    // setOpenGl(true);
+    // OpenGL is switched on by the view showing the plot (ImageCarousel);
+    // offscreen exports keep the raster buffers and need no GL context
 
     // turn on interactions
     setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectPlottables);
@@ -69,6 +70,14 @@ void QCustomPlotWrapper::setRange(QList<QCPAxis *> axisList,
         axis->setRange(adjustedLower, adjustedUpper);
 }
 
+// Set the data of a graph; dense sorted traces get a level-of-detail pyramid
+void QCustomPlotWrapper::setGraphData(QCPGraph *graph, const QVector<double> &x, const QVector<double> &y)
+{
+    graph->setData(x, y);
+    if (x.size() >= GraphLevelOfDetail::minimumPoints && std::is_sorted(x.begin(), x.end()))
+        new GraphLevelOfDetail(graph, x, y);
+}
+
 // Map a value to a color
 QColor QCustomPlotWrapper::valueToColor(const QString &valueString, const QString &variable)
 {
@@ -18,9 +18,10 @@ class QCustomPlotWrapper : public QCustomPlot
 		void setRange(QList<QCPAxis *> axis, double lower, double upper, double adjustVal = -1);
 		QColor valueToColor(const QString &valueString, const QString &variable);
 		QColor toRainbowColor(const QString &valueString, double lower, double upper);
+		void setGraphData(QCPGraph *graph, const QVector<double> &x, const QVector<double> &y);
 
-		// pointer to data object
-		IDataProcessor *data;
+		// The data object is only read while constructing; plots shown after
+		// the processors are freed must not keep a pointer to it
 };
 
 #endif // QCUSTOMPLOTWRAPPER_H
@@ -1,12 +1,15 @@
 SOURCES += \
     $$PWD/qcustomplot.cpp \
     $$PWD/qcustomplotwrapper.cpp \
+    $$PWD/GraphLevelOfDetail.cpp \
     $$PWD/QtLIVPlot.cpp	\
-    $$PWD/QtSpectraPlot.cpp
+    $$PWD/QtSpectraPlot.cpp	\
+    $$PWD/QtPlotExporter.cpp
 
 HEADERS += \
     $$PWD/qcustomplot.h \
     $$PWD/qcustomplotwrapper.h \
+    $$PWD/GraphLevelOfDetail.h \
     $$PWD/QtLIVPlot.h	\
-    $$PWD/QtSpectraPlot.h
-
+    $$PWD/QtSpectraPlot.h	\
+    $$PWD/QtPlotExporter.h
@@ -0,0 +1,29 @@
+# Precomputed stylesheet
+#
+# The @variables of style.sass are substituted into style.qss when qmake runs
+# and the result is embedded as :/src/resources/style/style.generated.qss, so
+# the application applies it at startup without any parsing. The Makefile
+# re-runs qmake whenever style.qss or style.sass changes.
+
+STYLE_QSS = $$cat($$PWD/style.qss, blob)
+STYLE_SASS = $$cat($$PWD/style.sass, lines)
+
+for(declaration, STYLE_SASS) {
+    # @primaryMain = "#007AFF"  ->  primaryMain, #007AFF
+    style_name = $$section(declaration, =, 0, 0)
+    style_name = $$replace(style_name, [@\\s], )
+    style_value = $$section(declaration, =, 1, -1)
+    style_value = $$replace(style_value, [\\s;], )
+    style_value = $$replace(style_value, ^.(.*).$, \\1)
+    !isEmpty(style_name): STYLE_QSS = $$replace(STYLE_QSS, $$style_name, $$style_value)
+}
+
+STYLE_GENERATED = $$OUT_PWD/style.generated.qss
+!write_file($$STYLE_GENERATED, STYLE_QSS): error(Cannot write $$STYLE_GENERATED)
+
+generated_style.files = $$STYLE_GENERATED
+generated_style.base = $$OUT_PWD
+generated_style.prefix = /src/resources/style
+RESOURCES += generated_style
+
+QMAKE_INTERNAL_INCLUDED_FILES += $$PWD/style.qss $$PWD/style.sass
@@ -3,7 +3,7 @@
  * @brief Implementation of a button that displays an image and handles selection logic.
  * 
  * This class extends ButtonGroupButton to create a button with a custom image,
- * loaded from a file. The image is scaled and used as the button icon.
+ * loaded from a file. A cached thumbnail of the image is used as the button icon.
  * 
  * The class handles user interaction by emitting the button's ID and file path
  * when clicked, and visually reflects selection status based on ID comparison.
@@ -13,12 +13,14 @@
 
 #include "ImageButton.h"
 #include <QPixmap>
+#include "ThumbnailCache.h"
 
 /**
  * @brief Constructs an ImageButton with a given ID and image file path.
  * 
- * This constructor initializes the button with an image loaded from the specified file path.
- * The image is scaled to 150x150 pixels (maintaining aspect ratio) and set as the button icon.
+ * The button starts with an empty 150x150 icon area; the thumbnail is
+ * requested from ThumbnailCache and set as the icon when it arrives, so
+ * building a menu of many figures does not decode any of them here.
  * 
  * @param id The identifier for the button within a group.
  * @param filePath The path to the image file used as the button icon.
@@ -27,10 +29,25 @@
 ImageButton::ImageButton(int id, const QString &filePath, QWidget *parent)
     : ButtonGroupButton{id, "Image", "contained", parent}, filePath(filePath)
 {
-    QPixmap pixmapOriginal(filePath);
-    QPixmap pixmap = pixmapOriginal.scaled(150, 150, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    QIcon icon(pixmap);
-    this->setIcon(icon);
+    this->setIconSize(QSize(ThumbnailCache::thumbnailSize, ThumbnailCache::thumbnailSize));
+
+    ThumbnailCache::instance()->request(filePath, this, [this](const QImage &thumbnail) {
+        thumbnailReadySlot(thumbnail);
+    });
+}
+
+/**
+ * @brief Sets the thumbnail as the icon once the cache delivers it.
+ * 
+ * @param thumbnail The thumbnail of this button's image, null if it could not be read.
+ */
+void ImageButton::thumbnailReadySlot(const QImage &thumbnail)
+{
+    if (thumbnail.isNull())
+        return;
+
+    QPixmap pixmap = QPixmap::fromImage(thumbnail);
+    this->setIcon(QIcon(pixmap));
     this->setIconSize(pixmap.rect().size());
 }
 
@@ -10,6 +10,7 @@
 
 #ifndef IMAGEBUTTON_H
 	#define IMAGEBUTTON_H
+	#include <QImage>
 	#include "ButtonGroupButton.h"
 
 	/**
@@ -33,5 +34,6 @@
 		public slots:
 			void clickedSlot(); ///< Handles internal click event.
 			void buttonClickedIdSlot(int id); ///< Slot to handle click event by ID.
+			void thumbnailReadySlot(const QImage &thumbnail); ///< Sets the icon once the thumbnail is loaded.
 	};
 #endif // IMAGEBUTTON_H
\ No newline at end of file
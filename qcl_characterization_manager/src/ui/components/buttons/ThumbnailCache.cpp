@@ -0,0 +1,182 @@
+/**
+ * @file ThumbnailCache.cpp
+ * @brief Implementation of the disk-backed thumbnail cache of the image menu.
+ *
+ * Lookups, decoding, writing and pruning all run on a small thread pool; the
+ * GUI thread only hands each finished thumbnail to the callers waiting for it.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "ThumbnailCache.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QDebug>
+
+/**
+ * @brief Returns the cache shared by the application.
+ *
+ * Created on first use and owned by the application object, so its pool
+ * finishes before the application is torn down.
+ */
+ThumbnailCache *ThumbnailCache::instance()
+{
+    static ThumbnailCache *cache = new ThumbnailCache(QCoreApplication::instance());
+    return cache;
+}
+
+/**
+ * @brief Constructs the cache in the user's cache location.
+ *
+ * @param parent The parent object.
+ */
+ThumbnailCache::ThumbnailCache(QObject *parent)
+    : QObject{parent}
+    , cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails")
+{
+    pool.setMaxThreadCount(2);
+    QDir().mkpath(cacheDir);
+
+    QString dir = cacheDir;
+    pool.start([dir]() { prune(dir, maxCacheBytes); });
+}
+
+/**
+ * @brief Loads the thumbnail of an image in the background.
+ *
+ * Only the callers that asked for this image are called back; a request for
+ * an image already being loaded is added to its list instead of loading it
+ * again.
+ *
+ * @param filePath The full-size image.
+ * @param receiver Owner of the callback; if it is deleted first, the callback is dropped.
+ * @param callback Called on the GUI thread with the thumbnail.
+ */
+void ThumbnailCache::request(const QString &filePath, QObject *receiver, const Callback &callback)
+{
+    auto it = pending.find(filePath);
+    if (it != pending.end()) {
+        it->append({ receiver, callback });
+        return;
+    }
+    pending.insert(filePath, { { receiver, callback } });
+
+    QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, filePath]() {
+        QImage thumbnail = watcher->result();
+        watcher->deleteLater();
+        const QList<Request> requests = pending.take(filePath);
+        for (const Request &request : requests) {
+            if (request.receiver)
+                request.callback(thumbnail);
+        }
+    });
+
+    QString dir = cacheDir;
+    watcher->setFuture(QtConcurrent::run(&pool, [filePath, dir]() {
+        return loadThumbnail(filePath, dir);
+    }));
+}
+
+/**
+ * @brief Reads a thumbnail from the cache, creating it on a miss.
+ *
+ * Runs on a worker thread. A failed write only costs the next launch a
+ * decode, so it is not reported beyond a warning.
+ *
+ * @param filePath The full-size image.
+ * @param cacheDir Folder holding the thumbnails.
+ * @return The thumbnail, or a null image if the file cannot be read.
+ */
+QImage ThumbnailCache::loadThumbnail(const QString &filePath, const QString &cacheDir)
+{
+    QFileInfo info(filePath);
+    if (!info.exists())
+        return QImage();
+
+    QCryptographicHash imageHash(QCryptographicHash::Sha1);
+    imageHash.addData(info.absoluteFilePath().toUtf8());
+    imageHash.addData(QByteArray::number(thumbnailSize));
+    QString imageKey = QString::fromLatin1(imageHash.result().toHex());
+
+    QCryptographicHash versionHash(QCryptographicHash::Sha1);
+    versionHash.addData(QByteArray::number(info.size()));
+    versionHash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    QString thumbnailName = imageKey + "_" + QString::fromLatin1(versionHash.result().toHex()) + ".png";
+    QString thumbnailPath = cacheDir + "/" + thumbnailName;
+
+    QImage thumbnail(thumbnailPath);
+    if (!thumbnail.isNull()) {
+        // Marks the entry as recently used for prune()
+        QFile entry(thumbnailPath);
+        if (entry.open(QIODevice::ReadWrite))
+            entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        return thumbnail;
+    }
+
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    QSize size = reader.size();
+    QSize box(thumbnailSize, thumbnailSize);
+    if (size.isValid() && (size.width() > box.width() || size.height() > box.height()))
+        reader.setScaledSize(size.scaled(box, Qt::KeepAspectRatio));
+
+    thumbnail = reader.read();
+    if (thumbnail.isNull()) {
+        qWarning() << "Cannot decode" << filePath << ":" << reader.errorString();
+        return thumbnail;
+    }
+    if (!size.isValid())
+        thumbnail = thumbnail.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    // QSaveFile, so two windows filling the same entry never leave a torn PNG
+    QSaveFile file(thumbnailPath);
+    if (!file.open(QIODevice::WriteOnly) || !QImageWriter(&file, "png").write(thumbnail) || !file.commit()) {
+        qWarning() << "Cannot write thumbnail" << thumbnailPath;
+        return thumbnail;
+    }
+
+    // Older versions of the same image can never be hit again
+    QDir dir(cacheDir);
+    for (const QString &stale : dir.entryList({ imageKey + "_*.png" }, QDir::Files)) {
+        if (stale != thumbnailName)
+            dir.remove(stale);
+    }
+    return thumbnail;
+}
+
+/**
+ * @brief Deletes the least recently used thumbnails until the folder fits.
+ *
+ * Runs on a worker thread. Entries are ordered by modification time, which
+ * loadThumbnail() refreshes on every hit. Deleting an entry another worker
+ * is about to read only turns that read into a miss.
+ *
+ * @param cacheDir Folder holding the thumbnails.
+ * @param maxBytes Size the folder may keep.
+ */
+void ThumbnailCache::prune(const QString &cacheDir, qint64 maxBytes)
+{
+    QFileInfoList entries = QDir(cacheDir).entryInfoList({ "*.png" }, QDir::Files, QDir::Time | QDir::Reversed);
+
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries)
+        total += entry.size();
+
+    for (const QFileInfo &entry : entries) {
+        if (total <= maxBytes)
+            break;
+        if (QFile::remove(entry.absoluteFilePath()))
+            total -= entry.size();
+    }
+}
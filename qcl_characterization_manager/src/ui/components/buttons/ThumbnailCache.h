@@ -0,0 +1,70 @@
+/**
+ * @file ThumbnailCache.h
+ * @brief Declaration of ThumbnailCache, a disk-backed store of image menu thumbnails.
+ *
+ * Thumbnails are produced and read on worker threads and kept between
+ * launches, so reopening a results folder does not decode its figures again.
+ *
+ * @author Aleksandar Demic
+ */
+
+#ifndef THUMBNAILCACHE_H
+	#define THUMBNAILCACHE_H
+	#include <QObject>
+	#include <QImage>
+	#include <QHash>
+	#include <QList>
+	#include <QPointer>
+	#include <QString>
+	#include <QThreadPool>
+	#include <functional>
+
+	/**
+	 * @class ThumbnailCache
+	 * @brief Shared thumbnail store used by ImageButton.
+	 *
+	 * Each thumbnail is a small PNG in <cache location>/thumbnails named
+	 * <image key>_<version key>.png: the SHA-1 of the image's absolute path
+	 * and the thumbnail size, then the SHA-1 of its size and modification
+	 * time. A changed or regenerated figure therefore gets a new entry and
+	 * never shows a stale thumbnail, and writing that entry deletes the
+	 * older versions of the same image. On a miss the image is decoded with
+	 * QImageReader::setScaledSize and the result is written back; on a hit
+	 * only the small PNG is read and its modification time is refreshed.
+	 *
+	 * The folder is kept under maxCacheBytes: once per launch the least
+	 * recently used entries beyond it are deleted on the pool.
+	 */
+	class ThumbnailCache : public QObject
+	{
+			Q_OBJECT
+
+		public:
+			static const int thumbnailSize = 150;                 ///< Bounding box of a thumbnail [px]
+			static const qint64 maxCacheBytes = 64 * 1024 * 1024; ///< Size the folder is pruned to [bytes]
+
+			/// Receives a thumbnail on the GUI thread; null if the image is unreadable.
+			using Callback = std::function<void(const QImage &thumbnail)>;
+
+			static ThumbnailCache *instance(); ///< Cache shared by the application
+
+			void request(const QString &filePath, QObject *receiver, const Callback &callback); ///< Load or create a thumbnail for one receiver
+
+		private:
+			/// A caller waiting for a thumbnail; skipped if its receiver was deleted meanwhile.
+			struct Request
+			{
+				QPointer<QObject> receiver; ///< Object the callback belongs to
+				Callback callback;          ///< Called with the thumbnail
+			};
+
+			explicit ThumbnailCache(QObject *parent = nullptr); ///< Use instance()
+
+			static QImage loadThumbnail(const QString &filePath, const QString &cacheDir); ///< Worker: read from or fill the cache
+			static void prune(const QString &cacheDir, qint64 maxBytes); ///< Worker: delete the least recently used entries
+
+			QString cacheDir;                      ///< Folder holding the thumbnails
+			QHash<QString, QList<Request>> pending; ///< Callers of each image being loaded
+			QThreadPool pool;                      ///< Workers reading and decoding
+	};
+#endif // THUMBNAILCACHE_H
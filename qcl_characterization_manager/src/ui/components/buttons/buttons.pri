@@ -3,9 +3,11 @@ SOURCES += \
     $$PWD/ButtonGroupButton.cpp \
     $$PWD/ImageButton.cpp \
     $$PWD/PushButton.cpp \
+    $$PWD/ThumbnailCache.cpp \
  
 HEADERS += \
     $$PWD/ButtonGroup.h \
     $$PWD/ButtonGroupButton.h \
     $$PWD/ImageButton.h \
-    $$PWD/PushButton.h \
\ No newline at end of file
+    $$PWD/PushButton.h \
+    $$PWD/ThumbnailCache.h \
\ No newline at end of file
@@ -7,6 +7,7 @@
  * 
  * Each image is displayed in a centered layout and scaled appropriately. The carousel supports
  * adding both image files and dynamic plots, making it flexible for data visualization UIs.
+ * Image files are decoded at display size on worker threads, only around the current page.
  * 
  * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
  */
@@ -14,6 +15,10 @@
 #include "imagecarousel.h"
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QImageReader>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QDebug>
 #include "ui/components/buttons/PushButton.h"
 #include "ui/components/buttons/ButtonGroupButton.h"
 #include "ui/components/buttons/ImageButton.h"
@@ -30,6 +35,10 @@ ImageCarousel::ImageCarousel(QWidget *parent)
     : Widget{parent}
     , imageStack(new QStackedWidget())
 {
+    // One worker per page of the decode window; the cache holds the recently viewed pages
+    decodePool.setMaxThreadCount(3);
+    pixmapCache.setMaxCost(cachedPages);
+
     QHBoxLayout *layout = new QHBoxLayout();
     setLayout(layout);
 
@@ -52,8 +61,9 @@ ImageCarousel::ImageCarousel(QWidget *parent)
 /**
  * @brief Adds an image to the carousel from a file path.
  * 
- * Loads and scales the image, wraps it in a QWidget with a QLabel,
- * and adds it to the stacked widget.
+ * Wraps a placeholder QLabel in a QWidget and adds it to the stacked
+ * widget; the file is not read here. If the page falls next to the
+ * current one, its decoding starts right away.
  * 
  * @param imagePath Path to the image file.
  */
@@ -62,23 +72,34 @@ void ImageCarousel::addImage(const QString &imagePath)
     Widget *imageWidget = new Widget();
     imageWidget->setLayout(new QHBoxLayout());
 
-    QPixmap img(imagePath);
-    QLabel *imgLabel = new QLabel();
-    imgLabel->setPixmap(img.scaled(400, 400, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    QLabel *imgLabel = new QLabel("Loading...");
+    imgLabel->setMinimumSize(imageSize, imageSize);
     imgLabel->setAlignment(Qt::AlignCenter);
     imageWidget->layout()->addWidget(imgLabel);
+
+    // Register the page first: adding to an empty stack emits currentChanged
+    imagePages.insert(imageWidget, ImagePage{imagePath, imgLabel});
     imageStack->addWidget(imageWidget);
+    showPagesAround(imageStack->currentIndex());
 }
 
 /**
  * @brief Adds a QCustomPlot to the carousel.
  * 
- * Inserts the given plot widget directly into the stacked image area.
+ * Inserts the given plot widget directly into the stacked image area and
+ * renders it through OpenGL when QCustomPlot was built with
+ * QCUSTOMPLOT_USE_OPENGL; it falls back to the raster buffers if no
+ * context can be created. Antialiasing is dropped while dragging so
+ * panning stays smooth.
  * 
  * @param plot The QCustomPlot widget to add.
  */
 void ImageCarousel::addImage(QCustomPlot *plot)
 {
+#ifdef QCUSTOMPLOT_USE_OPENGL
+    plot->setOpenGl(true);
+#endif
+    plot->setNoAntialiasingOnDrag(true);
     imageStack->addWidget(plot);
 }
 
@@ -99,14 +120,134 @@ void ImageCarousel::setImageStackIndex(int index)
         imageStack->setCurrentIndex(index);
 }
 
+/**
+ * @brief Handles a change of the current page.
+ * 
+ * @param id Index of the new current page.
+ */
+void ImageCarousel::currentChangedSlot(int id)
+{
+    showPagesAround(id);
+    emit currentChanged(id);
+}
+
+/**
+ * @brief Shows the decoded images of a page and its neighbours.
+ * 
+ * The window wraps around like the navigation buttons. Window pages take
+ * their pixmap from the cache or start decoding; every other image page
+ * goes back to its placeholder, so only the cache keeps decoded images.
+ * 
+ * @param index Index of the current page.
+ */
+void ImageCarousel::showPagesAround(int index)
+{
+    int count = imageStack->count();
+    if (index < 0 || count == 0)
+        return;
+
+    QSet<QWidget*> window;
+    for (int offset = -1; offset <= 1; ++offset)
+        window.insert(imageStack->widget((index + offset + count) % count));
+
+    for (auto it = imagePages.begin(); it != imagePages.end(); ++it) {
+        ImagePage &page = it.value();
+        if (!window.contains(it.key())) {
+            if (!page.label->pixmap().isNull())
+                page.label->setText("Loading...");
+            continue;
+        }
+
+        if (QPixmap *cached = pixmapCache.object(page.path))
+            page.label->setPixmap(*cached);
+        else
+            startDecode(page.path);
+    }
+}
+
+/**
+ * @brief Decodes an image at display size on the decode pool.
+ * 
+ * QImageReader::setScaledSize lets the image plugin scale while reading,
+ * so the GUI thread only converts the small result to a pixmap.
+ * 
+ * @param path Image file.
+ */
+void ImageCarousel::startDecode(const QString &path)
+{
+    if (pendingDecodes.contains(path))
+        return;
+    pendingDecodes.insert(path);
+
+    quint64 decodeGeneration = generation;
+    QSize box = QSize(imageSize, imageSize) * devicePixelRatioF();
+
+    QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, path, decodeGeneration]() {
+        QImage image = watcher->result();
+        watcher->deleteLater();
+        onDecoded(path, image, decodeGeneration);
+    });
+
+    watcher->setFuture(QtConcurrent::run(&decodePool, [path, box]() {
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+
+        QSize size = reader.size();
+        if (size.isValid() && (size.width() > box.width() || size.height() > box.height()))
+            reader.setScaledSize(size.scaled(box, Qt::KeepAspectRatio));
+
+        QImage image = reader.read();
+        if (image.isNull())
+            qWarning() << "Cannot decode" << path << ":" << reader.errorString();
+        else if (!size.isValid())
+            image = image.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        return image;
+    }));
+}
+
+/**
+ * @brief Caches a decoded image and shows it if its page is in the window.
+ * 
+ * @param path             Image file.
+ * @param image            Decoded image, null on failure.
+ * @param decodeGeneration Value of generation when the decode started.
+ */
+void ImageCarousel::onDecoded(const QString &path, const QImage &image, quint64 decodeGeneration)
+{
+    if (decodeGeneration != generation)
+        return;  // the carousel was cleared meanwhile
+    pendingDecodes.remove(path);
+
+    if (image.isNull()) {
+        for (ImagePage &page : imagePages) {
+            if (page.path == path)
+                page.label->setText("Cannot load image");
+        }
+        return;
+    }
+
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+    pixmap->setDevicePixelRatio(devicePixelRatioF());
+    pixmapCache.insert(path, pixmap, 1);
+    showPagesAround(imageStack->currentIndex());
+}
+
 /**
  * @brief Clears all images and plots from the carousel.
  * 
  * Removes and safely deletes all widgets from the QStackedWidget,
- * then resets the index to ensure no item is shown.
+ * then resets the index to ensure no item is shown. Decodes still
+ * running are ignored when they finish, and the cache is emptied since
+ * the same paths may be regenerated.
  */
 void ImageCarousel::clear()
 {
+    ++generation;
+    pendingDecodes.clear();
+    pixmapCache.clear();
+    imagePages.clear();
+
     while (imageStack->count() > 0) {
         QWidget *widget = imageStack->widget(0);
         imageStack->removeWidget(widget);
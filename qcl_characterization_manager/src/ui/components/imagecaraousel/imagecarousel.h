@@ -4,6 +4,7 @@
  *
  * Provides a carousel widget to display images or QCustomPlot objects.
  * Supports navigation through images and emits signals when current image changes.
+ * Image files are decoded lazily, downscaled and off the GUI thread.
  * 
  * @author Aleksandar Demic
  */
@@ -11,6 +12,12 @@
 #ifndef IMAGECAROUSEL_H
 	#define IMAGECAROUSEL_H
 	#include <QStackedWidget>
+	#include <QLabel>
+	#include <QHash>
+	#include <QSet>
+	#include <QCache>
+	#include <QPixmap>
+	#include <QThreadPool>
 	#include "core/qtplots/qcustomplot.h"
 	#include "ui/components/containers/Widget.h"
 
@@ -20,11 +27,21 @@
 	 *
 	 * Manages a stack of images or QCustomPlot widgets, allowing navigation
 	 * and emitting signals on image changes.
+	 *
+	 * addImage(const QString&) only adds a placeholder page. The current page
+	 * and its two neighbours are decoded on worker threads with
+	 * QImageReader::setScaledSize, so a full-resolution figure is never held
+	 * as a pixmap. Decoded pages are kept in an LRU cache of cachedPages
+	 * entries; pages outside the window drop their pixmap, so memory stays
+	 * bounded whatever the number of figures.
 	 */
 	class ImageCarousel : public Widget
 	{
 			Q_OBJECT
 		public:
+			static const int imageSize = 400;  ///< Bounding box of a displayed image [px]
+			static const int cachedPages = 12; ///< Decoded images kept by the LRU cache
+
 			explicit ImageCarousel(QWidget *parent = nullptr); ///< Constructs image carousel.
 
 			void addImage(const QString &imagePath); ///< Adds an image by file path.
@@ -40,8 +57,26 @@
 		public slots:
 			void prevClicked() { setImageStackIndex(imageStack->currentIndex() - 1); } ///< Shows previous image.
 			void nextClicked() { setImageStackIndex(imageStack->currentIndex() + 1); } ///< Shows next image.
-			void currentChangedSlot(int id) { emit currentChanged(id); } ///< Emits currentChanged signal.
+			void currentChangedSlot(int id); ///< Decodes the pages around id and emits currentChanged.
+
 		private:
-			// No private members
+			/**
+			 * @struct ImagePage
+			 * @brief Page of an image file, decoded on demand.
+			 */
+			struct ImagePage {
+				QString path;            ///< Image file
+				QLabel *label = nullptr; ///< Shows the image or a placeholder
+			};
+
+			void showPagesAround(int index); ///< Fill the window of pages around index, release the others
+			void startDecode(const QString &path); ///< Decode an image on the pool
+			void onDecoded(const QString &path, const QImage &image, quint64 decodeGeneration); ///< Decoded image arrived
+
+			QHash<QWidget*, ImagePage> imagePages; ///< Image pages by stack widget
+			QCache<QString, QPixmap> pixmapCache;  ///< Decoded images, least recently used evicted first
+			QSet<QString> pendingDecodes;          ///< Images being decoded
+			QThreadPool decodePool;                ///< Workers decoding the images
+			quint64 generation = 0;                ///< Bumped by clear() to drop stale results
 	};
 #endif // IMAGECAROUSEL_H
\ No newline at end of file
@@ -73,10 +73,24 @@ void Wizard::setCurrentIndexWrapper(int id)
     }
 
     // Handle finishing wizard
+    if (id >= wizardPages->count())
+        finishWizard();
+    else
+        updateNextButton(id);
+}
+
+// Shows a page without validating the pages before it, e.g. for data loaded from a file
+void Wizard::showPage(int id)
+{
+    wizardPages->setCurrentIndex(id);
+    updateNextButton(id);
+}
+
+// The next button finishes the wizard on the last page
+void Wizard::updateNextButton(int id)
+{
     if (id == wizardPages->count() - 1 && id != 0)
         ((PushButton *)wizardButtons->layout()->itemAt(3)->widget())->setText("Finish");
-    else if (id >= wizardPages->count())
-        finishWizard();
     else
         ((PushButton *)wizardButtons->layout()->itemAt(3)->widget())->setText("Next");
 }
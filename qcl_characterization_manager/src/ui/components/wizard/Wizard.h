@@ -31,6 +31,7 @@
 			void addPage(WizardPage *page); ///< Adds a wizard page.
 			void getWizardFields(); ///< Retrieves data from wizard pages.
 			void finishWizard(); ///< Performs finishing steps.
+			void showPage(int id); ///< Shows a page without validating earlier pages.
 			virtual void finishWizardAction() = 0; ///< Abstract method to handle finishing action.
 			QStackedWidget *wizardPages; ///< Container for wizard pages.
 
@@ -42,6 +43,8 @@
 			void wizardButtonsClick(int id); ///< Handles wizard button clicks.
 
 		private:
+			void updateNextButton(int id); ///< Shows "Finish" or "Next" for the given page.
+
 			ButtonGroup *wizardMenu;    ///< Navigation menu for wizard pages.
 			ButtonGroup *wizardButtons; ///< Control buttons for wizard (Next, Back, Finish).
 	};
@@ -11,6 +11,7 @@
 #include <QAbstractButton>
 #include "ui/dialogs/MessageBox.h"
 #include "WizardFieldWidget.h"
+#include "WizardFileListModel.h"
 
 /**
  * @brief Displays a warning when no file is selected.
@@ -72,20 +73,19 @@ bool WizardField::noFileSelected()
 }
 
 /**
- * @brief Connects file-specific change signals to the WizardField.
+ * @brief Connects a file field to the model holding its files.
  * 
- * This method sets up connection for file-related QVariantMap changes and stores the associated variable name.
+ * The model is shared with the file field widget, which edits it. The field
+ * keeps no copy of the files: collecting, printing and validating the field
+ * read the model, so editing a value never copies the file list.
  * 
- * @param object The QObject emitting file change signals.
- * @param changedSignal The signal to connect for file changes.
+ * @param model The model of the file field widget.
  * @param _fileVariableName The name of the file variable associated with this field.
  */
- void WizardField::connectFileField(const QObject *object,
-                                   const char *changedSignal,
+ void WizardField::connectFileField(const WizardFileListModel *model,
                                    const QString &_fileVariableName)
 {
-    // connect field change signal for file fields
-    connect(object, changedSignal, this, SLOT(fieldChange(QVariantMap)));
+    fileModel = model;
     fileVariableName = _fileVariableName;
 }
 
@@ -103,19 +103,6 @@ bool WizardField::noFileSelected()
     value = _value;
 }
 
-/**
- * @brief Updates the field value for file fields.
- * 
- * This function is only called for file fields and updates the internal value
- * using the provided QVariantMap.
- * 
- * @param _value The QVariantMap containing file field data.
- */
-void WizardField::fieldChange(const QVariantMap &_value)
-{
-    value = _value;
-}
-
 /**
  * @brief Appends the string representation of the wizard field to the given string.
  * 
@@ -146,17 +133,17 @@ void WizardField::getWizardField(QString &wizardFieldString)
 		{
 			wizardFieldString += " " + fileVariableName + "\n";
 
-			QVariantMap* map = reinterpret_cast<QVariantMap*>(&this->value);
+			QVariantMap map = fileModel ? fileModel->fileMap() : QVariantMap();
 
 			// Calculate max length of keys (file paths)
 			int maxPathLen = 0;
-			for (auto [key, val] : map->asKeyValueRange()) {
+			for (auto [key, val] : map.asKeyValueRange()) {
 				if (key.length() > maxPathLen)
 					maxPathLen = key.length();
 			}
 
 			// Write each path padded to max length + one space, then number
-			for (auto [key, val] : map->asKeyValueRange()) {
+			for (auto [key, val] : map.asKeyValueRange()) {
 				QString paddedPath = key.leftJustified(maxPathLen, ' ');
 				wizardFieldString += paddedPath + " " + val.toString() + "\n";
 			}
@@ -186,10 +173,15 @@ void WizardField::addToMap(QVariantMap &map)
             flag = true;
         break;
     case (WizardFieldType::DimensionField):
-    case (WizardFieldType::FileField):
         if (!reinterpret_cast<QVariantMap *>(&value)->isEmpty())
             flag = true;
         break;
+    case (WizardFieldType::FileField):
+        if (fileModel && !fileModel->isEmpty()) {
+            map[name] = fileModel->fileMap();
+            return;
+        }
+        break;
     }
 
     if (flag)
@@ -215,8 +207,10 @@ bool WizardField::fieldValid()
         return fieldValid(value.toDouble());
     case (WizardFieldType::DimensionField):
         return fieldValid(*reinterpret_cast<QVariantMap *>(&value));
-    case (WizardFieldType::FileField):
-        return fieldValid(*reinterpret_cast<QVariantMap *>(&value));
+    case (WizardFieldType::FileField): {
+        QVariantMap fileMap = fileModel ? fileModel->fileMap() : QVariantMap();
+        return fieldValid(fileMap);
+    }
     }
     return resetErrorState();
 }
@@ -14,6 +14,7 @@
 	#include <QVariant>
 
 	class WizardFieldWidget;
+	class WizardFileListModel;
 
 	/**
 	 * @class WizardField
@@ -30,9 +31,8 @@
 								 const QObject *object,
 								 const char *changedSignal); ///< Constructs WizardField connecting to signal.
 
-			void connectFileField(const QObject *object,
-								  const char *changedSignal,
-								  const QString &fileVariableName); ///< Connects file field signals.
+			void connectFileField(const WizardFileListModel *model,
+								  const QString &fileVariableName); ///< Reads file field values from a shared model.
 
 			void getWizardField(QString &wizardFieldString); ///< Retrieves field value as string.
 
@@ -51,12 +51,11 @@
 		private slots:
 			void fieldChange(const QVariant &value); ///< Slot for field value changes.
 
-			void fieldChange(const QVariantMap &value); ///< Slot for QVariantMap value changes.
-
 		private:
 			QString name;                     ///< Field name identifier.
 			QString fileVariableName;         ///< File variable name for file fields.
-			QVariant value;                   ///< Current value of the field.
+			QVariant value;                   ///< Current value of the field; unused by file fields.
+			const WizardFileListModel *fileModel = nullptr; ///< Files of a file field, read when needed.
 			WizardFieldType wizardFieldType; ///< Type of the wizard field.
 			WizardFieldWidget *widget;        ///< Associated UI widget.
 
@@ -9,18 +9,29 @@
  * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
  */
 #include "WizardFileFieldWidget.h"
-#include "WizardFileFieldWidgetFile.h"
+#include "WizardFileListDelegate.h"
 
+#include <QAction>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QMessageBox>
 #include <QStandardPaths>
-#include "ui/components/text/Text.h"
+#include <QtConcurrent>
 #include "ui/components/buttons/PushButton.h"
+#include "core/dataprocessing/FileNamePattern.h"
+#include "core/graceplots/GraceFigureJob.h"
+#include "WizardFilePreview.h"
 
 /**
  * @brief Constructs a WizardFileFieldWidget.
  *
- * Initializes the file selection UI elements, including header labels,
- * scroll area for displaying selected files, and the add file button.
- * Connects relevant signals to manage file changes.
+ * Initializes the file table, whose header carries the file name, preview
+ * and file variable labels, and the add file button. Connects relevant
+ * signals to manage file changes. Whether the files are L-I-V or FTIR scans
+ * is taken from the figure set of the same name.
  *
  * @param page The wizard page to which this widget belongs.
  * @param name The name of this wizard field.
@@ -42,76 +53,89 @@ WizardFileFieldWidget::WizardFileFieldWidget(WizardPage *page,
 
     layout()->setContentsMargins(0, 0, 0, 0);
 
-    // Header area setup
-    Widget *headerArea = new Widget();
-    QHBoxLayout *headerAreaLayout = new QHBoxLayout();
-    headerArea->setLayout(headerAreaLayout);
-    layout()->addWidget(headerArea);
-
-    // File name label in header
-    Text *fileName = new Text("Filename", "h3");
-    fileName->setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
-    headerAreaLayout->addWidget(fileName);
-
-    // File variable label in header
-    Text *fileVariable = new Text(fileVariableName, "h3");
-    fileVariable->setFixedWidth(150);
-    headerAreaLayout->addWidget(fileVariable);
-
-    // Placeholder button in header (disabled)
-    PushButton *closeButtonPlaceholder = new PushButton(QIcon(""));
-    closeButtonPlaceholder->setFixedSize(30, 30);
-    closeButtonPlaceholder->setDisabled(true);
-    headerAreaLayout->addWidget(closeButtonPlaceholder);
-
-    // Horizontal line divider
-    QFrame *line = new QFrame();
-    line->setFrameShape(QFrame::HLine);
-    line->setFrameShadow(QFrame::Sunken);
-    layout()->addWidget(line);
-
-    // Scroll area for file widgets
-    QScrollArea *fileFieldScrollArea = new QScrollArea();
-    fileFieldScrollContents = new Widget();
-    fileFieldScrollLayout = new QVBoxLayout();
-
-    fileFieldScrollArea->setWidget(fileFieldScrollContents);
-    fileFieldScrollArea->setWidgetResizable(true);
-    fileFieldScrollContents->setLayout(fileFieldScrollLayout);
-    fileFieldScrollLayout->setAlignment(Qt::AlignTop);
-    fileFieldScrollLayout->setContentsMargins(0, 0, 0, 0);
-    layout()->addWidget(fileFieldScrollArea);
-
-    // Add file button
+    MeasurementFile::Kind kind = MeasurementFile::Kind::LIV;
+    for (const GraceFigureJob::FigureSet &set : GraceFigureJob::figureSets()) {
+        if (set.field == name && !set.isLIV())
+            kind = MeasurementFile::Kind::Spectrum;
+    }
+    fileModel = new WizardFileListModel(fileVariableName, kind, this);
+
+    // File table; fixed row heights keep scrolling independent of the row count
+    fileTable = new QTableView();
+    fileTable->setModel(fileModel);
+    fileTable->setItemDelegate(new WizardFileListDelegate(fileTable));
+    fileTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    fileTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    fileTable->setEditTriggers(QAbstractItemView::DoubleClicked
+                               | QAbstractItemView::SelectedClicked
+                               | QAbstractItemView::EditKeyPressed
+                               | QAbstractItemView::AnyKeyPressed);
+    fileTable->setShowGrid(false);
+    fileTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);  // keep the order files were added in
+    fileTable->setSortingEnabled(true);
+    fileTable->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    fileTable->verticalHeader()->hide();
+    fileTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    fileTable->verticalHeader()->setDefaultSectionSize(WizardFilePreview::previewHeight + 6);
+
+    QHeaderView *header = fileTable->horizontalHeader();
+    header->setSectionResizeMode(WizardFileListModel::FileColumn, QHeaderView::Stretch);
+    header->setSectionResizeMode(WizardFileListModel::PreviewColumn, QHeaderView::Fixed);
+    header->setSectionResizeMode(WizardFileListModel::ValueColumn, QHeaderView::Fixed);
+    header->setSectionResizeMode(WizardFileListModel::RemoveColumn, QHeaderView::Fixed);
+    header->resizeSection(WizardFileListModel::PreviewColumn, WizardFilePreview::previewWidth + 8);
+    header->resizeSection(WizardFileListModel::ValueColumn, 150);
+    header->resizeSection(WizardFileListModel::RemoveColumn, 30);
+    layout()->addWidget(fileTable);
+
+    // Delete removes the selected files
+    QAction *removeAction = new QAction(fileTable);
+    removeAction->setShortcuts({QKeySequence::Delete, QKeySequence(Qt::Key_Backspace)});
+    removeAction->setShortcutContext(Qt::WidgetShortcut);
+    fileTable->addAction(removeAction);
+    connect(removeAction, &QAction::triggered, this, &WizardFileFieldWidget::removeSelectedFiles);
+
+    // Add file and import folder buttons
+    Widget *buttonArea = new Widget();
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->setContentsMargins(0, 0, 0, 0);
+    buttonArea->setLayout(buttonLayout);
+    layout()->addWidget(buttonArea);
+
     PushButton *addFileButton = new PushButton("+", "contained");
-    layout()->addWidget(addFileButton);
+    buttonLayout->addWidget(addFileButton, 1);
+    PushButton *importFolderButton = new PushButton("Import folder...", "outlined");
+    buttonLayout->addWidget(importFolderButton);
+    importButton = importFolderButton;
+
+    // Default pattern: the value followed by the unit of the trace variable
+    importPattern = fileVariableName.startsWith("Current") ? "*_{I}mA*" : "*_{T}K*";
 
-    // Connect add button click signal to corresponding slot
+    // Connect button click signals to corresponding slots
     connect(addFileButton, &PushButton::clicked, this, &WizardFileFieldWidget::addButtonClicked);
-	field->connectFileField(this, SIGNAL(fileChangeSignal(QVariantMap)), fileVariableName);
+    connect(importFolderButton, &PushButton::clicked, this, &WizardFileFieldWidget::importButtonClicked);
+    connect(fileModel, &WizardFileListModel::filesAdded, this, &WizardFileFieldWidget::filesChangedSlot);
+    connect(fileModel, &WizardFileListModel::filesRemoved, this, &WizardFileFieldWidget::filesChangedSlot);
+    connect(fileModel, &WizardFileListModel::fileValueChanged, this, &WizardFileFieldWidget::filesChangedSlot);
+	field->connectFileField(fileModel, fileVariableName);
 }
 
 /**
  * @brief Clears all selected files from the widget.
  *
- * Deletes all individual file widgets currently displayed,
- * effectively resetting the widget's file selection to empty.
+ * Empties the file table, effectively resetting the widget's file
+ * selection to empty.
  */
 void WizardFileFieldWidget::clear()
 {
-    // Delete all file widgets from the scroll area
-    for (WizardFileFieldWidgetFile *individualFileWidget :
-         fileFieldScrollContents->findChildren<WizardFileFieldWidgetFile *>())
-    {
-        individualFileWidget->deleteLater();
-    }
+    fileModel->clear();
 }
 
 /**
  * @brief Handles the click event of the "Add File" button.
  *
- * Opens a file dialog allowing the user to select one or more files.
- * For each selected file, it updates the file widget list accordingly.
+ * Opens a file dialog allowing the user to select one or more files,
+ * which are added to the table in one step.
  */
 void WizardFileFieldWidget::addButtonClicked()
 {
@@ -123,87 +147,118 @@ void WizardFileFieldWidget::addButtonClicked()
                                                      nullptr,
                                                      QFileDialog::ReadOnly);
 
-    // Add each selected file to the widget
-    for (const QString &file : files)
-    {
-        updateFileWidget(file);
-    }
+    fileModel->addFiles(files);
 }
 
 /**
- * @brief Slot called when a file is selected.
- *
- * Updates the file widget to include the newly selected file.
+ * @brief Imports every file of a folder whose name matches a pattern.
  *
- * @param fileName The path of the selected file.
+ * Asks for the folder and the pattern, e.g. LIV_{T}K_*.dat, compiles the
+ * pattern once and reads each matching file's value from its name. The
+ * first lines of the matching files are checked in parallel; the files
+ * that pass are added with their values in one step and the rest are
+ * listed in a warning.
  */
-void WizardFileFieldWidget::fileSelected(const QString &fileName)
+void WizardFileFieldWidget::importButtonClicked()
 {
-    updateFileWidget(fileName);
+    QString folder = QFileDialog::getExistingDirectory(this, "Select Folder With Measurement Files", downloadPath,
+                                                       QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (folder.isEmpty())
+        return;
+
+    bool ok = false;
+    QString patternText = QInputDialog::getText(this, "Import Folder",
+                                                "File name pattern; {value} is read as " + fileVariableName
+                                                    + ", * matches any text and ? one character:",
+                                                QLineEdit::Normal, importPattern, &ok);
+    if (!ok || patternText.trimmed().isEmpty())
+        return;
+
+    FileNamePattern pattern(patternText.trimmed());
+    if (!pattern.isValid()) {
+        QMessageBox::warning(this, "Import Folder", pattern.errorString() + ":\n" + patternText);
+        return;
+    }
+    importPattern = patternText.trimmed();
+
+    QDir dir(folder);
+    QStringList files, values;
+    for (const QString &entry : dir.entryList(QDir::Files, QDir::Name)) {
+        QString value;
+        if (pattern.match(entry, &value)) {
+            files.append(dir.absoluteFilePath(entry));
+            values.append(value);
+        }
+    }
+    if (files.isEmpty()) {
+        QMessageBox::warning(this, "Import Folder", "No file in\n" + folder + "\nmatches " + importPattern);
+        return;
+    }
+
+    importButton->setEnabled(false);
+    MeasurementFile::Kind kind = fileModel->getKind();
+
+    QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, files, values]() {
+        QStringList errors = watcher->future().results();
+        watcher->deleteLater();
+        importButton->setEnabled(true);
+
+        QStringList validFiles, validValues, rejected;
+        for (int i = 0; i < files.size(); ++i) {
+            if (errors.value(i).isEmpty()) {
+                validFiles.append(files[i]);
+                validValues.append(values[i]);
+            } else {
+                rejected.append(QFileInfo(files[i]).fileName() + ": " + errors[i]);
+            }
+        }
+        fileModel->addFiles(validFiles, validValues);
+
+        if (!rejected.isEmpty()) {
+            if (rejected.size() > 10)
+                rejected = rejected.mid(0, 10) << QString("... and %1 more").arg(rejected.size() - 10);
+            QMessageBox::warning(this, "Import Folder",
+                                 QString("%1 of %2 matching files were skipped:\n\n").arg(files.size() - validFiles.size()).arg(files.size())
+                                     + rejected.join("\n"));
+        }
+    });
+
+    watcher->setFuture(QtConcurrent::mapped(files, [kind](const QString &fileName) {
+        return MeasurementFileCache::checkHeader(fileName, kind);
+    }));
 }
 
 /**
- * @brief Adds or updates a file widget for a given file.
+ * @brief Slot called when a file is selected.
  *
- * Creates a new file widget for the provided file name, adds it to the scroll layout,
- * and connects its signals to handle text changes and deletion.
+ * Adds the newly selected file to the table.
  *
- * @param fileName The path of the file to add/update in the widget list.
+ * @param fileName The path of the selected file.
  */
-void WizardFileFieldWidget::updateFileWidget(const QString &fileName)
+void WizardFileFieldWidget::fileSelected(const QString &fileName)
 {
-    // Create a new file widget and add it to the layout
-    WizardFileFieldWidgetFile *fileWidget = new WizardFileFieldWidgetFile(fileName, fileVariableName);
-    fileFieldScrollLayout->addWidget(fileWidget);
-
-    // Connect signals for text change and file deletion
-    connect(fileWidget,
-            &WizardFileFieldWidgetFile::fileTextChanged,
-            this,
-            &WizardFileFieldWidget::fileTextChangedSlot);
-
-    connect(fileWidget,
-            &WizardFileFieldWidgetFile::fileDeleted,
-            this,
-            &WizardFileFieldWidget::fileDeletedSlot);
-
-    // Initialize file widget with empty value
-    emit fileWidget->fileTextChanged(fileName, "");
+    fileModel->addFiles({fileName});
 }
 
 /**
- * @brief Slot triggered when the text associated with a file widget changes.
- *
- * Updates the internal file map with the new value and emits a signal indicating the change.
- * Also resets any error state in the widget.
+ * @brief Slot triggered when files are added, removed or edited.
  *
- * @param fileName The name/path of the file whose text changed.
- * @param fileVariableValue The new text/value associated with the file.
+ * Resets any error state in the widget. The files themselves stay in the
+ * model, where the field reads them.
  */
-void WizardFileFieldWidget::fileTextChangedSlot(const QString &fileName, const QString &fileVariableValue)
+void WizardFileFieldWidget::filesChangedSlot()
 {
-    // Update the file map with the new value
-    fileMap[fileName] = fileVariableValue;
-
-    // Emit the signal to notify about the file change
-    emit fileChangeSignal(fileMap);
-
-    // Reset the error state
     setErrorState(ErrorState::NoError);
 }
 
 /**
- * @brief Slot triggered when a file widget signals deletion.
- *
- * Removes the file from the internal map and emits a signal to notify about the deletion.
- *
- * @param fileName The name/path of the file to remove.
+ * @brief Removes the files selected in the table.
  */
-void WizardFileFieldWidget::fileDeletedSlot(const QString &fileName)
+void WizardFileFieldWidget::removeSelectedFiles()
 {
-    // Remove the file entry from the map
-    fileMap.remove(fileName);
-
-    // Emit the signal to notify about the file deletion
-    emit fileChangeSignal(fileMap);
-}
\ No newline at end of file
+    QList<int> rows;
+    for (const QModelIndex &index : fileTable->selectionModel()->selectedRows())
+        rows.append(index.row());
+    fileModel->removeFiles(rows);
+}
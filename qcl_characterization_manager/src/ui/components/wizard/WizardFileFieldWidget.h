@@ -11,15 +11,27 @@
 #ifndef WIZARDFILEFIELDWIDGET_H
 	#define WIZARDFILEFIELDWIDGET_H
 	#include <QFileDialog>
-	#include <QVBoxLayout>
+	#include <QTableView>
 	#include <QVariant>
 	#include "ui/components/containers/Widget.h"
 	#include "WizardFieldWidget.h"
+	#include "WizardFileListModel.h"
 	#include "WizardPage.h"
 
 	/**
 	 * @class WizardFileFieldWidget
 	 * @brief Widget for handling file inputs within a wizard page.
+	 *
+	 * Files are listed in a table backed by a WizardFileListModel, so only
+	 * the rows on screen are painted and an editor exists only for the value
+	 * being typed. Rows can be sorted by clicking a header and removed with
+	 * their close button or, for a selection, the Delete key. A whole sweep
+	 * can be imported from a folder, the values being read from the file
+	 * names with a FileNamePattern.
+	 *
+	 * The model is shared with the widget's WizardField, which reads the
+	 * files when the wizard needs them instead of receiving a copy of the
+	 * whole map on every edit.
 	 */
 	class WizardFileFieldWidget : public WizardFieldWidget
 	{
@@ -32,23 +44,19 @@
 
 			void clear(); ///< Clears the selected files.
 
-			QMap<QString, QVariant> fileMap;        ///< Map storing file names and related data.
 			QString fileVariableName;                ///< Variable name associated with the file input.
 			QFileDialog *fileDialog;                 ///< Dialog for selecting files.
 			QString downloadPath;                    ///< Path where files are downloaded or stored.
-			Widget *fileFieldScrollContents;        ///< Scroll area contents widget for files.
-			QVBoxLayout *fileFieldScrollLayout;     ///< Layout managing file widgets.
-
-		signals:
-			void fileChangeSignal(const QVariantMap &map); ///< Emitted when files change.
+			WizardFileListModel *fileModel;          ///< Files and their values.
+			QTableView *fileTable;                   ///< View of fileModel.
+			QString importPattern;                   ///< File name pattern of the last folder import.
+			QWidget *importButton;                   ///< Folder import button, disabled while importing.
 
 		public slots:
 			void fileSelected(const QString &fileName); ///< Slot for when a file is selected.
 			void addButtonClicked();                      ///< Slot for add button clicked.
-			void fileTextChangedSlot(const QString &fileName, const QString &fileVariableValue); ///< Slot for text change in file entry.
-			void fileDeletedSlot(const QString &fileName); ///< Slot for when a file is deleted.
-
-		private:
-			void updateFileWidget(const QString &fileName); ///< Updates UI widget for a specific file.
+			void importButtonClicked();                   ///< Slot importing a folder with a file name pattern.
+			void filesChangedSlot();                      ///< Slot for any delta of the model; clears the error state.
+			void removeSelectedFiles();                   ///< Slot removing the rows selected in the table.
 	};
 #endif // WIZARDFILEFIELDWIDGET_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * @file WizardFileListDelegate.cpp
+ * @brief Implementation of the cell painter and value editor of the wizard file table.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "WizardFileListDelegate.h"
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+#include "DoubleLineEdit.h"
+#include "WizardFileListModel.h"
+
+/**
+ * @brief Constructs the delegate.
+ *
+ * @param parent The parent object, normally the view.
+ */
+WizardFileListDelegate::WizardFileListDelegate(QObject *parent)
+    : QStyledItemDelegate{parent}
+{
+}
+
+/**
+ * @brief Paints a cell.
+ *
+ * Preview cells draw the row's WizardFilePreview; empty value cells show
+ * the same "Enter ..." prompt as the old line edits' placeholder.
+ */
+void WizardFileListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const WizardFileListModel *model = qobject_cast<const WizardFileListModel *>(index.model());
+    if (!model) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    if (index.column() == WizardFileListModel::PreviewColumn) {
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+        const QWidget *widget = option.widget;
+        QStyle *style = widget ? widget->style() : QApplication::style();
+        style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, widget);
+        model->preview(index.row()).paint(painter, option.rect);
+        return;
+    }
+
+    QStyledItemDelegate::paint(painter, option, index);
+
+    if (index.column() == WizardFileListModel::ValueColumn && index.data().toString().isEmpty()) {
+        painter->save();
+        painter->setPen(option.palette.color(QPalette::PlaceholderText));
+        painter->drawText(option.rect.adjusted(4, 0, -4, 0), Qt::AlignLeft | Qt::AlignVCenter,
+                          "Enter " + model->getFileVariableName());
+        painter->restore();
+    }
+}
+
+/**
+ * @brief Creates the value editor, committing on every keystroke.
+ */
+QWidget *WizardFileListDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const WizardFileListModel *model = qobject_cast<const WizardFileListModel *>(index.model());
+    if (!model || index.column() != WizardFileListModel::ValueColumn)
+        return QStyledItemDelegate::createEditor(parent, option, index);
+
+    DoubleLineEdit *editor = new DoubleLineEdit(model->getFileVariableName(), parent);
+    editor->setPlaceholderText("Enter " + model->getFileVariableName());
+    connect(editor, &DoubleLineEdit::_textChanged, this, [this, editor]() {
+        emit const_cast<WizardFileListDelegate *>(this)->commitData(editor);
+    });
+    return editor;
+}
+
+void WizardFileListDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    DoubleLineEdit *lineEdit = qobject_cast<DoubleLineEdit *>(editor);
+    if (!lineEdit) {
+        QStyledItemDelegate::setEditorData(editor, index);
+        return;
+    }
+
+    // Skip while typing: the commit of each keystroke comes back here
+    QString value = index.data(Qt::EditRole).toString();
+    if (lineEdit->text() != value)
+        lineEdit->setText(value);
+}
+
+void WizardFileListDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    DoubleLineEdit *lineEdit = qobject_cast<DoubleLineEdit *>(editor);
+    if (!lineEdit) {
+        QStyledItemDelegate::setModelData(editor, model, index);
+        return;
+    }
+    model->setData(index, lineEdit->text(), Qt::EditRole);
+}
+
+/**
+ * @brief Removes the row when its remove cell is clicked.
+ */
+bool WizardFileListDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                         const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    if (index.column() == WizardFileListModel::RemoveColumn && event->type() == QEvent::MouseButtonRelease) {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() == Qt::LeftButton && option.rect.contains(mouseEvent->position().toPoint())) {
+            model->removeRows(index.row(), 1);
+            return true;
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
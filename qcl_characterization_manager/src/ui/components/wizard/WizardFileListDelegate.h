@@ -0,0 +1,36 @@
+/**
+ * @file WizardFileListDelegate.h
+ * @brief Declaration of WizardFileListDelegate, the cell painter and editor of the wizard file table.
+ *
+ * @author Aleksandar Demic
+ */
+
+#ifndef WIZARDFILELISTDELEGATE_H
+	#define WIZARDFILELISTDELEGATE_H
+	#include <QStyledItemDelegate>
+
+	/**
+	 * @class WizardFileListDelegate
+	 * @brief Paints previews and edits values of a WizardFileListModel.
+	 *
+	 * The value editor is a DoubleLineEdit that only exists while a cell is
+	 * being edited; every keystroke is committed, as the per-file line edits
+	 * it replaces did. Clicking the remove cell removes its row.
+	 */
+	class WizardFileListDelegate : public QStyledItemDelegate
+	{
+			Q_OBJECT
+
+		public:
+			explicit WizardFileListDelegate(QObject *parent = nullptr); ///< Constructor
+
+			void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+			QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+			void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+			void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+
+		protected:
+			bool editorEvent(QEvent *event, QAbstractItemModel *model,
+							 const QStyleOptionViewItem &option, const QModelIndex &index) override;
+	};
+#endif // WIZARDFILELISTDELEGATE_H
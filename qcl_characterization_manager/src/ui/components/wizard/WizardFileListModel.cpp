@@ -0,0 +1,376 @@
+/**
+ * @file WizardFileListModel.cpp
+ * @brief Implementation of the file table model of a wizard file field.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "WizardFileListModel.h"
+#include <QBrush>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QIcon>
+#include <QSet>
+#include <QSize>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+/**
+ * @brief Constructs an empty file list.
+ *
+ * @param fileVariableName Trace variable of the files, shown as the value header.
+ * @param kind Column layout of the files, used to parse them.
+ * @param parent The parent object.
+ */
+WizardFileListModel::WizardFileListModel(const QString &fileVariableName,
+                                         MeasurementFile::Kind kind,
+                                         QObject *parent)
+    : QAbstractTableModel{parent}
+    , fileVariableName(fileVariableName)
+    , kind(kind)
+{
+    parsePool.setMaxThreadCount(2);
+}
+
+int WizardFileListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(rows.size());
+}
+
+int WizardFileListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/**
+ * @brief Returns the data of a cell.
+ *
+ * The preview cell has no display text; the delegate paints it from
+ * preview(). Parse errors colour the file name and show in its tooltip.
+ */
+QVariant WizardFileListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+
+    const Row &row = rows[index.row()];
+    const WizardFilePreview &preview = row.preview;
+    QString parseState = preview.parsing ? "Parsing..." : preview.error.isEmpty() ? preview.summary : preview.error;
+
+    switch (index.column()) {
+        case FileColumn:
+            if (role == Qt::DisplayRole)
+                return QFileInfo(row.fileName).fileName();
+            if (role == Qt::ToolTipRole)
+                return QDir::toNativeSeparators(row.fileName) + "\n" + parseState;
+            if (role == Qt::ForegroundRole && !preview.error.isEmpty())
+                return QBrush(Qt::red);
+            break;
+
+        case PreviewColumn:
+            if (role == Qt::ToolTipRole)
+                return parseState;
+            if (role == Qt::SizeHintRole)
+                return QSize(WizardFilePreview::previewWidth + 8, WizardFilePreview::previewHeight + 6);
+            break;
+
+        case ValueColumn:
+            if (role == Qt::DisplayRole || role == Qt::EditRole)
+                return row.value;
+            break;
+
+        case RemoveColumn:
+            if (role == Qt::DecorationRole) {
+                static const QIcon closeIcon(":/src/resources/images/close-button.svg");
+                return closeIcon;
+            }
+            if (role == Qt::ToolTipRole)
+                return "Remove file";
+            break;
+    }
+    return QVariant();
+}
+
+QVariant WizardFileListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section) {
+        case FileColumn:    return "Filename";
+        case PreviewColumn: return "Preview";
+        case ValueColumn:   return fileVariableName;
+        default:            return QVariant();
+    }
+}
+
+Qt::ItemFlags WizardFileListModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() == ValueColumn)
+        itemFlags |= Qt::ItemIsEditable;
+    return itemFlags;
+}
+
+/**
+ * @brief Stores the trace variable value typed for a file.
+ */
+bool WizardFileListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || index.column() != ValueColumn || role != Qt::EditRole)
+        return false;
+
+    QString text = value.toString();
+    if (rows[index.row()].value == text)
+        return true;
+
+    rows[index.row()].value = text;
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    emit fileValueChanged(rows[index.row()].fileName, text);
+    return true;
+}
+
+/**
+ * @brief Appends files and starts parsing them.
+ *
+ * Files already in the list, or repeated in fileNames, are added once.
+ *
+ * @param fileNames Full paths of the files.
+ * @param values Trace variable value of each file, e.g. read from its name;
+ *               files without one start empty.
+ */
+void WizardFileListModel::addFiles(const QStringList &fileNames, const QStringList &values)
+{
+    QVector<Row> added;
+    added.reserve(fileNames.size());
+    QStringList addedNames;
+    QSet<QString> seen;
+    for (int i = 0; i < fileNames.size(); ++i) {
+        const QString &fileName = fileNames[i];
+        if (rowOf.contains(fileName) || seen.contains(fileName))
+            continue;
+        seen.insert(fileName);
+        added.append(Row{fileName, values.value(i), WizardFilePreview()});
+        addedNames.append(fileName);
+    }
+    if (added.isEmpty())
+        return;
+
+    int first = int(rows.size());
+    beginInsertRows(QModelIndex(), first, first + int(added.size()) - 1);
+    rows.append(added);
+    for (int row = first; row < rows.size(); ++row)
+        rowOf.insert(rows[row].fileName, row);
+    endInsertRows();
+
+    for (const QString &fileName : addedNames)
+        startParse(fileName);
+    emit filesAdded(addedNames);
+}
+
+/**
+ * @brief Removes a contiguous block of rows.
+ */
+bool WizardFileListModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > rows.size())
+        return false;
+
+    QStringList removedNames;
+    removedNames.reserve(count);
+    for (int i = row; i < row + count; ++i)
+        removedNames.append(rows[i].fileName);
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    rows.remove(row, count);
+    reindex();
+    endRemoveRows();
+
+    emit filesRemoved(removedNames);
+    return true;
+}
+
+/**
+ * @brief Removes any set of rows, e.g. a view selection.
+ *
+ * A contiguous block is removed with removeRows(); a scattered set is
+ * compacted in one pass and reported as a model reset, which is cheaper
+ * than one removal per block.
+ *
+ * @param rowsToRemove Rows to remove, in any order, duplicates allowed.
+ */
+void WizardFileListModel::removeFiles(const QList<int> &rowsToRemove)
+{
+    QVector<bool> remove(rows.size(), false);
+    int count = 0, first = int(rows.size()), last = -1;
+    for (int row : rowsToRemove) {
+        if (row < 0 || row >= rows.size() || remove[row])
+            continue;
+        remove[row] = true;
+        ++count;
+        first = qMin(first, row);
+        last = qMax(last, row);
+    }
+    if (count == 0)
+        return;
+
+    if (last - first + 1 == count) {
+        removeRows(first, count);
+        return;
+    }
+
+    QStringList removedNames;
+    removedNames.reserve(count);
+
+    beginResetModel();
+    int kept = 0;
+    for (int row = 0; row < rows.size(); ++row) {
+        if (remove[row])
+            removedNames.append(rows[row].fileName);
+        else
+            rows[kept++] = std::move(rows[row]);
+    }
+    rows.resize(kept);
+    reindex();
+    endResetModel();
+
+    emit filesRemoved(removedNames);
+}
+
+/**
+ * @brief Removes every file.
+ */
+void WizardFileListModel::clear()
+{
+    if (rows.isEmpty())
+        return;
+
+    QStringList removedNames;
+    removedNames.reserve(rows.size());
+    for (const Row &row : rows)
+        removedNames.append(row.fileName);
+
+    beginResetModel();
+    rows.clear();
+    rowOf.clear();
+    endResetModel();
+
+    emit filesRemoved(removedNames);
+}
+
+/**
+ * @brief Sorts by file name or numerically by value.
+ *
+ * Rows without a value go last in either order. Persistent indexes, such
+ * as the view selection and an open editor, follow their rows.
+ */
+void WizardFileListModel::sort(int column, Qt::SortOrder order)
+{
+    if (column != FileColumn && column != ValueColumn)
+        return;
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    QVector<int> permutation(rows.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+
+    bool ascending = order == Qt::AscendingOrder;
+    if (column == FileColumn) {
+        QStringList names;
+        names.reserve(rows.size());
+        for (const Row &row : rows)
+            names.append(QFileInfo(row.fileName).fileName());
+        std::stable_sort(permutation.begin(), permutation.end(), [&](int a, int b) {
+            int result = names[a].compare(names[b], Qt::CaseInsensitive);
+            return ascending ? result < 0 : result > 0;
+        });
+    } else {
+        QVector<double> values(rows.size());
+        for (int row = 0; row < rows.size(); ++row) {
+            bool ok = false;
+            double value = rows[row].value.toDouble(&ok);
+            values[row] = ok ? value : std::numeric_limits<double>::quiet_NaN();
+        }
+        std::stable_sort(permutation.begin(), permutation.end(), [&](int a, int b) {
+            if (std::isnan(values[a]) || std::isnan(values[b]))
+                return !std::isnan(values[a]) && std::isnan(values[b]);
+            return ascending ? values[a] < values[b] : values[a] > values[b];
+        });
+    }
+
+    QVector<Row> sorted;
+    sorted.reserve(rows.size());
+    QVector<int> newRow(rows.size());
+    for (int row = 0; row < permutation.size(); ++row) {
+        newRow[permutation[row]] = row;
+        sorted.append(std::move(rows[permutation[row]]));
+    }
+    rows = std::move(sorted);
+    reindex();
+
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &index : from)
+        to.append(index.isValid() ? this->index(newRow[index.row()], index.column()) : QModelIndex());
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+/**
+ * @brief Returns the listed files and their values, as the wizard's data map holds them.
+ *
+ * Built on each call; meant for collecting or validating the field, not
+ * for every edit.
+ */
+QVariantMap WizardFileListModel::fileMap() const
+{
+    QVariantMap map;
+    for (const Row &row : rows)
+        map.insert(row.fileName, row.value);
+    return map;
+}
+
+/**
+ * @brief Parses a file on the pool and fills in its row's preview.
+ *
+ * The row is looked up by path when the parse finishes, so sorting or
+ * removing rows in the meantime is safe; a removed file's result is dropped.
+ *
+ * @param fileName Full path of the file.
+ */
+void WizardFileListModel::startParse(const QString &fileName)
+{
+    QFutureWatcher<WizardFilePreview> *watcher = new QFutureWatcher<WizardFilePreview>(this);
+    connect(watcher, &QFutureWatcher<WizardFilePreview>::finished, this, [this, watcher, fileName]() {
+        WizardFilePreview preview = watcher->result();
+        watcher->deleteLater();
+
+        auto it = rowOf.constFind(fileName);
+        if (it == rowOf.constEnd())
+            return;
+        rows[*it].preview = preview;
+        emit dataChanged(index(*it, FileColumn), index(*it, PreviewColumn));
+    });
+
+    MeasurementFile::Kind fileKind = kind;
+    watcher->setFuture(QtConcurrent::run(&parsePool, [fileName, fileKind]() {
+        return WizardFilePreview::build(fileName, fileKind);
+    }));
+}
+
+/**
+ * @brief Rebuilds the path -> row index.
+ */
+void WizardFileListModel::reindex()
+{
+    rowOf.clear();
+    rowOf.reserve(rows.size());
+    for (int row = 0; row < rows.size(); ++row)
+        rowOf.insert(rows[row].fileName, row);
+}
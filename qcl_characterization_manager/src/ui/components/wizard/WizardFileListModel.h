@@ -0,0 +1,90 @@
+/**
+ * @file WizardFileListModel.h
+ * @brief Declaration of WizardFileListModel, the table of files behind a WizardFileFieldWidget.
+ *
+ * One row per measurement file: its name, a live preview and the value of
+ * the trace variable. Only the rows on screen are painted, so a dataset of
+ * hundreds of fine-step traces costs one view and one model.
+ *
+ * @author Aleksandar Demic
+ */
+
+#ifndef WIZARDFILELISTMODEL_H
+	#define WIZARDFILELISTMODEL_H
+	#include <QAbstractTableModel>
+	#include <QHash>
+	#include <QThreadPool>
+	#include <QVariantMap>
+	#include <QVector>
+	#include "core/dataprocessing/MeasurementFileCache.h"
+	#include "WizardFilePreview.h"
+
+	/**
+	 * @class WizardFileListModel
+	 * @brief Files of one wizard file field with their trace variable values.
+	 *
+	 * Files are parsed on a small worker pool as soon as they are added;
+	 * each finished parse updates the preview cell of its row. Adding,
+	 * removing and sorting each emit one model signal for the whole batch,
+	 * and apart from the sort itself run in time linear in the row count.
+	 *
+	 * The model is the single copy of the field's files: the view edits it
+	 * and WizardField reads it when the wizard collects or validates its
+	 * fields. Changes are announced as deltas, so an edited value costs
+	 * O(1) however many files are listed.
+	 */
+	class WizardFileListModel : public QAbstractTableModel
+	{
+			Q_OBJECT
+
+		public:
+			enum Column { FileColumn, PreviewColumn, ValueColumn, RemoveColumn, ColumnCount }; ///< Table columns
+
+			explicit WizardFileListModel(const QString &fileVariableName,
+										 MeasurementFile::Kind kind,
+										 QObject *parent = nullptr); ///< Constructor
+
+			int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+			int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+			QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+			QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+			Qt::ItemFlags flags(const QModelIndex &index) const override;
+			bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+			bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+			void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+			void addFiles(const QStringList &fileNames,
+						  const QStringList &values = QStringList()); ///< Append files not already listed, in one insertion
+			void removeFiles(const QList<int> &rows);    ///< Remove any set of rows in one pass
+			void clear();                                ///< Remove every file
+
+			const WizardFilePreview &preview(int row) const { return rows[row].preview; } ///< Preview of a row
+			QVariantMap fileMap() const;                  ///< File path -> value text, built on each call
+			bool isEmpty() const { return rows.isEmpty(); } ///< No files listed
+			const QString &getFileVariableName() const { return fileVariableName; } ///< Trace variable, e.g. "Temperature (K)"
+			MeasurementFile::Kind getKind() const { return kind; } ///< Column layout of the files
+
+		signals:
+			void filesAdded(const QStringList &fileNames);   ///< Files appended to the list
+			void filesRemoved(const QStringList &fileNames); ///< Files taken off the list
+			void fileValueChanged(const QString &fileName, const QString &value); ///< Value of one file edited
+
+		private:
+			/// One listed file.
+			struct Row
+			{
+				QString fileName;          ///< Full path
+				QString value;             ///< Trace variable value as typed
+				WizardFilePreview preview; ///< Parse result, parsing until the worker finishes
+			};
+
+			void startParse(const QString &fileName); ///< Parse on the pool; the row's preview follows
+			void reindex();                           ///< Rebuild rowOf after rows moved
+
+			QString fileVariableName;    ///< Header of the value column
+			MeasurementFile::Kind kind;  ///< Column layout of the files
+			QVector<Row> rows;           ///< Listed files, in view order
+			QHash<QString, int> rowOf;   ///< File path -> row
+			QThreadPool parsePool;       ///< Workers parsing added files
+	};
+#endif // WIZARDFILELISTMODEL_H
@@ -0,0 +1,108 @@
+/**
+ * @file WizardFilePreview.cpp
+ * @brief Implementation of the live preview plot of a wizard file entry.
+ *
+ * @author Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include "WizardFilePreview.h"
+#include <QPainterPath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Parses a file and reduces its main trace to pixel columns.
+ *
+ * Meant for a worker thread. Points are binned by x, so files stored in
+ * descending order plot the same as ascending ones.
+ *
+ * @param fileName The measurement file.
+ * @param kind     Column layout of the file.
+ * @return The reduced trace, or the parse error.
+ */
+WizardFilePreview WizardFilePreview::build(const QString &fileName, MeasurementFile::Kind kind)
+{
+    WizardFilePreview result;
+    result.parsing = false;
+
+    MeasurementFile file = MeasurementFileCache::read(fileName, kind);
+    if (!file.isValid()) {
+        result.error = file.error;
+        return result;
+    }
+
+    result.summary = QString("%1 points").arg(file.x.size());
+    if (file.skippedLines > 0)
+        result.summary += QString(", %1 lines skipped").arg(file.skippedLines);
+
+    const QVector<double> &y = kind == MeasurementFile::Kind::LIV ? file.y2 : file.y1;
+    auto [minX, maxX] = std::minmax_element(file.x.constBegin(), file.x.constEnd());
+    auto [minY, maxY] = std::minmax_element(y.constBegin(), y.constEnd());
+    double spanX = *maxX - *minX;
+    double spanY = *maxY - *minY;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    result.columns.fill(qMakePair(nan, nan), previewWidth);
+    for (int i = 0; i < file.x.size(); ++i) {
+        int column = spanX > 0 ? int((file.x[i] - *minX) / spanX * (previewWidth - 1)) : 0;
+        column = qBound(0, column, previewWidth - 1);
+        double value = spanY > 0 ? (y[i] - *minY) / spanY : 0.5;
+        QPair<double, double> &bin = result.columns[column];
+        if (std::isnan(bin.first)) {
+            bin = qMakePair(value, value);
+        } else {
+            bin.first = qMin(bin.first, value);
+            bin.second = qMax(bin.second, value);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Draws the trace, or a short note while parsing or after a failure.
+ *
+ * @param painter Painter of the view.
+ * @param rect    Area to draw in; the plot is centred in it.
+ */
+void WizardFilePreview::paint(QPainter *painter, const QRect &rect) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QRect plot(0, 0, qMin(previewWidth, rect.width()), qMin(previewHeight, rect.height()));
+    plot.moveCenter(rect.center());
+
+    if (parsing || !error.isEmpty()) {
+        painter->setPen(parsing ? QColor("#888888") : QColor(Qt::red));
+        QString text = parsing ? "Parsing..." : error;
+        painter->drawText(plot, Qt::AlignCenter, painter->fontMetrics().elidedText(text, Qt::ElideRight, plot.width()));
+        painter->restore();
+        return;
+    }
+
+    // Columns are in [0, 1]; leave a pixel for the pen at the top and bottom
+    double top = plot.top() + 1.5, span = plot.height() - 3.0;
+    QPainterPath path;
+    bool started = false;
+    for (int column = 0; column < columns.size() && column < plot.width(); ++column) {
+        const QPair<double, double> &bin = columns[column];
+        if (std::isnan(bin.first))
+            continue;
+        double x = plot.left() + column + 0.5;
+        double yMin = top + (1.0 - bin.first) * span;
+        double yMax = top + (1.0 - bin.second) * span;
+        if (!started) {
+            path.moveTo(x, yMin);
+            started = true;
+        } else {
+            path.lineTo(x, yMin);
+        }
+        if (yMax != yMin)
+            path.lineTo(x, yMax);
+    }
+
+    painter->setPen(QPen(QColor("#007AFF"), 1.2));
+    painter->drawPath(path);
+    painter->restore();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file WizardFilePreview.h
+ * @brief Declaration of WizardFilePreview, a small live plot of a measurement file.
+ *
+ * Shown next to each file entry of a WizardFileFieldWidget so a wrong or
+ * corrupt file is visible as soon as it is added.
+ *
+ * @author Aleksandar Demic
+ */
+
+#ifndef WIZARDFILEPREVIEW_H
+	#define WIZARDFILEPREVIEW_H
+	#include <QPair>
+	#include <QPainter>
+	#include <QRect>
+	#include <QVector>
+	#include "core/dataprocessing/MeasurementFileCache.h"
+
+	/**
+	 * @class WizardFilePreview
+	 * @brief Main trace of a parsed file, reduced to pixel columns.
+	 *
+	 * build() parses the file through MeasurementFileCache, so the
+	 * processors later reuse the result instead of reading the file again,
+	 * and keeps the minimum and maximum of each pixel column, so painting
+	 * costs the same for any file length. L-I-V files show optical power
+	 * against current, FTIR files intensity against frequency.
+	 *
+	 * A default-constructed preview is still parsing.
+	 */
+	class WizardFilePreview
+	{
+		public:
+			static const int previewWidth = 120; ///< Width of the plot [px]
+			static const int previewHeight = 30; ///< Height of the plot [px]
+
+			static WizardFilePreview build(const QString &fileName, MeasurementFile::Kind kind); ///< Parse and reduce; safe on any thread
+
+			void paint(QPainter *painter, const QRect &rect) const; ///< Draw the trace or the parse state
+
+			bool parsing = true;                    ///< Parse not finished yet
+			QString error;                          ///< Parse error, empty on success
+			QString summary;                        ///< Point count and skipped lines
+			QVector<QPair<double, double>> columns; ///< Min and max of each column in [0, 1], NaN if empty
+	};
+#endif // WIZARDFILEPREVIEW_H
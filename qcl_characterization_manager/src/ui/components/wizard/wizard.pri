@@ -5,7 +5,9 @@ SOURCES += \
     $$PWD/WizardField.cpp \
 	$$PWD/WizardFieldWidget.cpp \
     $$PWD/WizardFileFieldWidget.cpp \
-    $$PWD/WizardFileFieldWidgetFile.cpp \
+    $$PWD/WizardFileListDelegate.cpp \
+    $$PWD/WizardFileListModel.cpp \
+    $$PWD/WizardFilePreview.cpp \
     $$PWD/WizardFilePage.cpp \
     $$PWD/WizardPage.cpp \
     $$PWD/WizardRadioFieldWidget.cpp \
@@ -18,7 +20,9 @@ HEADERS += \
     $$PWD/WizardField.h \
 	$$PWD/WizardFieldWidget.h \
     $$PWD/WizardFileFieldWidget.h \
-    $$PWD/WizardFileFieldWidgetFile.h \
+    $$PWD/WizardFileListDelegate.h \
+    $$PWD/WizardFileListModel.h \
+    $$PWD/WizardFilePreview.h \
     $$PWD/WizardFilePage.h \
     $$PWD/WizardPage.h \
     $$PWD/WizardRadioFieldWidget.h \
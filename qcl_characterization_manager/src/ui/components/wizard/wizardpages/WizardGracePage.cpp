@@ -13,17 +13,22 @@
 
 #include "WizardGracePage.h"
 #include <QStandardPaths>
+#include <QFileInfo>
 #include "ui/components/containers/HeaderPage.h"
 #include "ui/components/text/Text.h"
 #include "ui/dialogs/MessageBox.h"
-#include "core/graceplots/LIVGracePlot.h"
-#include "core/graceplots/SpectraGracePlot.h"
-#include "core/graceplots/IthGracePlot.h"
+#include "core/graceplots/GraceFigureWriter.h"
 #include "core/dataprocessing/LIVDataProcessor.h"
 #include "core/dataprocessing/SpectraDataProcessor.h"
 #include "core/dataprocessing/IthDataProcessor.h"
 #include "core/fileconversion/FileConverter.h"
+#include "core/qtplots/QtPlotExporter.h"
+#include "core/qtplots/QtLIVPlot.h"
+#include "core/qtplots/QtSpectraPlot.h"
 #include "core/datasheetgenerator/DataSheetGenerator.h"
+#include "core/datasheetgenerator/LatexBuilder.h"
+#include "core/datasheetgenerator/NativeDataSheetGenerator.h"
+#include "core/project/AnalyticsExporter.h"
 
 
 /**
@@ -54,6 +59,8 @@ WizardGracePage::WizardGracePage(const QString &title, QWidget *parent)
     , imageCarousel(new ImageCarousel())
     , imageMenu(new ButtonGroup(ButtonGroup::VLayout))
     , generateDataSheetButton(nullptr)
+    , plotBackendSelector(nullptr)
+    , dataSheetBackendSelector(nullptr)
 {
     QHBoxLayout *hBoxLayout = new QHBoxLayout(this);
     QVBoxLayout *vBoxLayout = new QVBoxLayout();
@@ -101,7 +108,7 @@ WizardGracePage::WizardGracePage(const QString &title, QWidget *parent)
  * @brief Initializes the "Nothing to Show" widget.
  * 
  * This widget displays a centered message indicating that there is no content to show,
- * along with a button to trigger the generation of Grace images.
+ * a selector for the figure backend and a button to trigger the generation of Grace images.
  * 
  * The button is connected to the generateGraceImages() slot.
  */
@@ -117,6 +124,12 @@ void WizardGracePage::initNothingToShowWidget()
     text->setAlignment(Qt::AlignCenter);
     layout->addWidget(text);
 
+    // Grace + Ghostscript gives the publication figures; QCustomPlot needs no external tools
+    plotBackendSelector = new QComboBox();
+    plotBackendSelector->addItem("Grace + Ghostscript (publication quality)", QVariant::fromValue(int(GraceBackend)));
+    plotBackendSelector->addItem("QCustomPlot (fast, no external tools)", QVariant::fromValue(int(QtPlotBackend)));
+    layout->addWidget(plotBackendSelector);
+
     PushButton *generateGraceImagesButton = new PushButton("Generate Grace Images", "contained");
     layout->addWidget(generateGraceImagesButton);
     connect(generateGraceImagesButton, &QPushButton::clicked, this, &WizardGracePage::generateGraceImages);
@@ -125,7 +138,8 @@ void WizardGracePage::initNothingToShowWidget()
 /**
  * @brief Initializes the widget containing controls for image generation.
  * 
- * Currently includes a "Generate Data Sheet" button which is disabled by default.
+ * Includes the datasheet backend selector and a "Generate Data Sheet" button
+ * which is disabled by default.
  * 
  * The button is connected to the generateDataSheet() slot.
  */
@@ -135,6 +149,12 @@ void WizardGracePage::initGenerateImagesControlWidget()
     generateImagesControlWidget->setLayout(layout);
     generateImagesControlWidget->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Minimum);
 
+    // LaTeX gives vector figures; the native backend needs no TeX installation
+    dataSheetBackendSelector = new QComboBox();
+    dataSheetBackendSelector->addItem("LaTeX (publication quality)", QVariant::fromValue(int(LatexDataSheet)));
+    dataSheetBackendSelector->addItem("Native PDF (fast, no TeX)", QVariant::fromValue(int(NativeDataSheet)));
+    layout->addWidget(dataSheetBackendSelector);
+
     // Initialize the "Generate Data Sheet" button and disable it initially
     generateDataSheetButton = new PushButton("Generate Data Sheet", "contained");
     generateDataSheetButton->setEnabled(false);  // Initially disabled
@@ -149,13 +169,17 @@ void WizardGracePage::initGenerateImagesControlWidget()
  * @param imagePath The filesystem path of the image to add.
  * 
  * Adds a button to the image menu linked to the image carousel,
- * and adds the image itself to the carousel display.
- * Updates both widgets after adding.
+ * and adds the image itself to the carousel display. If an interactive
+ * plot of the same figure was built, the carousel shows it instead of
+ * the image. Updates both widgets after adding.
  */
 void WizardGracePage::addImage(const QString &imagePath)
 {
     imageMenu->addImageButton(imageCarousel, SIGNAL(currentChanged(int)), imagePath);
-    imageCarousel->addImage(imagePath);
+    if (QCustomPlot *plot = interactivePlots.take(QFileInfo(imagePath).completeBaseName()))
+        imageCarousel->addImage(plot);
+    else
+        imageCarousel->addImage(imagePath);
 	imageMenu->update();
     imageCarousel->update();
 }
@@ -182,6 +206,8 @@ void WizardGracePage::resetView()
     // Disable and reset the "Generate Data Sheet" button
     generateDataSheetButton->setEnabled(false);
     generateDataSheetButton->setStyleSheet("");  // reset style to default
+
+    discardInteractivePlots();
 }
 
 /**
@@ -195,18 +221,128 @@ void WizardGracePage::resetView()
 void WizardGracePage::loadGeneratedImagesFromFigures()
 {
     QString figuresDirPath = outputDir + "/Figures";
-    QDir figuresDir(figuresDirPath);
-
-    if (!figuresDir.exists()) {
+    if (!QDir(figuresDirPath).exists()) {
         qWarning() << "Figures directory not found:" << figuresDirPath;
         return;
     }
 
-	QStringList pngFiles = figuresDir.entryList(QStringList() << "*.png", QDir::Files);
-	for (const QString &pngFile : pngFiles) {
-		QString fullPath = figuresDir.absoluteFilePath(pngFile);
+	for (const QString &fullPath : previewImages())
 		addImage(fullPath);
-	}
+}
+
+/**
+ * @brief Lists the PNG figures of the output directory.
+ * 
+ * @return The preview tier if it has any PNGs, otherwise the full-size PNGs in "Figures".
+ */
+QStringList WizardGracePage::previewImages() const
+{
+    QString figuresDirPath = outputDir + "/Figures";
+    QDir figuresDir(figuresDirPath);
+
+    // Prefer the low-DPI preview tier; folders converted before tiers existed only have full-size PNGs
+    QDir previewDir(FileConverter::tierDirectory(figuresDirPath, FileConverter::PreviewTier));
+    if (!previewDir.entryList(QStringList() << "*.png", QDir::Files).isEmpty())
+        figuresDir = previewDir;
+
+    QStringList images;
+    for (const QString &pngFile : figuresDir.entryList(QStringList() << "*.png", QDir::Files))
+        images.append(figuresDir.absoluteFilePath(pngFile));
+    return images;
+}
+
+/**
+ * @brief Saves the device as a project once its figures are written.
+ * 
+ * @param writer Writer holding the parameters, traces and results of the run.
+ * 
+ * The project references the PDF and preview figures of the output directory.
+ * Nothing keeps it open afterwards, so the next run can replace it.
+ */
+void WizardGracePage::saveProject(ProjectWriter &writer)
+{
+    QStringList pdfFiles;
+    QDir figuresDir(outputDir + "/Figures");
+    for (const QString &pdfFile : figuresDir.entryList(QStringList() << "*.pdf", QDir::Files))
+        pdfFiles.append(figuresDir.absoluteFilePath(pdfFile));
+
+    writer.setParameters(collectedData);
+    writer.setFigures(pdfFiles, previewImages());
+    writer.write();
+}
+
+/**
+ * @brief Deletes the interactive plots no carousel page took.
+ * 
+ * Plots shown in the carousel belong to its stack and are deleted by
+ * ImageCarousel::clear(); only those whose figure was never listed
+ * (e.g. a failed preview export) are left here.
+ */
+void WizardGracePage::discardInteractivePlots()
+{
+    qDeleteAll(interactivePlots);
+    interactivePlots.clear();
+}
+
+/**
+ * @brief Shows a saved project without reading the raw measurement files.
+ * 
+ * @param openedProject A project whose open() succeeded.
+ * 
+ * The traces of every measurement set are taken from the project columns and
+ * analysed again, which fills in any fit result or emission range the saved
+ * parameters lack, so the data sheet can be generated right away. With the
+ * QCustomPlot backend the same traces also give the interactive L-I-V and
+ * spectra views. The carousel shows the figures the project refers to; the
+ * project is not kept open.
+ */
+void WizardGracePage::openProject(const ProjectFile &openedProject)
+{
+    imageCarousel->clear();
+    imageMenu->clear();
+    discardInteractivePlots();
+
+    nothingToShowWidget->hide();
+
+    bool useQtPlots = plotBackendSelector->currentData().toInt() == QtPlotBackend;
+    QVariantMap dimensions = collectedData.value("Dimensions").toMap();
+    double w = dimensions.value("width").toDouble();
+    double l = dimensions.value("length").toDouble();
+
+    bool resultsAdded = false;
+    for (const GraceFigureJob::FigureSet &set : GraceFigureJob::figureSets()) {
+        GraceFigureJob job(set, collectedData, outputDir + "/GraceFigures");
+        if (!job.restore(openedProject))
+            continue;
+
+        job.analyse();
+        for (auto it = job.results().constBegin(); it != job.results().constEnd(); ++it) {
+            if (!collectedData.contains(it.key())) {
+                collectedData.insert(it.key(), it.value());
+                resultsAdded = true;
+            }
+        }
+
+        // The plots copy the traces, so they outlive the job
+        if (useQtPlots && job.livData())
+            interactivePlots.insert(set.baseName, new QtLIVPlot(job.livData(), outputDir, w, l));
+        else if (useQtPlots && job.spectraData())
+            interactivePlots.insert(set.baseName, new QtSpectraPlotSamePlot(job.spectraData()));
+    }
+
+    if (resultsAdded)
+        emit dataProcessed(collectedData);
+
+    QStringList images = openedProject.previews();
+    for (const QString &image : images) {
+        if (QFile::exists(image))
+            addImage(image);
+        else
+            qWarning() << "Project figure not found:" << image;
+    }
+
+    generateDataSheetButton->setEnabled(true);
+    generateDataSheetButton->setStyleSheet("background-color: #007AFF;");
 }
 
 /**
@@ -239,6 +375,9 @@ void WizardGracePage::setFields(const QVariantMap &map, const QString &dir)
  * It filters data keys to separate pulsed and continuous-wave (CW) metadata and looks
  * for relevant figure files (.pdf) in the "Figures" subdirectory.
  * 
+ * When the native backend is selected, the PDF is written directly by
+ * NativeDataSheetGenerator from the print-tier PNG figures and no .tex file is produced.
+ * 
  * If data is missing or pdflatex executable is not found, the process is aborted with warnings.
  * 
  * On successful PDF generation, the user is notified and the "Generate Data Sheet" button
@@ -267,32 +406,19 @@ void WizardGracePage::generateDataSheet()
     // Construct metadata maps
     QMap<QString, QString> pulsedMetadata;
     QMap<QString, QString> cwMetadata;
+    DataSheetGenerator::splitMeasurementMetadata(collectedData, pulsedMetadata, cwMetadata);
 
-    for (auto it = collectedData.begin(); it != collectedData.end(); ++it) 
-    {
-        QString key = it.key();
-        QString value = it.value().toString();
-
-        // Pulsed LIV keys
-        if (key.contains("pulsed_") && key.endsWith("_liv")) {
-            pulsedMetadata[key] = value;
-        } 
-        // Pulsed Spectra keys
-        else if (key.contains("pulsed_") && key.endsWith("_spectra")) {
-            pulsedMetadata[key] = value;
-        }
-        // Pulsed experimental notes
-        else if (key.startsWith("pulsed_") && key.endsWith("_experimental_notes")) {
-            pulsedMetadata[key] = value;
-        }
-        // CW experimental notes
-        else if (key.startsWith("cw_") && key.endsWith("_experimental_notes")) {
-            cwMetadata[key] = value;
-        }
-        // CW LIV and spectra keys (optional, depending on use case)
-        else if (key.contains("cw_") && (key.endsWith("_liv") || key.endsWith("_spectra"))) {
-            cwMetadata[key] = value;
+    if (dataSheetBackendSelector->currentData().toInt() == NativeDataSheet) {
+        QString outputPdfPath = outputDir + "/LaserDataSheet.pdf";
+        NativeDataSheetGenerator nativeGenerator(outputPdfPath, collectedData);
+        nativeGenerator.setMeasurementMetadata(pulsedMetadata, cwMetadata);
+
+        if (nativeGenerator.generate()) {
+            QMessageBox::information(this, "Success", "PDF generated successfully:\n" + outputPdfPath);
+        } else {
+            QMessageBox::warning(this, "Failure", "PDF generation failed:\n" + nativeGenerator.errorString());
         }
+        return;
     }
 
     // Collect figures from the figures directory
@@ -330,57 +456,38 @@ void WizardGracePage::generateDataSheet()
 
     qDebug() << "Laser Data Sheet LaTeX written to:" << outputTexPath;
 
-    // Progress dialog for PDF compilation
-    QProgressDialog* progressDialog = new QProgressDialog("Compiling PDF...", QString(), 0, 0, this);
-    progressDialog->setWindowModality(Qt::WindowModal);
-    progressDialog->setCancelButton(nullptr);
-    progressDialog->setMinimumDuration(0);
-    progressDialog->show();
-
     // Path to pdflatex executable
-    QString pdflatexPath = QCoreApplication::applicationDirPath() + "/miktex-portable/texmfs/install/miktex/bin/x64/pdflatex.exe";
+    QString pdflatexPath = LatexBuilder::defaultPdflatexPath();
     if (!QFile::exists(pdflatexPath)) {
         qWarning() << "pdflatex not found at:" << pdflatexPath;
-        progressDialog->close();
         return;
     }
 
-    QFileInfo texFileInfo(outputTexPath);
-    QString workDir = texFileInfo.absolutePath();
-    QString texFileName = texFileInfo.fileName();
-
-    QProcess* latexProcess = new QProcess(this);
-    latexProcess->setWorkingDirectory(workDir);
-    QStringList arguments;
-    arguments << "-interaction=nonstopmode" << texFileName;
-
-    connect(latexProcess, &QProcess::readyReadStandardOutput, this, [=]() {
-        qDebug() << latexProcess->readAllStandardOutput();
-    });
-
-    connect(latexProcess, &QProcess::readyReadStandardError, this, [=]() {
-        qWarning() << latexProcess->readAllStandardError();
-    });
+    // Progress dialog for PDF compilation
+    QProgressDialog* progressDialog = new QProgressDialog("Compiling PDF...", QString(), 0, 0, this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setCancelButton(nullptr);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->show();
 
-    connect(latexProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [=](int exitCode, QProcess::ExitStatus /*status*/) {
+    // Reuses the precompiled preamble and skips passes whose inputs did not change
+    LatexBuilder* latexBuilder = new LatexBuilder(pdflatexPath, this);
+    connect(latexBuilder, &LatexBuilder::stepStarted, progressDialog, &QProgressDialog::setLabelText);
+    connect(latexBuilder, &LatexBuilder::finished, this, [=](bool success, const QString& pdfPath, int /*passes*/) {
         progressDialog->close();
         generateDataSheetButton->setEnabled(true);
 
-        QString pdfPath = outputTexPath;
-        pdfPath.replace(".tex", ".pdf");
-
-        if (exitCode == 0 && QFile::exists(pdfPath)) {
+        if (success) {
             QMessageBox::information(this, "Success", "PDF generated successfully:\n" + pdfPath);
         } else {
             QMessageBox::warning(this, "Failure", "PDF generation failed.");
         }
 
-        latexProcess->deleteLater();
+        latexBuilder->deleteLater();
         progressDialog->deleteLater();
     });
 
-    latexProcess->start(pdflatexPath, arguments);
+    latexBuilder->build(outputTexPath, DataSheetGenerator::preamble());
 }
 
 /**
@@ -396,12 +503,20 @@ void WizardGracePage::generateDataSheet()
  * - CW LIV and Ith plots
  * - CW FTIR at fixed temperature and fixed current
  * 
- * The function creates necessary directories, instantiates data processors and plotters,
- * and updates collectedData with fit parameters from Ith plots.
+ * Parsing and plotting is done by GraceFigureWriter, which also updates collectedData
+ * with the fit parameters from the Ith plots and the emission frequency ranges.
  * 
  * After plots are generated, the .agr files are converted to PDFs asynchronously using FileConverter.
  * Upon conversion completion, the UI is updated to show generated images and enable the data sheet generation button.
  * 
+ * When the QCustomPlot backend is selected, the same figures are instead exported directly by
+ * QtPlotExporter and no external process is started. The .agr files are still written, since
+ * the data sheet reads the fit legends from them.
+ * 
+ * Once the figures exist, the parameters, parsed traces and results are saved as
+ * a <Sample>.qclproj project in the output directory, which "Open project" reopens
+ * without the raw files.
+ * 
  * Emits:
  * - dataProcessed(const QVariantMap &) when Ith plot parameters are updated.
  * 
@@ -415,173 +530,88 @@ void WizardGracePage::generateGraceImages()
         return; // No data, exit early
     }
 
-    // Get dimensions
-    QVariantMap dimensions = collectedData.value("Dimensions").toMap();
-    double w = dimensions.value("width").toDouble();
-    double l = dimensions.value("length").toDouble();
-
     QString graceFiguresDir = outputDir + "/GraceFigures";
-    QDir dir(graceFiguresDir);
 
-    // Create directory if it doesn't exist
-    if (!dir.exists() && !dir.mkpath(graceFiguresDir)) {
-        qWarning() << "Failed to create directory:" << graceFiguresDir;
-        return; // Handle failure appropriately
+    bool useQtPlots = plotBackendSelector->currentData().toInt() == QtPlotBackend;
+
+    // The carousel only needs the low-DPI preview; the native datasheet embeds the print tier
+    FileConverter::OutputProfiles figureProfiles = FileConverter::PdfOutput | FileConverter::PreviewTier;
+    if (dataSheetBackendSelector->currentData().toInt() == NativeDataSheet)
+        figureProfiles |= FileConverter::PrintTier;
+
+    QtPlotExporter qtExporter(outputDir + "/Figures");
+    qtExporter.setOutputProfiles(figureProfiles);
+
+    // Parse the measurements and write the .agr figures; QCustomPlot reuses the parsed data
+    // and also builds interactive views of the L-I-V and spectra figures for the carousel
+    discardInteractivePlots();
+    GraceFigureWriter figureWriter(graceFiguresDir);
+    if (useQtPlots) {
+        connect(&figureWriter, &GraceFigureWriter::livWritten, &figureWriter,
+                [this, &qtExporter](const QString& baseName, LIVDataProcessor *data, double w, double l) {
+            qtExporter.exportLIV(baseName, data, w, l);
+            interactivePlots.insert(baseName, new QtLIVPlot(data, outputDir, w, l));
+        });
+        connect(&figureWriter, &GraceFigureWriter::ithWritten, &figureWriter,
+                [&qtExporter](const QString& baseName, IthDataProcessor *data, double w, double l) {
+            qtExporter.exportIth(baseName, data, w, l);
+        });
+        connect(&figureWriter, &GraceFigureWriter::spectraWritten, &figureWriter,
+                [this, &qtExporter](const QString& baseName, SpectraDataProcessor *data) {
+            qtExporter.exportSpectra(baseName, data);
+            interactivePlots.insert(baseName, new QtSpectraPlotSamePlot(data));
+        });
     }
 
-    // Create instances of the plotters
-    LIVGracePlot livPlot;
-    SpectraGracePlot spectraPlot;
-    IthGracePlot ithPlot;
-
-    // Check for and handle data for "Pulsed LIV"
-    if (collectedData.contains("Pulsed LIV")) {
-        QString field = "Pulsed LIV";
-		LIVDataProcessor *livData = new LIVDataProcessor(field, collectedData[field].toMap(), "temperature", collectedData.value("pulsed_power_scale_liv", 100.0).toDouble());
-        
-        // Generate the LIV plot
-        QString livOutputPath = graceFiguresDir + "/pulsed_liv.agr";
-        livPlot.plot_liv(livOutputPath.toStdString(), livData, w, l);
-
-        // Create IthDataProcessor for Ith vs T plot (based on LIV data)
-        IthDataProcessor *ithData = new IthDataProcessor(livData, 3.0, this);  // Passing LIV data and threshold
-        QString ithOutputPath = graceFiguresDir + "/Ith_vs_T_pulsed_liv.agr";
-        
-		if (ithData->canPlot()) 
-		{
-			ithPlot.plot_Ith_vs_T(ithOutputPath.toStdString(), ithData, w, l);
-
-			double A, B, C0;
-			ithData->getExponentialFitParams(A, B, C0);
-
-			collectedData["pulsed_I_exp_A"] = QString::number(A, 'f', 2);
-			collectedData["pulsed_I_exp_B"] = QString::number(B, 'f', 2);
-			collectedData["pulsed_I_exp_C0"] = QString::number(C0, 'f', 2);
-
-			double scale = 1e5 / (w * l);
-
-			collectedData["pulsed_J_exp_A"] = QString::number(A * scale, 'f', 2);
-			collectedData["pulsed_J_exp_B"] = QString::number(B * scale, 'f', 2);
-			collectedData["pulsed_J_exp_C0"] = QString::number(C0 * scale, 'f', 2);
-
-			// Emit the signal with the updated collectedData
-			emit dataProcessed(collectedData);
-		}
-		else 
-			qDebug() << "Skipping Ith plot: insufficient valid traces";
-    }
+    if (!figureWriter.write(collectedData))
+        return;
 
-	// Pulsed FTIR - fixed temperature
-	if (collectedData.contains("Pulsed FTIR - fixed temperature")) {
-		QString field = "Pulsed FTIR - fixed temperature";
-		SpectraDataProcessor* spectraData = new SpectraDataProcessor(
-			field,
-			collectedData[field].toMap(),
-			"current",
-			collectedData.value("pulsed_fmin_spectra", 0.0).toDouble(),
-			collectedData.value("pulsed_fmax_spectra", 0.0).toDouble()
-		);        
-		QString spectraOutputPath = graceFiguresDir + "/pulsed_ftir_vs_I.agr";
-		spectraPlot.plot_spectra_waterfall(spectraOutputPath.toStdString(), spectraData);
-
-		// Add frequency range string
-		QString freqRange = spectraData->getGlobalFrequencyRangeString();
-		if (!freqRange.isEmpty()) {
-			collectedData["pulsed_ftir_fixed_temp_freq_range"] = freqRange;
-		}
+    // Pass the fit parameters back to the wizard
+    if (figureWriter.hasFitResults())
+        emit dataProcessed(collectedData);
+
+    // Copy the parsed traces now; the project is written once the figures exist
+    QSharedPointer<ProjectWriter> projectWriter(new ProjectWriter(ProjectFile::pathFor(outputDir, collectedData)));
+    for (const QSharedPointer<GraceFigureJob> &job : figureWriter.figureJobs())
+        projectWriter->addJob(*job);
+
+    // Columnar export for analysis notebooks, streamed while the jobs still hold the data
+    AnalyticsExporter analytics(AnalyticsExporter::directoryFor(outputDir));
+    analytics.setParameters(collectedData);
+    for (const QSharedPointer<GraceFigureJob> &job : figureWriter.figureJobs())
+        analytics.addJob(*job);
+    analytics.write();
+
+	// QCustomPlot figures are already written; nothing to convert
+	if (useQtPlots) {
+		saveProject(*projectWriter);
+		loadGeneratedImagesFromFigures();
+		generateDataSheetButton->setEnabled(true);
+		generateDataSheetButton->setStyleSheet("background-color: #007AFF;");
+		return;
 	}
 
-    // Check for and handle data for "Pulsed FTIR - fixed current"
-    if (collectedData.contains("Pulsed FTIR - fixed current")) {
-        QString field = "Pulsed FTIR - fixed current";
-		SpectraDataProcessor* spectraData = new SpectraDataProcessor(
-			field,
-			collectedData[field].toMap(),
-			"temperature",
-			collectedData.value("pulsed_fmin_spectra", 0.0).toDouble(),
-			collectedData.value("pulsed_fmax_spectra", 0.0).toDouble()
-		);        
-        // Generate the Spectra plot
-        QString spectraOutputPath = graceFiguresDir + "/pulsed_ftir_vs_T.agr";
-        spectraPlot.plot_spectra_waterfall(spectraOutputPath.toStdString(), spectraData);
-    }
+	// Convert all generated .agr plots to PDF, one figure per core
+	QProgressDialog* progressDialog = new QProgressDialog("Converting figures...", "Cancel", 0, 0, this);
+	progressDialog->setWindowModality(Qt::WindowModal);
+	progressDialog->setMinimumDuration(0);
+	progressDialog->setAutoClose(false);
+	progressDialog->setAutoReset(false);
 
-    // Check for and handle data for "CW LIV"
-    if (collectedData.contains("CW LIV")) {
-        QString field = "CW LIV";
-        LIVDataProcessor *livData = new LIVDataProcessor(field, collectedData[field].toMap(), "temperature", collectedData.value("pulsed_power_scale_liv", 100.0).toDouble());
-        
-        // Generate the LIV plot
-        QString livOutputPath = graceFiguresDir + "/cw_liv.agr";
-        livPlot.plot_liv(livOutputPath.toStdString(), livData, w, l);
-		 // Create IthDataProcessor for Ith vs T plot (based on LIV data)
-        IthDataProcessor *ithData = new IthDataProcessor(livData, 3.0, this);  // Passing LIV data and threshold
-        QString ithOutputPath = graceFiguresDir + "/Ith_vs_T_cw_liv.agr";
-        
-        // Generate the Ith plot (Ith vs T)
-		if (ithData->canPlot()) 
-		{
-			ithPlot.plot_Ith_vs_T(ithOutputPath.toStdString(), ithData, w, l);
-
-			double A, B, C0;
-			ithData->getExponentialFitParams(A, B, C0);
-
-			collectedData["cw_I_exp_A"] = QString::number(A, 'f', 2);
-			collectedData["cw_I_exp_B"] = QString::number(B, 'f', 2);
-			collectedData["cw_I_exp_C0"] = QString::number(C0, 'f', 2);
-
-			double scale = 1e5 / (w * l);
-
-			collectedData["cw_J_exp_A"] = QString::number(A * scale, 'f', 2);
-			collectedData["cw_J_exp_B"] = QString::number(B * scale, 'f', 2);
-			collectedData["cw_J_exp_C0"] = QString::number(C0 * scale, 'f', 2);
-
-			// Emit the signal with the updated collectedData
-			emit dataProcessed(collectedData);
-		}
-		else 
-			qDebug() << "Skipping Ith plot: insufficient valid traces";
-		}
-
-    // CW FTIR - fixed temperature
-	if (collectedData.contains("CW FTIR - fixed temperature")) {
-		QString field = "CW FTIR - fixed temperature";
-		SpectraDataProcessor* spectraData = new SpectraDataProcessor(
-			field,
-			collectedData[field].toMap(),
-			"current",
-			collectedData.value("cw_fmin_spectra", 0.0).toDouble(),
-			collectedData.value("cw_fmax_spectra", 0.0).toDouble()
-		);        
-		QString spectraOutputPath = graceFiguresDir + "/cw_ftir_vs_I.agr";
-		spectraPlot.plot_spectra_waterfall(spectraOutputPath.toStdString(), spectraData);
-
-		// Add frequency range string
-		QString freqRange = spectraData->getGlobalFrequencyRangeString();
-		if (!freqRange.isEmpty()) {
-			collectedData["cw_ftir_fixed_temp_freq_range"] = freqRange;
-		}
-	}
-
-    // Check for and handle data for "CW FTIR - fixed current"
-    if (collectedData.contains("CW FTIR - fixed current")) {
-        QString field = "CW FTIR - fixed current";
-		SpectraDataProcessor* spectraData = new SpectraDataProcessor(
-			field,
-			collectedData[field].toMap(),
-			"temperature",
-			collectedData.value("cw_fmin_spectra", 0.0).toDouble(),
-			collectedData.value("cw_fmax_spectra", 0.0).toDouble()
-		);        
-        // Generate the Spectra plot
-        QString spectraOutputPath = graceFiguresDir + "/cw_ftir_vs_T.agr";
-        spectraPlot.plot_spectra_waterfall(spectraOutputPath.toStdString(), spectraData);
-    }
-	
-	// Convert all generated .agr plots to PDF
 	FileConverter *converter = new FileConverter(this);
-	connect(converter, &FileConverter::conversionFinished, this, [this]() 
+	converter->setOutputProfiles(figureProfiles);
+	connect(progressDialog, &QProgressDialog::canceled, converter, &FileConverter::cancel);
+	connect(converter, &FileConverter::progressChanged, progressDialog, [progressDialog](int completed, int total)
+	{
+		progressDialog->setMaximum(total);
+		progressDialog->setValue(completed);
+	});
+	connect(converter, &FileConverter::conversionFinished, this, [this, converter, progressDialog, projectWriter]() 
 	{
+		progressDialog->close();
+		progressDialog->deleteLater();
+		converter->deleteLater();
+		saveProject(*projectWriter);
 		loadGeneratedImagesFromFigures();
 		generateDataSheetButton->setEnabled(true);
 		generateDataSheetButton->setStyleSheet("background-color: #007AFF;");
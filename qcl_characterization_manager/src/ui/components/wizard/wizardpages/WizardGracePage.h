@@ -14,12 +14,16 @@
 	#include <QVBoxLayout>
 	#include <QHBoxLayout>
 	#include <QScrollArea>
+	#include <QComboBox>
+	#include <QSharedPointer>
 	#include "ui/components/buttons/ButtonGroup.h"
 	#include "ui/components/imagecaraousel/imagecarousel.h"
 	#include "ui/components/containers/widget.h"
 	#include "ui/components/buttons/PushButton.h"
 	#include "ui/components/wizard/WizardPage.h"
 	#include "core/graceplots/graceplot.h"
+	#include "core/project/ProjectFile.h"
+	#include "core/project/ProjectWriter.h"
 
 	/**
 	 * @class WizardGracePage
@@ -33,8 +37,23 @@
 			explicit WizardGracePage(const QString &title, QWidget *parent = nullptr); ///< Constructor
 			void generateGraceImages();                                               ///< Generate Grace plot images
 			void generateDataSheet();                                                 ///< Generate data sheet file
+			void openProject(const ProjectFile &project);                             ///< Show a saved project from its stored traces and figures
 
 		private:
+			/// Backend that turns the plot data into PDF/PNG figures.
+			enum PlotBackend
+			{
+				GraceBackend,  ///< Grace .agr files converted by qtgrace and Ghostscript
+				QtPlotBackend  ///< QCustomPlot exported in-process by QtPlotExporter
+			};
+
+			/// Backend that typesets the datasheet PDF.
+			enum DataSheetBackend
+			{
+				LatexDataSheet,  ///< DataSheetGenerator + pdflatex
+				NativeDataSheet  ///< NativeDataSheetGenerator (QPdfWriter, no TeX)
+			};
+
 			QVariantMap collectedData;                 ///< Data collected for image and sheet generation
 			QString outputDir;                         ///< Output directory path
 			Widget *nothingToShowWidget;               ///< Widget shown when no images are available
@@ -43,11 +62,17 @@
 			ButtonGroup *imageMenu;                     ///< Button group menu for image selection
 			PushButton *generateDataSheetButton;       ///< Button to trigger data sheet generation
 			PushButton *resetButton;                     ///< Button to reset the view
+			QComboBox *plotBackendSelector;              ///< Selects the figure backend
+			QComboBox *dataSheetBackendSelector;         ///< Selects the datasheet backend
+			QMap<QString, QCustomPlot*> interactivePlots; ///< Views built with the figures, by base name, until the carousel takes them
 
 			void addImage(const QString &imagePath);                  ///< Add image to the carousel
 			void initNothingToShowWidget();                           ///< Initialize "Nothing to show" widget
 			void initGenerateImagesControlWidget();                   ///< Initialize control widget for image generation
 			void loadGeneratedImagesFromFigures();                    ///< Load images from existing figure files
+			QStringList previewImages() const;                        ///< PNG figures the carousel shows
+			void saveProject(ProjectWriter &writer);                  ///< Write the project once the figures exist
+			void discardInteractivePlots();                           ///< Delete views the carousel did not take
 
 		private slots:
 			void resetView();                                          ///< Slot to reset the view
@@ -14,6 +14,7 @@
 #include "WizardMeasurementSetupPage.h"
 #include <QGridLayout>
 #include <QFile>
+#include <QHash>
 #include <QTextStream>
 #include <QLabel>
 #include <QDebug>
@@ -277,13 +278,19 @@ bool WizardMeasurementSetupPage::validatePage()
  * @brief Loads a list of resource strings from a text file.
  * 
  * Reads the specified file line-by-line from the equipment resources directory,
- * trims whitespace, and returns a list of non-empty lines.
+ * trims whitespace, and returns a list of non-empty lines. Each file is read
+ * once; the pulsed and CW pages share the lists.
  * 
  * @param filename Name of the resource file to load.
  * @return QStringList List of items loaded from the file.
  */
 QStringList WizardMeasurementSetupPage::loadResourceList(const QString &filename)
 {
+    static QHash<QString, QStringList> loadedLists;
+    auto loaded = loadedLists.constFind(filename);
+    if (loaded != loadedLists.constEnd())
+        return *loaded;
+
     // Use Qt resource path, matching .qrc entries
     QString resourcePath = ":/src/resources/equipment/" + filename;
     QFile file(resourcePath);
@@ -301,6 +308,7 @@ QStringList WizardMeasurementSetupPage::loadResourceList(const QString &filename
         qWarning() << "Could not open embedded resource file:" << resourcePath;
     }
 
+    loadedLists.insert(filename, items);
     return items;
 }
 
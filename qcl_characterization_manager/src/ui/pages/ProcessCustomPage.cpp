@@ -11,6 +11,7 @@
  */
 #include "ProcessCustomPage.h"
 #include <QStandardPaths>
+#include <QInputDialog>
 #include "ui/dialogs/MessageBox.h"
 #include "ui/components/containers/HeaderPage.h"
 #include "ui/components/wizard/wizardpages/WizardSetupParamsPage.h"
@@ -23,6 +24,8 @@
 #include "core/dataprocessing/IthDataProcessor.h"
 #include "core/fileconversion/FileConverter.h"
 #include "core/datasheetgenerator/DataSheetGenerator.h"
+#include "core/datasheetgenerator/LatexBuilder.h"
+#include "core/datasheetgenerator/BatchDataSheetRunner.h"
 
 /**
  * @brief Constructs the ProcessCustomPage with the specified title and optional parent.
@@ -108,6 +111,7 @@ ProcessCustomPage::ProcessCustomPage(const QString &title, QWidget *parent)
  * - A button to open a directory selection dialog for choosing the data folder.
  * - A button to trigger generation of Grace images, initially disabled and enabled only after
  *   a valid directory is selected.
+ * - A button to build the datasheets of many device directories at once.
  * 
  * The method also connects the buttons to their respective slots:
  * - The directory selection button opens a folder picker dialog and stores the selected path.
@@ -145,6 +149,12 @@ void ProcessCustomPage::initNothingToShowWidget()
     generateGraceImagesButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
     layout->addWidget(generateGraceImagesButton);
 
+    // Batch Data Sheets button
+    PushButton *batchDataSheetsButton = new PushButton("Batch Data Sheets", "outlined");
+    batchDataSheetsButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+    layout->addWidget(batchDataSheetsButton);
+    connect(batchDataSheetsButton, &QPushButton::clicked, this, &ProcessCustomPage::generateBatchDataSheets);
+
     // Connect Select Data Directory button
     connect(selectDataDirButton, &QPushButton::clicked, this, [=]() 
     {
@@ -250,6 +260,11 @@ void ProcessCustomPage::loadGeneratedImagesFromFigures()
         return;
     }
 
+    // Prefer the low-DPI preview tier; folders converted before tiers existed only have full-size PNGs
+    QDir previewDir(FileConverter::tierDirectory(figuresDirPath, FileConverter::PreviewTier));
+    if (!previewDir.entryList(QStringList() << "*.png", QDir::Files).isEmpty())
+        figuresDir = previewDir;
+
 	QStringList pngFiles = figuresDir.entryList(QStringList() << "*.png", QDir::Files);
 	for (const QString &pngFile : pngFiles)
 	{
@@ -263,7 +278,8 @@ void ProcessCustomPage::loadGeneratedImagesFromFigures()
  *
  * Opens a file dialog for the user to select a LaTeX source file.
  * Verifies the presence of the pdflatex executable.
- * Runs pdflatex asynchronously to compile the selected LaTeX file.
+ * Runs pdflatex asynchronously through LatexBuilder, which skips the build when
+ * neither the file nor its figures changed since the last one.
  * Displays a progress dialog during compilation.
  * Shows a message box upon success or failure of the PDF generation.
  */
@@ -278,11 +294,7 @@ void ProcessCustomPage::generateDataSheet()
         return;
     }
 
-    QFileInfo texFileInfo(latexFilePath);
-    QString workDir = texFileInfo.absolutePath();
-    QString texFileName = texFileInfo.fileName();
-
-    QString pdflatexPath = QCoreApplication::applicationDirPath() + "/miktex-portable/texmfs/install/miktex/bin/x64/pdflatex.exe";
+    QString pdflatexPath = LatexBuilder::defaultPdflatexPath();
     if (!QFile::exists(pdflatexPath)) {
         QMessageBox::critical(this, "Error", "pdflatex executable not found:\n" + pdflatexPath);
         return;
@@ -294,36 +306,99 @@ void ProcessCustomPage::generateDataSheet()
     progressDialog->setMinimumDuration(0);
     progressDialog->show();
 
-    QProcess* latexProcess = new QProcess(this);
-    latexProcess->setWorkingDirectory(workDir);
-    QStringList arguments = { "-interaction=nonstopmode", texFileName };
+    // User-supplied .tex: no preamble to precompile, but unchanged inputs still skip pdflatex
+    LatexBuilder* latexBuilder = new LatexBuilder(pdflatexPath, this);
+    connect(latexBuilder, &LatexBuilder::stepStarted, progressDialog, &QProgressDialog::setLabelText);
+    connect(latexBuilder, &LatexBuilder::finished, this, [this, latexBuilder, progressDialog](bool success, const QString& pdfPath, int /*passes*/) {
+        progressDialog->close();
 
-    connect(latexProcess, &QProcess::readyReadStandardOutput, this, [latexProcess]() {
-        qDebug() << latexProcess->readAllStandardOutput();
-    });
+        if (success) {
+            QMessageBox::information(this, "Success", "PDF generated successfully:\n" + pdfPath);
+        } else {
+            QMessageBox::warning(this, "Failure", "PDF generation failed.");
+        }
 
-    connect(latexProcess, &QProcess::readyReadStandardError, this, [latexProcess]() {
-        qWarning() << latexProcess->readAllStandardError();
+        latexBuilder->deleteLater();
+        progressDialog->deleteLater();
     });
 
-    connect(latexProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, latexProcess, latexFilePath, progressDialog](int exitCode, QProcess::ExitStatus) {
+    latexBuilder->build(latexFilePath);
+}
+
+/**
+ * @brief Builds the datasheets of every device below a chosen folder.
+ *
+ * The folder itself and each of its subfolders holding a *_DataMap.txt is
+ * treated as one device output directory whose figures were already
+ * generated. After choosing the backend, BatchDataSheetRunner builds all
+ * datasheets with a bounded number of builds in flight; the LaTeX builds
+ * share one precompiled preamble. A report of failures and timings is
+ * written to BatchDataSheetReport.txt in the chosen folder.
+ */
+void ProcessCustomPage::generateBatchDataSheets()
+{
+    QString rootDir = QFileDialog::getExistingDirectory(this, "Select Folder With Device Directories", QString(),
+                                                        QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (rootDir.isEmpty())
+        return;
+
+    QStringList deviceDirs = BatchDataSheetRunner::findDeviceDirectories(rootDir);
+    if (deviceDirs.isEmpty()) {
+        QMessageBox::warning(this, "No Devices", "No directories with a *_DataMap.txt file found in:\n" + rootDir);
+        return;
+    }
+
+    QStringList backends = { "LaTeX (publication quality)", "Native PDF (fast, no TeX)" };
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "Batch Data Sheets",
+                                           QString("Backend for %1 device(s):").arg(deviceDirs.size()),
+                                           backends, 0, false, &ok);
+    if (!ok)
+        return;
+
+    BatchDataSheetRunner *runner = new BatchDataSheetRunner(this);
+    runner->setBackend(choice == backends[0] ? BatchDataSheetRunner::LatexBackend : BatchDataSheetRunner::NativeBackend);
+    runner->setFormatCacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/latex-formats");
+
+    if (choice == backends[0]) {
+        QString pdflatexPath = LatexBuilder::defaultPdflatexPath();
+        if (!QFile::exists(pdflatexPath)) {
+            QMessageBox::critical(this, "Error", "pdflatex executable not found:\n" + pdflatexPath);
+            runner->deleteLater();
+            return;
+        }
+        runner->setPdflatexPath(pdflatexPath);
+    }
+
+    QProgressDialog* progressDialog = new QProgressDialog("Building data sheets...", QString(), 0, deviceDirs.size(), this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setCancelButton(nullptr);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->setValue(0);
+
+    connect(runner, &BatchDataSheetRunner::deviceFinished, progressDialog,
+            [progressDialog](const QString& deviceDir, bool /*success*/, int completed, int total) {
+        progressDialog->setValue(completed);
+        progressDialog->setLabelText(QString("Built %1 of %2: %3").arg(completed).arg(total).arg(QFileInfo(deviceDir).fileName()));
+    });
+    connect(runner, &BatchDataSheetRunner::finished, this, [this, runner, progressDialog, rootDir](int succeeded, int failed) {
         progressDialog->close();
 
-        QString pdfPath = latexFilePath;
-        pdfPath.replace(".tex", ".pdf");
+        QString reportPath = QDir(rootDir).absoluteFilePath("BatchDataSheetReport.txt");
+        runner->writeReport(reportPath);
 
-        if (exitCode == 0 && QFile::exists(pdfPath)) {
-            QMessageBox::information(this, "Success", "PDF generated successfully:\n" + pdfPath);
+        QString message = QString("%1 data sheet(s) built, %2 failed.\n\nReport: %3").arg(succeeded).arg(failed).arg(reportPath);
+        if (failed > 0) {
+            QMessageBox::warning(this, "Batch Data Sheets", message);
         } else {
-            QMessageBox::warning(this, "Failure", "PDF generation failed.");
+            QMessageBox::information(this, "Batch Data Sheets", message);
         }
 
-        latexProcess->deleteLater();
+        runner->deleteLater();
         progressDialog->deleteLater();
     });
 
-    latexProcess->start(pdflatexPath, arguments);
+    runner->run(deviceDirs);
 }
 
 /**
@@ -332,7 +407,8 @@ void ProcessCustomPage::generateDataSheet()
  * Ensures the "GraceFigures" directory exists under the current output directory, creating it if necessary.
  * Checks for the presence of .agr files in that directory.
  * If no .agr files are found, displays a warning message.
- * Initiates the conversion of .agr files to PostScript and PDF formats using FileConverter.
+ * Initiates the conversion of .agr files to PostScript and PDF formats using FileConverter,
+ * showing per-figure progress in a cancellable progress dialog.
  * After conversion, loads the generated images from the Figures directory.
  */
 void ProcessCustomPage::generateGraceImages()
@@ -353,10 +429,26 @@ void ProcessCustomPage::generateGraceImages()
         return;
     }
 
-    // Start conversion
+    // Start conversion, one figure per core, with per-figure progress and cancel
+    QProgressDialog* progressDialog = new QProgressDialog("Converting figures...", "Cancel", 0, agrFiles.size(), this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+
     FileConverter *converter = new FileConverter(this);
-    connect(converter, &FileConverter::conversionFinished, this, [this]() 
+    converter->setOutputProfiles(FileConverter::PdfOutput | FileConverter::PreviewTier);  // carousel only needs the low-DPI preview
+    connect(progressDialog, &QProgressDialog::canceled, converter, &FileConverter::cancel);
+    connect(converter, &FileConverter::progressChanged, progressDialog, [progressDialog](int completed, int total)
+    {
+        progressDialog->setMaximum(total);
+        progressDialog->setValue(completed);
+    });
+    connect(converter, &FileConverter::conversionFinished, this, [this, converter, progressDialog]() 
     {
+        progressDialog->close();
+        progressDialog->deleteLater();
+        converter->deleteLater();
         loadGeneratedImagesFromFigures();
     });
 
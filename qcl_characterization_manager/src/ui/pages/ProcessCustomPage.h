@@ -37,6 +37,7 @@
 			explicit ProcessCustomPage(const QString &title, QWidget *parent = nullptr); ///< Constructs the custom processing page.
 			void generateGraceImages();  ///< Generates grace plot images from data.
 			void generateDataSheet();    ///< Creates a data sheet from processed results.
+			void generateBatchDataSheets(); ///< Builds the data sheets of many device directories.
 
 		private:
 			QString outputDir;
@@ -16,6 +16,7 @@
 #include <QVBoxLayout>
 #include <QSpacerItem>
 #include <QSizePolicy>
+#include <QFileDialog>
 #include "ui/components/buttons/ButtonGroup.h"
 #include "ui/components/text/Text.h"
 #include "ui/dialogs/HelpDialog.h" 
@@ -55,11 +56,19 @@ WelcomePage::WelcomePage(QWidget *parent)
     PushButton *analyzeButton = new PushButton("Process customised files", "outlined");
     analyzeButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
 
+    PushButton *replayButton = new PushButton("Replay saved run", "outlined");
+    replayButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    PushButton *openProjectButton = new PushButton("Open project", "outlined");
+    openProjectButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
     PushButton *helpButton = new PushButton("Help", "text");
     helpButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
 
     welcomeMenu->addButton(startButton);
     welcomeMenu->addButton(analyzeButton);
+    welcomeMenu->addButton(replayButton);
+    welcomeMenu->addButton(openProjectButton);
     welcomeMenu->addButton(helpButton);
 
     welcomeMenu->layout()->setSpacing(20);
@@ -71,6 +80,20 @@ WelcomePage::WelcomePage(QWidget *parent)
     // Connect buttons to the appropriate signal/slot
     connect(welcomeMenu, &ButtonGroup::buttonClickedId, this, &WelcomePage::buttonClickedIdSlot);
 
+    connect(replayButton, &QPushButton::clicked, this, [this]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "Select DataMap", QString(),
+                                                        "DataMap files (*_DataMap.txt);;Text files (*.txt)");
+        if (!filePath.isEmpty())
+            emit dataMapSelected(filePath);
+    });
+
+    connect(openProjectButton, &QPushButton::clicked, this, [this]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "Open Project", QString(),
+                                                        "QCL projects (*.qclproj)");
+        if (!filePath.isEmpty())
+            emit projectSelected(filePath);
+    });
+
     connect(helpButton, &QPushButton::clicked, this, [this]() {
         HelpDialog *dialog = new HelpDialog(this);
         dialog->exec();
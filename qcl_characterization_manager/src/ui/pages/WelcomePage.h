@@ -29,6 +29,8 @@
 
 		signals:
 			void buttonClickedId(int id); ///< Emitted when a button with a specific ID is clicked.
+			void dataMapSelected(const QString &filePath); ///< Emitted when a saved run is chosen for replay.
+			void projectSelected(const QString &filePath); ///< Emitted when a .qclproj project is chosen.
 
 		public slots:
 			void buttonClickedIdSlot(int id) { emit buttonClickedId(id + 1); } ///< Slot forwarding button clicks with ID offset.
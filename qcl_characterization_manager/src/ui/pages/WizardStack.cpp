@@ -12,12 +12,15 @@
 #include <QMessageBox>
 #include <QFile>
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include <QRegularExpression>
 #include "wizardstack.h"
 #include "ui/dialogs/MessageBox.h"
 #include "ui/components/wizard/WizardPage.h"
 #include "ui/components/wizard/wizardpages/WizardFilePage.h"
+#include "core/pipeline/DataMapFile.h"
+#include "core/project/ProjectFile.h"
 
 /**
  * @brief Constructs the WizardStack, initializing and adding all wizard pages.
@@ -102,6 +105,12 @@ void WizardStack::currentChangedSlot(int id)
     qApp->processEvents();
 
     if (qobject_cast<WizardGracePage *>(wizardPages->widget(id))) {
+        // Data loaded from a DataMap file replaces the (empty) pages
+        if (!replayOutputDir.isEmpty()) {
+            emit sendFields(collectedData, replayOutputDir);
+            return;
+        }
+
         QVariantMap map;
 
         if (setupParamsPage) setupParamsPage->addToMap(map);
@@ -149,9 +158,8 @@ void WizardStack::currentChangedSlot(int id)
  * If a file with the intended name already exists in the output directory, the user is prompted
  * to confirm overwriting it.
  * 
- * The collected data is then asynchronously written to a text file with neatly formatted entries.
- * Special handling is provided for structured data such as dimensions and file path entries,
- * aligning output for readability.
+ * The collected data is then asynchronously written to a text file by DataMapFile,
+ * which can read it back for replaying the run later.
  * 
  * Upon successful file write, a signal is emitted with the collected data and output directory.
  * If file writing fails, an error handler is invoked to display an appropriate message.
@@ -160,6 +168,13 @@ void WizardStack::currentChangedSlot(int id)
  */
 void WizardStack::finishWizardAction()
 {
+    // A replayed run already has its DataMap file
+    if (!replayOutputDir.isEmpty()) {
+        replayOutputDir.clear();
+        collectedData.clear();
+        return;
+    }
+
     QVariantMap map;
 
     // Collect data from all pages as before
@@ -216,75 +231,7 @@ void WizardStack::finishWizardAction()
 
 	QtConcurrent::run([this, filePath, map, outputDir]() 
 	{
-		QFile file(filePath);
-		if (file.open(QIODevice::WriteOnly)) {
-			QTextStream out(&file);
-
-			out << "\n=== Collected Data ===\n";
-
-			// Compute max key length for alignment
-			int maxKeyWidth = 0;
-			for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
-				if (it.key().length() > maxKeyWidth)
-					maxKeyWidth = it.key().length();
-			}
-
-			// Column where paths start for special keys
-			const int pathColumn = maxKeyWidth + 5;
-
-			for (auto it = map.constBegin(); it != map.constEnd(); ++it) 
-			{
-				const QString &key = it.key();
-				const QVariant &value = it.value();
-
-				qDebug() << "KEY:" << key << "TYPE:" << value.typeName() << "VALUE:" << value;
-
-				if (key == "Dimensions") 
-				{
-					QVariantMap dimensions = value.toMap();
-					double w = dimensions.value("width").toDouble();
-					double l = dimensions.value("length").toDouble();
-					double h = dimensions.value("height").toDouble();
-
-					out << QString("%1 = %2\n").arg("Width", maxKeyWidth).arg(w);
-					out << QString("%1 = %2\n").arg("Length", maxKeyWidth).arg(l);
-					out << QString("%1 = %2\n").arg("Height", maxKeyWidth).arg(h);
-
-				} 
-				else if (key == "Pulsed LIV" 
-					  || key == "CW LIV" 
-					  || key == "Pulsed FTIR - fixed temperature" 
-					  || key == "Pulsed FTIR - fixed current"
-					  || key == "CW FTIR - fixed temperature"
-					  || key == "CW FTIR - fixed current") 
-				{
-					// Print key with '=' on its own line
-					out << QString("%1 = \n").arg(key, maxKeyWidth);
-
-					QVariantMap fileMap = value.toMap();
-
-					// Find longest path for neat alignment
-					int maxPathLen = 0;
-					for (auto mit = fileMap.constBegin(); mit != fileMap.constEnd(); ++mit) 
-						maxPathLen = std::max(maxPathLen, int(mit.key().length()));
-					
-
-					// Output each path and value aligned
-					for (auto mit = fileMap.constBegin(); mit != fileMap.constEnd(); ++mit) {
-						QString spacesBeforePath = QString(pathColumn, ' ');
-						// Pad path to maxPathLen to align values
-						QString pathPadded = mit.key().leftJustified(maxPathLen, ' ');
-						out << spacesBeforePath << pathPadded << " " << mit.value().toString() << "\n";
-					}
-				} 
-				else 
-				{
-					out << QString("%1 = %2\n").arg(key, maxKeyWidth).arg(value.toString());
-				}
-			}
-
-			file.close();
-
+		if (DataMapFile::write(filePath, map)) {
 			QMetaObject::invokeMethod(this, "sendFields", Qt::QueuedConnection,
 									  Q_ARG(QVariantMap, map),
 									  Q_ARG(QString, outputDir));
@@ -297,6 +244,71 @@ void WizardStack::finishWizardAction()
 	});
 }
 
+/**
+ * @brief Replays a saved run by loading its <Sample>_DataMap.txt.
+ * 
+ * The collected data is read back with DataMapFile and the Grace page is shown
+ * directly, with the folder of the DataMap file as output directory, so figures
+ * and the datasheet can be regenerated without filling in the wizard again.
+ * The other pages stay empty; finishing the wizard leaves the DataMap file as it is.
+ * 
+ * @param filePath The DataMap file to load.
+ * @return false if the file could not be read.
+ */
+bool WizardStack::loadDataMap(const QString &filePath)
+{
+    QString error;
+    QVariantMap map = DataMapFile::read(filePath, &error);
+    if (map.isEmpty()) {
+        QMessageBox::warning(this, "Error", error);
+        return false;
+    }
+
+    collectedData = map;
+    replayOutputDir = QFileInfo(filePath).absolutePath();
+
+    int graceIndex = wizardPages->indexOf(gracePage);
+    if (wizardPages->currentIndex() == graceIndex)
+        emit sendFields(collectedData, replayOutputDir);
+    else
+        showPage(graceIndex);  // currentChangedSlot sends the data
+    return true;
+}
+
+/**
+ * @brief Reopens a device from its .qclproj project.
+ * 
+ * Like loadDataMap(), but the project also holds the parsed traces, the fit
+ * results and the figures, so the Grace page shows the figures at once and
+ * no measurement file is parsed. The Grace page rebuilds its views and fit
+ * results from the stored columns, and the file is closed again once it is
+ * done.
+ * 
+ * @param filePath The project file to open.
+ * @return false if the file is not a readable project.
+ */
+bool WizardStack::loadProject(const QString &filePath)
+{
+    ProjectFile project(filePath);
+    QString error;
+    if (!project.open(&error)) {
+        QMessageBox::warning(this, "Error", "Cannot open project:\n" + error);
+        return false;
+    }
+
+    collectedData = project.parameters();
+    replayOutputDir = QFileInfo(filePath).absolutePath();
+
+    int graceIndex = wizardPages->indexOf(gracePage);
+    if (wizardPages->currentIndex() == graceIndex)
+        emit sendFields(collectedData, replayOutputDir);
+    else
+        showPage(graceIndex);  // currentChangedSlot sends the data
+
+    gracePage->openProject(project);
+    return true;
+}
+
 /**
  * @brief Shows a warning message box displaying a file-related error.
  * 
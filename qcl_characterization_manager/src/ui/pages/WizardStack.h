@@ -37,6 +37,8 @@
 		public:
 			explicit WizardStack(QWidget *parent = nullptr); ///< Constructs the wizard stack controller.
 			void finishWizardAction() override; ///< Finalizes the wizard process and emits collected data.
+			bool loadDataMap(const QString &filePath); ///< Opens the Grace page with the data of a saved run.
+			bool loadProject(const QString &filePath); ///< Opens the Grace page with a saved .qclproj project.
 
 		signals:
 			void sendFields(const QVariantMap &map, const QString &outputDirectory); ///< Emitted when wizard data is ready.
@@ -54,5 +56,6 @@
 			WizardMeasurementSetupPage *measurementPageCW = nullptr; ///< Measurement page for continuous wave mode.
 			QList<WizardPage *> additionalPages; ///< List of additional wizard pages (e.g., file pages).
 			QVariantMap collectedData; ///< Internal store for collected wizard data.
+			QString replayOutputDir; ///< Output directory of a loaded DataMap, empty when using the wizard pages.
 	};
 #endif // WIZARDSTACK_H
\ No newline at end of file
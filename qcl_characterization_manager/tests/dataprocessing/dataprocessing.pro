@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_filenamepattern
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_filenamepattern.cpp
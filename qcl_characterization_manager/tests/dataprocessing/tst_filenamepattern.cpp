@@ -0,0 +1,63 @@
+/**
+ * \file        tst_filenamepattern.cpp
+ * \brief       Checks the values FileNamePattern reads from measurement file names.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QtTest>
+#include "core/dataprocessing/FileNamePattern.h"
+
+class TestFileNamePattern : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void match_data();
+    void match();
+    void invalidPatterns();
+};
+
+void TestFileNamePattern::match_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("matches");
+    QTest::addColumn<QString>("value");
+
+    QTest::newRow("wildcard before placeholder") << "*{T}K.dat" << "LIV_180K.dat" << true << "180";
+    QTest::newRow("first of several") << "*_{T}K*" << "LIV_80K_100K.dat" << true << "80";
+    QTest::newRow("decimal") << "*{T}K.dat" << "LIV_1.5K.dat" << true << "1.5";
+    QTest::newRow("negative") << "*_{T}K*" << "LIV_-5.5K.dat" << true << "-5.5";
+    QTest::newRow("plus sign dropped") << "FTIR_{I}mA.txt" << "ftir_+250mA.txt" << true << "250";
+    QTest::newRow("folder ignored") << "LIV_{T}K.dat" << "/data/LIV_1K/LIV_20K.dat" << true << "20";
+    QTest::newRow("single character") << "LIV?{T}K.dat" << "LIV-300K.dat" << true << "300";
+    QTest::newRow("no number") << "LIV_{T}K.dat" << "LIV_K.dat" << false << "";
+    QTest::newRow("trailing text") << "LIV_{T}K.dat" << "LIV_20K.dat.bak" << false << "";
+}
+
+void TestFileNamePattern::match()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, fileName);
+    QFETCH(bool, matches);
+    QFETCH(QString, value);
+
+    FileNamePattern compiled(pattern);
+    QVERIFY(compiled.isValid());
+
+    QString read;
+    QCOMPARE(compiled.match(fileName, &read), matches);
+    if (matches)
+        QCOMPARE(read, value);
+}
+
+void TestFileNamePattern::invalidPatterns()
+{
+    QVERIFY(!FileNamePattern("LIV_*.dat").isValid());
+    QVERIFY(!FileNamePattern("LIV_{T}K_{I}mA.dat").isValid());
+    QVERIFY(!FileNamePattern("LIV_{T.dat").isValid());
+    QVERIFY(!FileNamePattern("LIV_*.dat").match("LIV_20.dat", nullptr));
+}
+
+QTEST_GUILESS_MAIN(TestFileNamePattern)
+#include "tst_filenamepattern.moc"
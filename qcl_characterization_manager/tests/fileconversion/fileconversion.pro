@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_fileconverter
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_fileconverter.cpp
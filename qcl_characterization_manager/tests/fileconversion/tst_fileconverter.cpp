@@ -0,0 +1,60 @@
+/**
+ * \file        tst_fileconverter.cpp
+ * \brief       Runs a real Ghostscript render and checks every output tier is written.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "core/fileconversion/FileConverter.h"
+
+class TestFileConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rendersEveryTier();
+};
+
+/**
+ * \brief Converts a one-page PostScript file and checks the PDF and all PNG tiers.
+ *
+ * The raster tiers switch /OutputFile with setpagedevice, which Ghostscript's
+ * SAFER mode only allows for permitted folders.
+ */
+void TestFileConverter::rendersEveryTier()
+{
+    if (!QFile::exists(FileConverter::ghostscriptExecutable()))
+        QSKIP("Ghostscript not found");
+
+    QTemporaryDir baseDir;
+    QVERIFY(baseDir.isValid());
+    QDir base(baseDir.path());
+    QVERIFY(base.mkdir("GraceFigures"));
+
+    QString psFilePath = base.filePath("GraceFigures/figure.ps");
+    QFile psFile(psFilePath);
+    QVERIFY(psFile.open(QIODevice::WriteOnly));
+    psFile.write("%!PS-Adobe-3.0\n"
+                 "%%BoundingBox: 0 0 200 100\n"
+                 "<< /PageSize [200 100] >> setpagedevice\n"
+                 "newpath 10 10 moveto 190 90 lineto stroke\n"
+                 "showpage\n");
+    psFile.close();
+
+    FileConverter converter;
+    converter.setOutputProfiles(FileConverter::PdfOutput | FileConverter::ThumbnailTier
+                                | FileConverter::PreviewTier | FileConverter::PrintTier);
+    converter.convertPsToPdf(psFilePath);
+
+    QString figuresDir = base.filePath("Figures");
+    QVERIFY(QFile::exists(figuresDir + "/figure.pdf"));
+    QVERIFY(QFile::exists(FileConverter::tierDirectory(figuresDir, FileConverter::PrintTier) + "/figure.png"));
+    QVERIFY(QFile::exists(FileConverter::tierDirectory(figuresDir, FileConverter::PreviewTier) + "/figure.png"));
+    QVERIFY(QFile::exists(FileConverter::tierDirectory(figuresDir, FileConverter::ThumbnailTier) + "/figure.png"));
+}
+
+QTEST_GUILESS_MAIN(TestFileConverter)
+#include "tst_fileconverter.moc"
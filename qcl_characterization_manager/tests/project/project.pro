@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_projectfile
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_projectfile.cpp
@@ -0,0 +1,107 @@
+/**
+ * \file        tst_projectfile.cpp
+ * \brief       Checks that ProjectFile reads back the traces ProjectWriter stored, and rejects damaged column tables.
+ * \author      Aleksandar Demic <A.Demic@leeds.ac.uk>
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QScopedPointer>
+#include <QtEndian>
+#include "core/project/ProjectFile.h"
+#include "core/project/ProjectWriter.h"
+#include "core/dataprocessing/LIVDataProcessor.h"
+#include "core/dataprocessing/SpectraDataProcessor.h"
+
+class TestProjectFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void truncatedColumnArea();
+
+private:
+    QString writeProject(const QString& dir) const;
+};
+
+/**
+ * \brief Writes a project with one L-I-V and one spectra dataset.
+ */
+QString TestProjectFile::writeProject(const QString& dir) const
+{
+    LIVDataProcessor liv("Pulsed LIV", "temperature", { "80", "120" },
+                         { { 0.1, 0.2, 0.3 }, { 0.1, 0.2 } },
+                         { { 1.0, 2.0, 3.0 }, { 1.5, 2.5 } },
+                         { { 0.0, 50.0, 100.0 }, { 0.0, 40.0 } },
+                         12.5, 100.0);
+    SpectraDataProcessor spectra("Pulsed FTIR - fixed temperature", "current", { "250" },
+                                 { { 3.40, 3.45, 3.50 } }, { { 0.1, 1.0, 0.2 } },
+                                 { Peak{ 3.45, 1.0, 0.01, 345.0 } }, 3.38, 3.52);
+
+    ProjectWriter writer(dir + "/device.qclproj");
+    writer.setParameters({ { "Sample Name", "device" } });
+    writer.addLIV("Pulsed LIV", &liv);
+    writer.addSpectra("Pulsed FTIR - fixed temperature", &spectra);
+    return writer.write() ? writer.fileName() : QString();
+}
+
+void TestProjectFile::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = writeProject(dir.path());
+    QVERIFY(!path.isEmpty());
+
+    ProjectFile project(path);
+    QVERIFY(project.open());
+    QCOMPARE(project.traceValues("Pulsed LIV"), QStringList({ "80", "120" }));
+
+    ProjectColumn current = project.traceColumn("Pulsed LIV", 1, "x");
+    QVERIFY(!current.isNull());
+    QCOMPARE(current.toVector(), QVector<double>({ 0.1, 0.2 }));
+    QVERIFY(project.traceColumn("Pulsed LIV", 2, "x").isNull());
+    QVERIFY(project.traceColumn("Pulsed LIV", 0, "z").isNull());
+
+    QScopedPointer<LIVDataProcessor> liv(project.livData("Pulsed LIV"));
+    QVERIFY(liv);
+    QCOMPARE(liv->getY2List().at(0), QVector<double>({ 0.0, 50.0, 100.0 }));
+    QCOMPARE(liv->getMaxY1(), 3.0);
+    QCOMPARE(liv->getPreNormMaxY2(), 12.5);
+    QVERIFY(!project.spectraData("Pulsed LIV"));
+
+    QScopedPointer<SpectraDataProcessor> spectra(project.spectraData("Pulsed FTIR - fixed temperature"));
+    QVERIFY(spectra);
+    QCOMPARE(int(spectra->getCenterModeData().size()), 1);
+    QCOMPARE(spectra->getCenterModeData().at(0).frequency, 3.45);
+    QCOMPARE(spectra->getXmin(), 3.38);
+    QCOMPARE(spectra->getGlobalFrequencyRangeString(), QString("3.450 THz"));
+}
+
+void TestProjectFile::truncatedColumnArea()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = writeProject(dir.path());
+    QVERIFY(!path.isEmpty());
+
+    // Shrink the column area in the header: the metadata still parses, but
+    // every column now points past the area and must be refused
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    uchar size[8];
+    qToLittleEndian<quint64>(8, size);
+    QVERIFY(file.seek(24));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(size), 8), qint64(8));
+    file.close();
+
+    ProjectFile project(path);
+    QVERIFY(project.open());
+    QVERIFY(project.traceColumn("Pulsed LIV", 0, "x").isNull());
+    QVERIFY(project.resultColumn("Pulsed FTIR - fixed temperature", "frequency").isNull());
+    QVERIFY(!project.livData("Pulsed LIV"));
+    QVERIFY(!project.spectraData("Pulsed FTIR - fixed temperature"));
+}
+
+QTEST_GUILESS_MAIN(TestProjectFile)
+#include "tst_projectfile.moc"
@@ -0,0 +1,18 @@
+# Shared settings of the test programs: QtTest, linked against qcl_core
+lessThan(QT_MAJOR_VERSION, 6): error("Qt 6 is required (found Qt $$QT_VERSION)")
+
+CONFIG += testcase console c++17
+CONFIG -= app_bundle
+
+QT = core concurrent testlib
+
+INCLUDEPATH += \
+    $$PWD/../src
+
+CORE_OUT = $$OUT_PWD/../../src/core
+win32:CONFIG(debug, debug|release): CORE_OUT = $$CORE_OUT/debug
+else:win32: CORE_OUT = $$CORE_OUT/release
+
+LIBS += -L$$CORE_OUT -lqcl_core
+win32-msvc*: PRE_TARGETDEPS += $$CORE_OUT/qcl_core.lib
+else: PRE_TARGETDEPS += $$CORE_OUT/libqcl_core.a
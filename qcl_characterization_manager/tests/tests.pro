@@ -0,0 +1,8 @@
+# Unit tests of the GUI-free core:
+#   qmake qcl.pro && make && make check
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    dataprocessing \
+    fileconversion \
+    project